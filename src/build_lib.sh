@@ -0,0 +1,11 @@
+#Author: Jack Robbins
+#Builds libnpuzzle, the library that holds the state, fringe, closed, duplicate detection and heuristic code shared by
+#every solver. Both a static(lib/libnpuzzle.a) and a shared(lib/libnpuzzle.so) version are made, for programs outside
+#of src. The solvers themselves are built by the Makefile, which links its own copy of the library into each build
+
+#!/bin/bash
+
+#Always build relative to src, no matter where we were called from
+cd "$(dirname "$0")"
+
+make library
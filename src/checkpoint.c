@@ -0,0 +1,286 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in checkpoint.h. A hard instance can keep solve busy for hours,
+ * and everything it has learned lives in its node store, so a restart used to throw all of it away. Now the whole
+ * search, every node with its packed tiles, g, h, parent and flags, and the open list, can be saved to a file and picked
+ * up again later exactly where it was. Saving is done by a forked child, which gets a frozen copy of the search for the
+ * price of copying the page tables, so the search only stops for as long as the fork takes
+ */
+
+//Link to checkpoint.h
+#include "checkpoint.h"
+#include "search_control.h"
+#include "table_memory.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+/**
+ * Write all of a buffer, however many calls it takes. Returns 0 on success, or -1 on failure
+ */
+static int write_all(int file, const void* data, size_t size){
+	const unsigned char* cursor = (const unsigned char*)data;
+
+	while(size > 0){
+		ssize_t written = write(file, cursor, size);
+		if(written < 0 && errno == EINTR){
+			continue;
+		}
+		if(written <= 0){
+			return -1;
+		}
+		cursor += written;
+		size -= written;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Read all of a buffer, however many calls it takes. Returns 0 on success, or -1 on failure or if the file ends first
+ */
+static int read_all(int file, void* data, size_t size){
+	unsigned char* cursor = (unsigned char*)data;
+
+	while(size > 0){
+		ssize_t got = read(file, cursor, size);
+		if(got < 0 && errno == EINTR){
+			continue;
+		}
+		if(got <= 0){
+			return -1;
+		}
+		cursor += got;
+		size -= got;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Write the header and the node store to a file. Only uses write, since it runs in a child of a threaded process
+ */
+static int write_search(int file, struct checkpoint_header* header, struct node_store* store){
+	size_t count = store->count;
+
+	return write_all(file, header, sizeof(struct checkpoint_header))
+		   || write_all(file, &store->count, sizeof(unsigned int))
+		   || write_all(file, &store->open_count, sizeof(unsigned int))
+		   || write_all(file, store->tiles, count * store->packed_size)
+		   || write_all(file, store->g, count * sizeof(unsigned short))
+		   || write_all(file, store->h, count * sizeof(unsigned char))
+		   || write_all(file, store->parent, count * sizeof(unsigned int))
+		   || write_all(file, store->flags, count * sizeof(unsigned char))
+		   || write_all(file, store->open, store->open_count * sizeof(struct open_entry)) ? -1 : 0;
+}
+
+
+/**
+ * Write a whole checkpoint to a temporary file next to path, and only once it's safely on disk, rename it over path.
+ * Returns 0 on success, or -1 on failure, in which case the checkpoint that was there before is untouched
+ */
+static int write_checkpoint_file(const char* path, struct checkpoint_header* header, struct node_store* store){
+	char temporary[4096];
+	if(snprintf(temporary, sizeof(temporary), "%s.tmp", path) >= (int)sizeof(temporary)){
+		return -1;
+	}
+
+	int file = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(file < 0){
+		return -1;
+	}
+
+	int failed = write_search(file, header, store) != 0 || fsync(file) != 0;
+	failed |= close(file) != 0;
+
+	if(failed || rename(temporary, path) != 0){
+		unlink(temporary);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Find out how the child writing the current checkpoint did, waiting for it if block is set
+ */
+static void reap_writer(struct checkpointer* checkpointer, int block){
+	int status;
+
+	if(checkpointer->writer == 0 || waitpid(checkpointer->writer, &status, block ? 0 : WNOHANG) != checkpointer->writer){
+		return;
+	}
+
+	if(WIFEXITED(status) && WEXITSTATUS(status) == 0){
+		checkpointer->written++;
+	} else {
+		checkpointer->failed++;
+	}
+	checkpointer->writer = 0;
+}
+
+
+/**
+ * Set up checkpointing as the options say. The first checkpoint is due one interval from now
+ */
+void start_checkpointer(struct checkpointer* checkpointer, const struct solver_options* options){
+	checkpointer->path = options->checkpoint;
+	checkpointer->interval = options->checkpoint_interval;
+	clock_gettime(CLOCK_MONOTONIC, &checkpointer->last);
+	checkpointer->unchecked = 0;
+	checkpointer->writer = 0;
+	checkpointer->written = 0;
+	checkpointer->failed = 0;
+	checkpointer->longest_pause = 0;
+}
+
+
+/**
+ * Called after every expansion. Returns 1 if it's time for a checkpoint, which is only once the interval has gone by and
+ * the last checkpoint is done being written. Like search_should_stop, it only looks at the clock every
+ * SEARCH_CHECK_INTERVAL calls
+ */
+int checkpoint_due(struct checkpointer* checkpointer){
+	if(checkpointer->path == NULL || ++checkpointer->unchecked < SEARCH_CHECK_INTERVAL){
+		return 0;
+	}
+	checkpointer->unchecked = 0;
+
+	reap_writer(checkpointer, 0);
+	if(checkpointer->writer != 0){
+		return 0;
+	}
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - checkpointer->last.tv_sec) * 1000 + (now.tv_nsec - checkpointer->last.tv_nsec) / 1000000 >= checkpointer->interval;
+}
+
+
+/**
+ * Start writing a checkpoint of the search in a forked child, and go right back to searching. The child's copy of the
+ * search is frozen at the fork, so the search can keep changing its own while the child writes
+ */
+void write_checkpoint_async(struct checkpointer* checkpointer, struct checkpoint_header* header, struct node_store* store){
+	struct timespec before, after;
+	clock_gettime(CLOCK_MONOTONIC, &before);
+
+	pid_t writer = fork();
+	if(writer == 0){
+		//Leave without flushing anything of the parent's, and without running its exit handlers
+		_exit(write_checkpoint_file(checkpointer->path, header, store) == 0 ? 0 : 1);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &after);
+	double pause = (after.tv_sec - before.tv_sec) * 1000.0 + (after.tv_nsec - before.tv_nsec) / 1e6;
+	if(pause > checkpointer->longest_pause){
+		checkpointer->longest_pause = pause;
+	}
+
+	//Without a child, as when there isn't memory to fork, this checkpoint is skipped and the next one is tried as usual
+	if(writer < 0){
+		checkpointer->failed++;
+	} else {
+		checkpointer->writer = writer;
+	}
+	checkpointer->last = after;
+}
+
+
+/**
+ * Write a checkpoint of the search right away, waiting until it's on disk, for a search that is about to stop. Returns 0
+ * on success, or -1 on failure
+ */
+int write_checkpoint(struct checkpointer* checkpointer, struct checkpoint_header* header, struct node_store* store){
+	//A checkpoint still being written is older, so it has to land first
+	finish_checkpoints(checkpointer);
+
+	if(write_checkpoint_file(checkpointer->path, header, store) != 0){
+		checkpointer->failed++;
+		return -1;
+	}
+
+	checkpointer->written++;
+	return 0;
+}
+
+
+/**
+ * Wait for the checkpoint being written, if there is one
+ */
+void finish_checkpoints(struct checkpointer* checkpointer){
+	reap_writer(checkpointer, 1);
+}
+
+
+/**
+ * Print out how checkpointing went. Prints nothing if it was turned off
+ */
+void print_checkpoint_stats(struct checkpointer* checkpointer){
+	if(checkpointer->path == NULL){
+		return;
+	}
+
+	printf("Checkpoints: %ld written to %s, %ld failed, the search stopped for at most %.3f ms to start one\n",
+		   checkpointer->written, checkpointer->path, checkpointer->failed, checkpointer->longest_pause);
+}
+
+
+/**
+ * Read a checkpoint back in. Returns the node store, with the header filled in, or NULL if the file can't be read or
+ * isn't a checkpoint, in which case an error has already been printed
+ */
+struct node_store* read_checkpoint(const char* path, struct checkpoint_header* header){
+	int file = open(path, O_RDONLY);
+	if(file < 0){
+		printf("ERROR. Checkpoint %s not found.\n", path);
+		return NULL;
+	}
+
+	unsigned int count, open_count;
+	if(read_all(file, header, sizeof(struct checkpoint_header)) != 0 || memcmp(header->magic, CHECKPOINT_MAGIC, 8) != 0
+	   || header->N < 2 || read_all(file, &count, sizeof(unsigned int)) != 0 || read_all(file, &open_count, sizeof(unsigned int)) != 0){
+		printf("ERROR. %s is not a checkpoint.\n", path);
+		close(file);
+		return NULL;
+	}
+
+	//Start the store out big enough for every node, so nothing has to grow while reading
+	int bits = DEFAULT_NODE_STORE_BITS;
+	while(bits < 31 && (1u << bits) < count){
+		bits++;
+	}
+	struct node_store* store = create_node_store(bits, header->N);
+	while(store->open_capacity < open_count){
+		store->open = (struct open_entry*)resize_table(store->open, sizeof(struct open_entry) * store->open_capacity,
+													  sizeof(struct open_entry) * store->open_capacity * 2);
+		store->open_capacity *= 2;
+	}
+
+	size_t nodes = count;
+	if(read_all(file, store->tiles, nodes * store->packed_size) != 0
+	   || read_all(file, store->g, nodes * sizeof(unsigned short)) != 0
+	   || read_all(file, store->h, nodes * sizeof(unsigned char)) != 0
+	   || read_all(file, store->parent, nodes * sizeof(unsigned int)) != 0
+	   || read_all(file, store->flags, nodes * sizeof(unsigned char)) != 0
+	   || read_all(file, store->open, open_count * sizeof(struct open_entry)) != 0){
+		printf("ERROR. Checkpoint %s is cut short.\n", path);
+		destroy_node_store(store);
+		close(file);
+		return NULL;
+	}
+	close(file);
+
+	store->count = count;
+	store->open_count = open_count;
+	rebuild_node_store_index(store);
+
+	return store;
+}
@@ -0,0 +1,77 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the checkpoint file format that solve saves its search in, the checkpointer that writes
+ * it from a forked snapshot of the solver, and the function prototypes that are implemented in checkpoint.c
+ */
+
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/types.h>
+#include "options.h"
+#include "node_store.h"
+
+
+//How often a checkpoint is written if the user doesn't say, in milliseconds
+#define DEFAULT_CHECKPOINT_INTERVAL 300000
+//Every checkpoint file starts with this
+#define CHECKPOINT_MAGIC "NPCHECK3"
+
+
+/**
+ * The start of a checkpoint file. The node store follows it: the node count and the open list's size, then every node's
+ * packed tiles, g, h, parent and flags, one array at a time, and then the open list itself
+ */
+struct checkpoint_header {
+	//Always CHECKPOINT_MAGIC
+	char magic[8];
+	//The search that was saved, which the search that resumes it has to be the same as
+	int N;
+	char heuristic[64];
+	double weight;
+	int perimeter;
+	//Where the search was. These are up to the solver, the checkpoint only keeps them
+	long expanded, generated, batches, layer_expansions;
+	int layer_cost;
+	unsigned int closest_node;
+	struct open_entry pending_goal;
+	unsigned int incumbent_node;
+	int incumbent_cost;
+};
+
+
+/**
+ * Writes the whole search to a file every interval, without stopping it for longer than a fork takes. The child that
+ * fork makes sees the search frozen as it was, writes it out to a temporary file and renames it over the checkpoint, so
+ * the file is always a whole checkpoint, even if the solver is killed in the middle of writing
+ */
+struct checkpointer {
+	//Where the checkpoint goes, NULL if checkpointing is turned off
+	const char* path;
+	//How many milliseconds go by between checkpoints, and when the last one was started
+	long interval;
+	struct timespec last;
+	//Calls since the clock was last looked at
+	int unchecked;
+	//The child writing the current checkpoint, 0 if none
+	pid_t writer;
+	//How many checkpoints were written and failed, and the longest that the search was stopped to start one
+	long written, failed;
+	double longest_pause;
+};
+
+
+/* Method Protoypes */
+void start_checkpointer(struct checkpointer*, const struct solver_options*);
+int checkpoint_due(struct checkpointer*);
+void write_checkpoint_async(struct checkpointer*, struct checkpoint_header*, struct node_store*);
+int write_checkpoint(struct checkpointer*, struct checkpoint_header*, struct node_store*);
+void finish_checkpoints(struct checkpointer*);
+void print_checkpoint_stats(struct checkpointer*);
+struct node_store* read_checkpoint(const char*, struct checkpoint_header*);
+
+#endif /* CHECKPOINT_H */
@@ -0,0 +1,282 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in concurrent_set.h. The concurrent set is an open addressing
+ * hash set of packed states that any number of threads can insert into and query at the same time. Every slot is
+ * claimed with a single compare and swap, so no thread ever holds a lock, and inserting tells the caller atomically
+ * whether the state is new or was already there
+ */
+
+//Link to concurrent_set.h
+#include "concurrent_set.h"
+//For yielding while waiting on a migration
+#include <sched.h>
+#include "table_memory.h"
+
+
+//A slot's tag is being written, the state in it isn't ready to be read yet
+#define PENDING_BIT (1ULL << 63)
+//A slot has been copied to the next table, and can't be claimed anymore
+#define MOVED_BIT (1ULL << 62)
+#define FLAG_BITS (PENDING_BIT | MOVED_BIT)
+//How many slots a thread copies at a time during a migration
+#define MIGRATION_CHUNK 4096
+//What probing a table can find out about a state
+#define SET_PRESENT 0
+#define SET_NEW 1
+#define SET_MOVED 2
+
+
+/**
+ * Turn a state's key into a slot tag. The flag bits are cleared, and 0 is kept free to mean an empty slot
+ */
+static unsigned long long make_tag(unsigned long long key){
+	unsigned long long tag = key & ~FLAG_BITS;
+
+	return tag == 0 ? 1 : tag;
+}
+
+
+/**
+ * Create an empty table with the given number of slots, which must be a power of 2
+ */
+static struct set_table* create_table(unsigned long long slots, int packed_size, struct set_table* previous){
+	struct set_table* table = (struct set_table*)malloc(sizeof(struct set_table));
+
+	//Every tag starts out empty(0)
+	table->tags = (_Atomic unsigned long long*)allocate_table(slots * sizeof(unsigned long long));
+	table->states = (unsigned char*)allocate_table(slots * packed_size);
+	table->mask = slots - 1;
+	atomic_init(&table->count, 0);
+	atomic_init(&table->next, NULL);
+	atomic_init(&table->claimed_chunks, 0);
+	atomic_init(&table->finished_chunks, 0);
+	table->num_chunks = (slots + MIGRATION_CHUNK - 1) / MIGRATION_CHUNK;
+	table->previous = previous;
+
+	return table;
+}
+
+
+/**
+ * Free a single table
+ */
+static void destroy_table(struct set_table* table, int packed_size){
+	free_table((void*)table->tags, (table->mask + 1) * sizeof(unsigned long long));
+	free_table(table->states, (table->mask + 1) * packed_size);
+	free(table);
+}
+
+
+/**
+ * Look for a packed state in one table with linear probing. If claim is set and the state isn't there, it is inserted
+ * into the first empty slot. Returns SET_PRESENT if the state was there, SET_NEW if it wasn't, or SET_MOVED if the table
+ * is being migrated and the caller has to look in the next one
+ */
+static int probe_table(struct set_table* table, unsigned long long tag, const unsigned char* packed, int packed_size, int claim){
+	unsigned long long slot = tag & table->mask;
+
+	for(unsigned long long probes = 0; probes <= table->mask; probes++, slot = (slot + 1) & table->mask){
+		unsigned long long current = atomic_load_explicit(&table->tags[slot], memory_order_acquire);
+
+		//The end of the probe sequence, so the state isn't here
+		if(current == 0){
+			if(!claim){
+				return SET_NEW;
+			}
+
+			//Claim the slot, write the state, and only then publish the tag. If another thread claimed the slot first,
+			//current now holds its tag and we look at that instead
+			if(atomic_compare_exchange_strong_explicit(&table->tags[slot], &current, tag | PENDING_BIT, memory_order_acq_rel,
+													   memory_order_acquire)){
+				memcpy(table->states + slot * packed_size, packed, packed_size);
+				atomic_store_explicit(&table->tags[slot], tag, memory_order_release);
+				atomic_fetch_add_explicit(&table->count, 1, memory_order_relaxed);
+				return SET_NEW;
+			}
+		}
+
+		//A different state. If the slot was moved, the rest of the table can't be trusted to be up to date
+		if((current & ~FLAG_BITS) != tag){
+			if(current & MOVED_BIT){
+				return SET_MOVED;
+			}
+			continue;
+		}
+
+		//The same key, so wait for the state to be written before comparing the whole thing
+		while(current & PENDING_BIT){
+			current = atomic_load_explicit(&table->tags[slot], memory_order_acquire);
+		}
+
+		if(memcmp(table->states + slot * packed_size, packed, packed_size) == 0){
+			return SET_PRESENT;
+		}
+
+		if(current & MOVED_BIT){
+			return SET_MOVED;
+		}
+	}
+
+	//Every slot is taken, so the table has to grow before anything else can go in
+	return SET_MOVED;
+}
+
+
+/**
+ * Help copy a table into its next table. Chunks of slots are handed out one at a time, every slot in a chunk is
+ * frozen with MOVED_BIT so that nothing else can be put there, and whatever state it held is inserted into the next
+ * table. Once every chunk is done the set moves on to the next table. Nobody inserts into the next table until then,
+ * so a state that made it into this table is always copied before anyone could insert it again
+ */
+static void help_migrate(struct concurrent_set* set, struct set_table* table){
+	struct set_table* next = atomic_load_explicit(&table->next, memory_order_acquire);
+	long chunk;
+
+	while((chunk = atomic_fetch_add_explicit(&table->claimed_chunks, 1, memory_order_relaxed)) < table->num_chunks){
+		unsigned long long end = (chunk + 1) * MIGRATION_CHUNK;
+		if(end > table->mask + 1){
+			end = table->mask + 1;
+		}
+
+		for(unsigned long long slot = chunk * MIGRATION_CHUNK; slot < end; slot++){
+			unsigned long long current = atomic_load_explicit(&table->tags[slot], memory_order_acquire);
+
+			//Freeze the slot, waiting for any state that is still being written
+			while((current & PENDING_BIT) || !atomic_compare_exchange_weak_explicit(&table->tags[slot], &current,
+				  current | MOVED_BIT, memory_order_acq_rel, memory_order_acquire)){
+				if(current & PENDING_BIT){
+					current = atomic_load_explicit(&table->tags[slot], memory_order_acquire);
+				}
+			}
+
+			//Empty slots have nothing to copy
+			if(current != 0){
+				probe_table(next, current, table->states + slot * set->packed_size, set->packed_size, 1);
+			}
+		}
+
+		atomic_fetch_add_explicit(&table->finished_chunks, 1, memory_order_release);
+	}
+
+	//Wait for the other threads' chunks
+	while(atomic_load_explicit(&table->finished_chunks, memory_order_acquire) < table->num_chunks){
+		sched_yield();
+	}
+
+	//Only one thread needs to switch the set over, the rest will fail harmlessly
+	struct set_table* expected = table;
+	atomic_compare_exchange_strong(&set->current, &expected, next);
+}
+
+
+/**
+ * Start migrating a table into one twice its size, unless another thread already has, and help with the copy
+ */
+static void start_migration(struct concurrent_set* set, struct set_table* table){
+	if(atomic_load_explicit(&table->next, memory_order_acquire) == NULL){
+		struct set_table* next = create_table((table->mask + 1) * 2, set->packed_size, table);
+		struct set_table* expected = NULL;
+
+		//Another thread beat us to it, so use theirs
+		if(!atomic_compare_exchange_strong(&table->next, &expected, next)){
+			destroy_table(next, set->packed_size);
+		}
+	}
+
+	help_migrate(set, table);
+}
+
+
+/**
+ * Create an empty set with 2^set_bits slots to start with for NxN puzzles
+ */
+struct concurrent_set* create_concurrent_set(int set_bits, const int N){
+	struct concurrent_set* set = (struct concurrent_set*)malloc(sizeof(struct concurrent_set));
+
+	set->N = N;
+	set->packed_size = packed_state_size(N);
+	atomic_init(&set->current, create_table(1ULL << set_bits, set->packed_size, NULL));
+
+	return set;
+}
+
+
+/**
+ * Free all of the memory used by the set. No other thread may be using it
+ */
+void destroy_concurrent_set(struct concurrent_set* set){
+	struct set_table* table = atomic_load(&set->current);
+
+	//Every table that was ever current is still around, since readers might have been in it
+	while(table != NULL){
+		struct set_table* previous = table->previous;
+		destroy_table(table, set->packed_size);
+		table = previous;
+	}
+
+	free(set);
+}
+
+
+/**
+ * Insert a state into the set. Returns 1 if the state is new, or 0 if it was already there. When several threads insert
+ * the same state at once, exactly one of them gets 1
+ */
+int concurrent_set_insert(struct concurrent_set* set, struct state* statePtr){
+	unsigned char packed[set->packed_size];
+	pack_state(statePtr, packed, set->N);
+	unsigned long long tag = make_tag(hash_state(statePtr, set->N));
+
+	while(1){
+		struct set_table* table = atomic_load_explicit(&set->current, memory_order_acquire);
+
+		//Never insert into a table that is being migrated, help finish the migration instead
+		if(atomic_load_explicit(&table->next, memory_order_acquire) != NULL){
+			help_migrate(set, table);
+			continue;
+		}
+
+		int result = probe_table(table, tag, packed, set->packed_size, 1);
+
+		if(result == SET_MOVED){
+			start_migration(set, table);
+			continue;
+		}
+
+		//Grow once the table is half full, to keep the probe sequences short
+		if(result == SET_NEW && atomic_load_explicit(&table->count, memory_order_relaxed) * 2 > (long)(table->mask + 1)){
+			start_migration(set, table);
+		}
+
+		return result == SET_NEW;
+	}
+}
+
+
+/**
+ * Whether a state is in the set, without inserting it
+ */
+int concurrent_set_contains(struct concurrent_set* set, struct state* statePtr){
+	unsigned char packed[set->packed_size];
+	pack_state(statePtr, packed, set->N);
+	unsigned long long tag = make_tag(hash_state(statePtr, set->N));
+
+	while(1){
+		struct set_table* table = atomic_load_explicit(&set->current, memory_order_acquire);
+		int result = probe_table(table, tag, packed, set->packed_size, 0);
+
+		if(result != SET_MOVED){
+			return result == SET_PRESENT;
+		}
+
+		start_migration(set, table);
+	}
+}
+
+
+/**
+ * How many states are in the set. While a migration is going on, this may lag behind
+ */
+long concurrent_set_size(struct concurrent_set* set){
+	return atomic_load(&atomic_load(&set->current)->count);
+}
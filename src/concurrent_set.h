@@ -0,0 +1,64 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the concurrent state set structures and function prototypes that are implemented
+ * in concurrent_set.c
+ */
+
+
+#ifndef CONCURRENT_SET_H
+#define CONCURRENT_SET_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "puzzle.h"
+
+
+//The default set starts out with 2^16 slots, and doubles whenever it is half full
+#define DEFAULT_SET_BITS 16
+
+
+/**
+ * One generation of the set's slots. When a table fills up, a table twice its size is hung off of next, and every
+ * thread that touches the set helps copy the slots over before the set moves on to the new table
+ */
+struct set_table {
+	//One tag per slot, holding the upper bits of the state's key and whether the slot is being written or was moved
+	_Atomic unsigned long long* tags;
+	//The packed state in each slot, packed_state_size(N) bytes apiece
+	unsigned char* states;
+	//Number of slots - 1, the number of slots is always a power of 2
+	unsigned long long mask;
+	//How many states are in this table
+	atomic_long count;
+	//The table that this one is being migrated to, NULL if it isn't
+	struct set_table* _Atomic next;
+	//Migration hands out chunks of slots, and is done once every chunk is finished
+	atomic_long claimed_chunks, finished_chunks;
+	long num_chunks;
+	//The table that this one replaced. Threads may still be reading it, so it's only freed with the set
+	struct set_table* previous;
+};
+
+
+/**
+ * A set of states that any number of threads can insert into and query at once, without locks. States are stored
+ * packed, see pack_state, and found by their Zobrist key with linear probing
+ */
+struct concurrent_set {
+	//The table that new inserts go into
+	struct set_table* _Atomic current;
+	//The size of the puzzle, and of a packed state
+	int N;
+	int packed_size;
+};
+
+
+/* Method Protoypes */
+struct concurrent_set* create_concurrent_set(int, const int);
+void destroy_concurrent_set(struct concurrent_set*);
+int concurrent_set_insert(struct concurrent_set*, struct state*);
+int concurrent_set_contains(struct concurrent_set*, struct state*);
+long concurrent_set_size(struct concurrent_set*);
+
+#endif /* CONCURRENT_SET_H */
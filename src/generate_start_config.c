@@ -50,6 +50,8 @@ int main(int argc, char** argv) {
 	//Initialize the zero_row and zero_column position for use later
 	statePtr->zero_row = N-1;
 	statePtr->zero_column = N-1;
+	//Every move keeps the key up to date, so it only has to be computed once
+	statePtr->zobrist_key = compute_zobrist_key(statePtr->tiles, N);
 
 	//Set the seed for our random number generation
 	srand(time(NULL));
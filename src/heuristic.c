@@ -0,0 +1,565 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in heuristic.h, along with every built in evaluator.
+ *
+ * A heuristic specification names evaluators and combines them. "a+b" adds the two evaluators together, which
+ * is only admissable if they count disjoint moves, and "a,b" takes the maximum of the two, which is always
+ * admissable if both are. + binds tighter than , so "pdb,md+lc" is max(pdb, md + lc). Every built in evaluator
+ * counts the moves of every tile(the pattern database already adds its own disjoint halves), so no two of them are
+ * disjoint, and a specification with a + can overestimate. Solvers still take one, but only as a guide: they don't
+ * call what it finds optimal, and the solvers that only find optimal solutions refuse it
+ */
+
+//Link to heuristic.h
+#include "heuristic.h"
+#include "walking_distance.h"
+#include "heuristic_kernels.h"
+#include "pattern_database.h"
+#include "table_memory.h"
+
+
+//A specification can have up to this many max() groups, each with up to this many added terms
+#define MAX_GROUPS 8
+#define MAX_TERMS 8
+
+
+/*================================= Built in evaluators ======================================== */
+
+/**
+ * Manhattan distance only, against the standard goal, using the vectorized kernel
+ */
+static int manhattan_evaluate(struct state* statePtr, const int N){
+	return manhattan_kernel(statePtr->tiles, N);
+}
+
+
+/**
+ * Manhattan distance only, against any target
+ */
+static int manhattan_evaluate_target(struct state* statePtr, const short* target_positions, const int N){
+	int manhattan_distance = 0;
+	short selected_num;
+
+	for(int i = 0; i < N * N; i++){
+		selected_num = statePtr->tiles[i];
+
+		//0 is free to move, so it doesn't count
+		if(selected_num == 0){
+			continue;
+		}
+
+		manhattan_distance += abs(i / N - target_positions[selected_num] / N) + abs(i % N - target_positions[selected_num] % N);
+	}
+
+	return manhattan_distance;
+}
+
+
+/**
+ * Manhattan distance plus generalized linear conflict. update_prediction_function fills in heuristic_cost for us
+ */
+static int linear_conflict_evaluate(struct state* statePtr, const int N){
+	update_prediction_function(statePtr, N);
+	return statePtr->heuristic_cost;
+}
+
+
+/**
+ * Build the walking distance table
+ */
+static int walking_distance_init(const struct solver_options* options, const int N){
+	//Walking distance needs nothing from the options
+	(void)options;
+
+	if(initialize_walking_distance(N) != 0){
+		printf("ERROR. Walking distance only supports puzzles from 2x2 up to %dx%d.\n\n", WALKING_DISTANCE_MAX_N, WALKING_DISTANCE_MAX_N);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Walking distance from scratch, which also stores the state's codes for its successors
+ */
+static int walking_distance_evaluate(struct state* statePtr, const int N){
+	walking_distance_codes(statePtr, N);
+	return walking_distance(statePtr);
+}
+
+
+/**
+ * Walking distance from the predecessor's codes
+ */
+static int walking_distance_delta(struct state* statePtr, const int N){
+	update_walking_distance_codes(statePtr, N);
+	return walking_distance(statePtr);
+}
+
+
+/**
+ * Walking distance codes without the distance, for a state whose distance came from the heuristic cache. The codes are
+ * all that its successors need
+ */
+static void walking_distance_refresh(struct state* statePtr, const int N){
+	if(statePtr->predecessor != NULL){
+		update_walking_distance_codes(statePtr, N);
+	} else {
+		walking_distance_codes(statePtr, N);
+	}
+}
+
+
+/**
+ * Load the pattern database, either the one the user gave or the default for N
+ */
+static int pattern_database_init(const struct solver_options* options, const int N){
+	char default_filename[256];
+	const char* filename = options->pattern_database;
+
+	if(filename == NULL){
+		sprintf(default_filename, "pattern_databases/%d.patterndb", N);
+		filename = default_filename;
+	}
+
+	if(initialize_pattern_database(filename, N) != 0){
+		return -1;
+	}
+
+	//Threads pinned to a node look patterns up in that node's own copy
+	if(options->numa){
+		replicate_pattern_database();
+	}
+
+	return 0;
+}
+
+
+//Every evaluator that can be named in a specification
+static struct heuristic evaluators[] = {
+	{"md", NULL, manhattan_evaluate, NULL, manhattan_evaluate_target, NULL, NULL, NULL},
+	{"lc", NULL, linear_conflict_evaluate, NULL, target_heuristic, NULL, NULL, NULL},
+	{"wd", walking_distance_init, walking_distance_evaluate, walking_distance_delta, NULL, destroy_walking_distance, NULL,
+	 walking_distance_refresh},
+	{"pdb", pattern_database_init, pattern_database_cost, NULL, NULL, destroy_pattern_database, pattern_database_prefetch, NULL},
+};
+#define NUM_EVALUATORS (int)(sizeof(evaluators) / sizeof(evaluators[0]))
+
+/*============================================================================================== */
+
+
+/*================================= Global variables for convenience =========================== */
+//The parsed specification. The heuristic is the max over groups of the sum over each group's terms
+struct heuristic* groups[MAX_GROUPS][MAX_TERMS];
+int group_sizes[MAX_GROUPS];
+int num_groups = 0;
+//Whether each evaluator has been initialized, so that an evaluator named twice is only loaded once
+int evaluator_initialized[NUM_EVALUATORS];
+//The specification as given, for printing
+const char* specification = NULL;
+//total_cost is g + weight * h, so a weight over 1 gives weighted A*
+double weight = 1.0;
+//1 if any evaluator in the specification is incremental
+int incremental = 0;
+//1 if every evaluator in the specification can evaluate against a target
+int supports_targets = 1;
+//1 if the specification never overestimates, which is whenever it adds nothing together
+int admissible = 1;
+//Where each tile sits in a goal that couldn't be relabeled onto the standard one, NULL when searching for the standard goal
+const short* goal_targets = NULL;
+/*============================================================================================== */
+
+
+/**
+ * Find an evaluator by the name in [start, end). Returns its index, or -1 if there is no such evaluator
+ */
+static int find_evaluator(const char* start, const char* end){
+	for(int i = 0; i < NUM_EVALUATORS; i++){
+		if(strlen(evaluators[i].name) == (size_t)(end - start) && strncmp(evaluators[i].name, start, end - start) == 0){
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+/**
+ * Parse the heuristic specification in the options and initialize every evaluator in it. Returns 0 on success,
+ * or -1 if the specification is malformed or an evaluator fails to initialize, in which case an error has
+ * already been printed
+ */
+int initialize_heuristic(const struct solver_options* options, const int N){
+	const char* spec = heuristic_for_goal(options->heuristic);
+	const char* start = spec;
+
+	specification = spec;
+	goal_targets = goal_target_positions();
+	weight = options->weight;
+	num_groups = 0;
+	incremental = 0;
+	supports_targets = 1;
+	admissible = heuristic_specification_admissible(spec);
+	memset(evaluator_initialized, 0, sizeof(evaluator_initialized));
+
+	//Every table, starting with the evaluators' own, comes from the table allocator
+	configure_table_memory(options);
+
+	//Build the kernels' tables up front, since the threaded solvers can't build them on first use
+	initialize_heuristic_kernels(N);
+
+	//Start the first group
+	group_sizes[num_groups++] = 0;
+
+	//Walk the specification one name at a time. Every name is ended by a +, a , or the end of the string
+	for(const char* cursor = spec; ; cursor++){
+		if(*cursor != '+' && *cursor != ',' && *cursor != '\0'){
+			continue;
+		}
+
+		int index = find_evaluator(start, cursor);
+		if(index == -1){
+			printf("ERROR. Unknown heuristic \"%.*s\" in \"%s\".\n\n", (int)(cursor - start), start, spec);
+			return -1;
+		}
+
+		//Add this evaluator to the current group
+		if(group_sizes[num_groups - 1] == MAX_TERMS){
+			printf("ERROR. At most %d heuristics can be added together.\n\n", MAX_TERMS);
+			return -1;
+		}
+		groups[num_groups - 1][group_sizes[num_groups - 1]++] = &evaluators[index];
+
+		//Load the evaluator the first time we see it
+		if(!evaluator_initialized[index]){
+			if(evaluators[index].init != NULL && evaluators[index].init(options, N) != 0){
+				return -1;
+			}
+			evaluator_initialized[index] = 1;
+		}
+
+		if(evaluators[index].delta != NULL){
+			incremental = 1;
+		}
+		if(evaluators[index].evaluate_target == NULL){
+			supports_targets = 0;
+		}
+
+		if(*cursor == '\0'){
+			break;
+		}
+
+		//A , starts a new group
+		if(*cursor == ','){
+			if(num_groups == MAX_GROUPS){
+				printf("ERROR. At most %d heuristics can be combined with max.\n\n", MAX_GROUPS);
+				return -1;
+			}
+			group_sizes[num_groups++] = 0;
+		}
+
+		start = cursor + 1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Tear down every evaluator that was initialized
+ */
+void destroy_heuristic(){
+	for(int i = 0; i < NUM_EVALUATORS; i++){
+		if(evaluator_initialized[i] && evaluators[i].teardown != NULL){
+			evaluators[i].teardown();
+		}
+		evaluator_initialized[i] = 0;
+	}
+
+	num_groups = 0;
+}
+
+
+/**
+ * The specification that the heuristic was initialized with
+ */
+const char* heuristic_name(){
+	return specification;
+}
+
+
+/**
+ * The weight that heuristic values are multiplied by in total_cost
+ */
+double heuristic_weight(){
+	return weight;
+}
+
+
+/**
+ * 1 if some evaluator keeps per-state information that must be filled in for every state, starting from the root
+ */
+int heuristic_is_incremental(){
+	return incremental;
+}
+
+
+/**
+ * 1 if the heuristic can be evaluated against any target, which is needed for searching backwards
+ */
+int heuristic_supports_targets(){
+	return supports_targets;
+}
+
+
+/**
+ * 1 if a specification never overestimates. No two built in evaluators count disjoint moves, so adding any of them
+ * together can overestimate, while taking the maximum never does. Needs no initialization, so a solver can check a
+ * specification before loading anything
+ */
+int heuristic_specification_admissible(const char* spec){
+	return strchr(spec, '+') == NULL;
+}
+
+
+/**
+ * 1 if every evaluator named in a specification can evaluate against a target. Names that aren't evaluators are left
+ * for initialize_heuristic to complain about
+ */
+int heuristic_specification_supports_targets(const char* spec){
+	const char* start = spec;
+
+	for(const char* cursor = spec; ; cursor++){
+		if(*cursor != '+' && *cursor != ',' && *cursor != '\0'){
+			continue;
+		}
+
+		int index = find_evaluator(start, cursor);
+		if(index != -1 && evaluators[index].evaluate_target == NULL){
+			return 0;
+		}
+
+		if(*cursor == '\0'){
+			return 1;
+		}
+		start = cursor + 1;
+	}
+}
+
+
+/**
+ * The specification to search with for the goal that initialize_start_goal set up. A goal that couldn't be relabeled
+ * onto the standard one is measured against where its tiles are, so a specification that can't do that falls back to
+ * linear conflict, which can
+ */
+const char* heuristic_for_goal(const char* spec){
+	if(goal_target_positions() == NULL || heuristic_specification_supports_targets(spec)){
+		return spec;
+	}
+
+	printf("The heuristic \"%s\" only measures against the standard goal, so \"lc\" is used instead.\n", spec);
+	return "lc";
+}
+
+
+/**
+ * 1 if the heuristic never overestimates
+ */
+int heuristic_is_admissible(){
+	return admissible;
+}
+
+
+/**
+ * 1 if the costs that the search orders states by never overestimate, so that the first solution found is optimal and
+ * the lowest open cost is a proven lower bound. Weighted and overlapping heuristics both lose this
+ */
+int heuristic_proves_optimality(){
+	return admissible && weight == 1.0;
+}
+
+
+/**
+ * Print the length of a solution, and as much about how close it is to optimal as the heuristic can promise
+ */
+void print_solution_path_length(int path_length){
+	if(!admissible){
+		printf("Solution path length: %d, not proven optimal, since the heuristic adds overlapping estimates\n", path_length);
+	} else if(weight == 1.0){
+		printf("Optimal solution path length: %d\n", path_length);
+	} else {
+		printf("Solution path length: %d, at most %.2f times optimal\n", path_length, weight);
+	}
+}
+
+
+/**
+ * Pin the calling worker thread to a NUMA node, spreading workers over the nodes round robin, and have it evaluate with
+ * the tables on that node. Does nothing unless NUMA placement was turned on
+ */
+void place_worker_thread(int worker){
+	if(!numa_placement_enabled()){
+		return;
+	}
+
+	int node = worker % numa_node_count();
+	pin_thread_to_node(node);
+	use_pattern_database_replica(node);
+}
+
+
+/**
+ * Evaluate the heuristic for a state. States with a predecessor are evaluated incrementally by the evaluators
+ * that support it, so a state's predecessor must have been evaluated first
+ */
+int evaluate_heuristic(struct state* statePtr, const int N){
+	//A goal that isn't the standard one is measured against where its tiles are
+	if(goal_targets != NULL){
+		return evaluate_target_heuristic(statePtr, goal_targets, N);
+	}
+
+	int best = 0;
+
+	for(int i = 0; i < num_groups; i++){
+		int sum = 0;
+
+		for(int j = 0; j < group_sizes[i]; j++){
+			struct heuristic* evaluator = groups[i][j];
+
+			if(evaluator->delta != NULL && statePtr->predecessor != NULL){
+				sum += evaluator->delta(statePtr, N);
+			} else {
+				sum += evaluator->evaluate(statePtr, N);
+			}
+		}
+
+		if(sum > best){
+			best = sum;
+		}
+	}
+
+	return best;
+}
+
+
+/**
+ * Evaluate the heuristic for a state against the target positions made by create_target_positions
+ * NOTE: only valid if heuristic_supports_targets(), must be checked by caller
+ */
+int evaluate_target_heuristic(struct state* statePtr, const short* target_positions, const int N){
+	int best = 0;
+
+	for(int i = 0; i < num_groups; i++){
+		int sum = 0;
+
+		for(int j = 0; j < group_sizes[i]; j++){
+			sum += groups[i][j]->evaluate_target(statePtr, target_positions, N);
+		}
+
+		if(sum > best){
+			best = sum;
+		}
+	}
+
+	return best;
+}
+
+
+/**
+ * Fill in heuristic_cost and total_cost for a state, looking up its key in the heuristic cache first if there is one
+ */
+static void finish_heuristic(struct state* statePtr, unsigned long long key, const int N, struct heuristic_cache* cache){
+	int heuristic_cost;
+
+	//Only evaluate on a cache miss
+	if(cache == NULL || !heuristic_cache_lookup(cache, key, &heuristic_cost)){
+		heuristic_cost = evaluate_heuristic(statePtr, N);
+
+		if(cache != NULL){
+			heuristic_cache_store(cache, key, heuristic_cost);
+		}
+	} else if(incremental){
+		//A hit skips evaluating, but the successors still need whatever the incremental evaluators keep in the state
+		for(int i = 0; i < num_groups; i++){
+			for(int j = 0; j < group_sizes[i]; j++){
+				if(groups[i][j]->refresh != NULL){
+					groups[i][j]->refresh(statePtr, N);
+				}
+			}
+		}
+	}
+
+	statePtr->heuristic_cost = heuristic_cost;
+	if(weight == 1.0){
+		statePtr->total_cost = statePtr->current_travel + heuristic_cost;
+	} else {
+		statePtr->total_cost = statePtr->current_travel + (int)(weight * heuristic_cost);
+	}
+}
+
+
+/**
+ * Update the prediction function for the state pointed to by statePtr, going through the heuristic cache first
+ * if there is one. The current_travel must already be set, as total_cost is updated along with heuristic_cost.
+ * With a weight over 1, total_cost is g + floor(weight * h) and the solution found is at most weight times the
+ * optimal length, while heuristic_cost always holds the unweighted h
+ */
+void update_heuristic(struct state* statePtr, const int N, struct heuristic_cache* cache){
+	//If statePtr is null, this state was a repeat and has been freed, so don't calculate anything
+	if(statePtr == NULL){
+		return;
+	}
+
+	finish_heuristic(statePtr, cache != NULL ? hash_state(statePtr, N) : 0, N, cache);
+}
+
+
+/**
+ * Update the prediction function for a whole batch of states, skipping the NULL ones. Every cache entry and database
+ * slot that the batch needs is prefetched before any of them is evaluated, so that their memory latencies overlap
+ * instead of being paid one after another
+ */
+void update_heuristic_batch(struct state** states, const int count, const int N, struct heuristic_cache* cache){
+	unsigned long long keys[count];
+
+	//First start loading everything
+	for(int i = 0; i < count; i++){
+		if(states[i] == NULL){
+			continue;
+		}
+
+		if(cache != NULL){
+			keys[i] = hash_state(states[i], N);
+			heuristic_cache_prefetch(cache, keys[i]);
+		}
+
+		for(int group = 0; group < num_groups; group++){
+			for(int term = 0; term < group_sizes[group]; term++){
+				if(groups[group][term]->prefetch != NULL){
+					groups[group][term]->prefetch(states[i], N);
+				}
+			}
+		}
+	}
+
+	//By now the first states' memory should be in the CPU cache
+	for(int i = 0; i < count; i++){
+		if(states[i] != NULL){
+			finish_heuristic(states[i], cache != NULL ? keys[i] : 0, N, cache);
+		}
+	}
+}
+
+
+/**
+ * Create the heuristic cache that the options ask for. Returns NULL if the cache is turned off. Incremental evaluators
+ * are cached too, a hit refreshes the per-state information that their successors rely on
+ */
+struct heuristic_cache* create_heuristic_cache_for(const struct solver_options* options){
+	if(options->cache_bits == 0){
+		return NULL;
+	}
+
+	return create_heuristic_cache(options->cache_bits);
+}
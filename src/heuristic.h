@@ -0,0 +1,62 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the heuristic interface that every solver uses, and the function prototypes
+ * that are implemented in heuristic.c
+ */
+
+
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include "puzzle.h"
+#include "options.h"
+#include "heuristic_cache.h"
+
+
+/**
+ * One heuristic evaluator. Every evaluator can evaluate a state from scratch. Evaluators that keep per-state
+ * information can also evaluate a state incrementally from its predecessor, and evaluators that are not tied
+ * to the standard goal can evaluate a state against any target
+ */
+struct heuristic {
+	//The name used on the command line
+	const char* name;
+	//Load or build whatever the evaluator needs, returns 0 on success and -1 on failure
+	int (*init)(const struct solver_options*, const int);
+	//Evaluate a state from scratch
+	int (*evaluate)(struct state*, const int);
+	//Evaluate a state from its predecessor, NULL if the evaluator is not incremental
+	int (*delta)(struct state*, const int);
+	//Evaluate a state against the target positions made by create_target_positions, NULL if goal only
+	int (*evaluate_target)(struct state*, const short*, const int);
+	//Free whatever init made, NULL if there is nothing to free
+	void (*teardown)(void);
+	//Start loading whatever memory evaluating a state will touch, NULL if it only touches the state
+	void (*prefetch)(struct state*, const int);
+	//Fill in only the per-state information that delta needs, for a state whose value came from the heuristic cache.
+	//NULL if the evaluator is not incremental
+	void (*refresh)(struct state*, const int);
+};
+
+
+/* Method Protoypes */
+int initialize_heuristic(const struct solver_options*, const int);
+void destroy_heuristic(void);
+const char* heuristic_name(void);
+double heuristic_weight(void);
+int heuristic_is_incremental(void);
+int heuristic_supports_targets(void);
+int heuristic_specification_admissible(const char*);
+int heuristic_specification_supports_targets(const char*);
+const char* heuristic_for_goal(const char*);
+int heuristic_is_admissible(void);
+int heuristic_proves_optimality(void);
+void print_solution_path_length(int);
+void place_worker_thread(int);
+int evaluate_heuristic(struct state*, const int);
+int evaluate_target_heuristic(struct state*, const short*, const int);
+void update_heuristic(struct state*, const int, struct heuristic_cache*);
+void update_heuristic_batch(struct state**, const int, const int, struct heuristic_cache*);
+struct heuristic_cache* create_heuristic_cache_for(const struct solver_options*);
+
+#endif /* HEURISTIC_H */
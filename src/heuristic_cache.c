@@ -0,0 +1,157 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in heuristic_cache.h. The heuristic cache sits in front
+ * of the heuristic function in every solver, so that transpositions in the search do not recompute the same
+ * heuristic value over and over again
+ */
+
+//Link to heuristic_cache.h
+#include "heuristic_cache.h"
+#include "table_memory.h"
+
+
+//The low 16 bits of an entry hold the value, the rest hold the tag
+#define VALUE_BITS 16
+#define VALUE_MASK 0xFFFFULL
+//How many lookups a thread counts on its own before adding them to the cache's shared counts
+#define COUNT_INTERVAL 1024
+
+
+/*================================= Global variables for convenience =========================== */
+//Hits and misses that this thread hasn't added to the shared counts yet, and the cache that they were for
+static _Thread_local struct heuristic_cache* counted_cache = NULL;
+static _Thread_local long unflushed_hits = 0, unflushed_misses = 0;
+/*============================================================================================== */
+
+
+/**
+ * Create a cache with 2^cache_bits entries. Each entry is 8 bytes
+ */
+struct heuristic_cache* create_heuristic_cache(int cache_bits){
+	struct heuristic_cache* cache = (struct heuristic_cache*)malloc(sizeof(struct heuristic_cache));
+
+	//Every entry starts out empty(0)
+	cache->entries = (_Atomic unsigned long long*)allocate_table((1ULL << cache_bits) * sizeof(unsigned long long));
+	cache->mask = (1ULL << cache_bits) - 1;
+	atomic_init(&cache->hits, 0);
+	atomic_init(&cache->misses, 0);
+
+	return cache;
+}
+
+
+/**
+ * Add the hits and misses that this thread has counted to its cache's shared counts. A thread that used a cache has to
+ * call this before it finishes, or whatever it counted since it last added them is lost
+ */
+void flush_heuristic_cache_counts(){
+	if(counted_cache != NULL){
+		atomic_fetch_add_explicit(&counted_cache->hits, unflushed_hits, memory_order_relaxed);
+		atomic_fetch_add_explicit(&counted_cache->misses, unflushed_misses, memory_order_relaxed);
+	}
+
+	unflushed_hits = unflushed_misses = 0;
+}
+
+
+/**
+ * Count a lookup on this thread. Every lookup used to add to the shared counts, which every thread then fought over
+ * for its cache line, so they are only added every COUNT_INTERVAL lookups, or when the thread moves to another cache
+ */
+static void count_lookup(struct heuristic_cache* cache, int hit){
+	if(cache != counted_cache){
+		flush_heuristic_cache_counts();
+		counted_cache = cache;
+	}
+
+	if(hit){
+		unflushed_hits++;
+	} else {
+		unflushed_misses++;
+	}
+
+	if(unflushed_hits + unflushed_misses >= COUNT_INTERVAL){
+		flush_heuristic_cache_counts();
+	}
+}
+
+
+/**
+ * Free all of the memory used by the cache
+ */
+void destroy_heuristic_cache(struct heuristic_cache* cache){
+	//Whatever this thread still has counted for it has nowhere to go
+	if(counted_cache == cache){
+		counted_cache = NULL;
+		unflushed_hits = unflushed_misses = 0;
+	}
+
+	free_table((void*)cache->entries, (cache->mask + 1) * sizeof(unsigned long long));
+	free(cache);
+}
+
+
+/**
+ * Start loading the entry for the given state hash into the CPU cache, so that a lookup soon after doesn't wait on memory
+ */
+void heuristic_cache_prefetch(struct heuristic_cache* cache, unsigned long long key){
+	__builtin_prefetch(&cache->entries[key & cache->mask], 0, 1);
+}
+
+
+/**
+ * Look up the heuristic value for the given state hash. If the value is in the cache, it is stored in value
+ * and 1 is returned. Otherwise 0 is returned
+ * NOTE: the tag is only the upper 48 bits of the key, so two different states that share those bits and the
+ * same slot would collide. With a 64 bit hash this is vanishingly rare
+ */
+int heuristic_cache_lookup(struct heuristic_cache* cache, unsigned long long key, int* value){
+	//Direct mapped, so each key has exactly one slot
+	unsigned long long entry = atomic_load_explicit(&cache->entries[key & cache->mask], memory_order_relaxed);
+
+	//The tag must match, and the entry must not be empty
+	if(entry != 0 && (entry >> VALUE_BITS) == (key >> VALUE_BITS)){
+		count_lookup(cache, 1);
+		//We store value + 1 so that 0 can mean empty
+		*value = (int)(entry & VALUE_MASK) - 1;
+		return 1;
+	}
+
+	count_lookup(cache, 0);
+	return 0;
+}
+
+
+/**
+ * Store the heuristic value for the given state hash, overwriting whatever was in its slot
+ */
+void heuristic_cache_store(struct heuristic_cache* cache, unsigned long long key, int value){
+	//Values that don't fit in the entry simply aren't cached
+	if(value < 0 || (unsigned long long)value >= VALUE_MASK){
+		return;
+	}
+
+	//Pack the tag and the value + 1 into one word, so the write is atomic
+	unsigned long long entry = ((key >> VALUE_BITS) << VALUE_BITS) | (unsigned long long)(value + 1);
+	atomic_store_explicit(&cache->entries[key & cache->mask], entry, memory_order_relaxed);
+}
+
+
+/**
+ * Print the cache size and hit rate, for use in the solvers' running statistics. Any other thread that used the cache
+ * must have flushed its counts first
+ */
+void print_heuristic_cache_stats(struct heuristic_cache* cache){
+	//The thread that prints has usually done lookups of its own
+	flush_heuristic_cache_counts();
+
+	long hits = atomic_load(&cache->hits);
+	long misses = atomic_load(&cache->misses);
+
+	//Avoid dividing by zero if the cache was never used
+	double hit_rate = hits + misses == 0 ? 0.0 : 100.0 * hits / (hits + misses);
+
+	printf("Heuristic cache: %llu entries(%.2f MB), %ld hits, %ld misses, %.2f%% hit rate\n", cache->mask + 1,
+		   (cache->mask + 1) * sizeof(unsigned long long) / 1048576.0, hits, misses, hit_rate);
+}
+
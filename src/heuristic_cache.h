@@ -0,0 +1,45 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the heuristic cache structure and function prototypes that are implemented
+ * in heuristic_cache.c
+ */
+
+
+#ifndef HEURISTIC_CACHE_H
+#define HEURISTIC_CACHE_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+
+//The default cache has 2^20 entries, or 8 MB
+#define DEFAULT_CACHE_BITS 20
+
+
+/**
+ * A fixed-size, direct-mapped cache of heuristic values, keyed by the hash of a state. Every entry is one
+ * 64 bit word holding the upper bits of the key as a tag and the heuristic value in the low 16 bits, so
+ * entries can be read and written by any number of threads without locks
+ */
+struct heuristic_cache {
+	//The cache entries themselves, 0 means empty
+	_Atomic unsigned long long* entries;
+	//Number of entries - 1, the number of entries is always a power of 2
+	unsigned long long mask;
+	//Keep track of our hit rate so that we can size the cache. Each thread counts on its own and adds to these every so
+	//often, see flush_heuristic_cache_counts
+	atomic_long hits, misses;
+};
+
+
+/* Method Protoypes */
+struct heuristic_cache* create_heuristic_cache(int);
+void destroy_heuristic_cache(struct heuristic_cache*);
+void heuristic_cache_prefetch(struct heuristic_cache*, unsigned long long);
+int heuristic_cache_lookup(struct heuristic_cache*, unsigned long long, int*);
+void flush_heuristic_cache_counts();
+void heuristic_cache_store(struct heuristic_cache*, unsigned long long, int);
+void print_heuristic_cache_stats(struct heuristic_cache*);
+
+#endif /* HEURISTIC_CACHE_H */
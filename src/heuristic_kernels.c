@@ -0,0 +1,417 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in heuristic_kernels.h. These are the Manhattan distance and
+ * generalized linear conflict heuristics from update_prediction_function, rewritten to use the vector units.
+ *
+ * The Manhattan distance is found several tiles at a time. Every tile's goal row and goal column are gathered from tables
+ * that are built once per N, so there is no divide or modulo, and the absolute differences from each cell's row and column
+ * are added up across the vector. The same pass marks which tiles are already in their goal row or goal column.
+ *
+ * Linear conflicts are then counted with vector compares. Keeping only the tiles in their goal column, a conflict between
+ * row a and a lower row b in any column is a tile in a that is bigger than a(nonzero) tile in b, so comparing the two rows
+ * as whole vectors finds the conflicts in every column at once. Rows are done the same way, on the transposed board.
+ *
+ * The best kernel that the CPU supports is picked at runtime, from AVX-512, AVX2 and SSE4.1, and there is a scalar kernel
+ * for other CPUs and for boards too big for a vector. Every kernel gives exactly the same values as the original code
+ */
+
+//Link to heuristic_kernels.h
+#include "heuristic_kernels.h"
+#include <string.h>
+
+//The vector kernels are only built for x86, everything else uses the scalar kernel
+#if defined(__x86_64__) || defined(__i386__)
+#define HEURISTIC_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+
+//The biggest board whose rows fit in a 256 bit vector of shorts, and in a 128 bit vector of shorts
+#define MAX_VECTOR_N 16
+#define MAX_SSE_N 8
+
+
+/*================================= Global variables for convenience =========================== */
+//The N that the tables were built for, 0 if they haven't been
+int kernel_N = 0;
+//For every tile, the row and column of its goal. The blank's entries are never used
+int* goal_rows = NULL;
+int* goal_columns = NULL;
+//For every cell, its row and column
+int* cell_rows = NULL;
+int* cell_columns = NULL;
+//The kernel in use and its name. The last argument says whether to add linear conflicts
+int (*kernel)(const short*, const int, const int) = NULL;
+const char* kernel_name = "scalar";
+/*============================================================================================== */
+
+
+/**
+ * The scalar kernel, used when there is no vector unit to use or the board is too big
+ */
+static int scalar_kernel(const short* tiles, const int N, const int conflicts){
+	int manhattan_distance = 0, linear_conflicts = 0;
+
+	for(int i = 0; i < N * N; i++){
+		//The blank can move freely, so it doesn't count
+		if(tiles[i] != 0){
+			manhattan_distance += abs(cell_rows[i] - goal_rows[tiles[i]]) + abs(cell_columns[i] - goal_columns[tiles[i]]);
+		}
+	}
+
+	if(!conflicts){
+		return manhattan_distance;
+	}
+
+	//Two tiles in their goal row, with the bigger one on the left, are a conflict
+	for(int i = 0; i < N; i++){
+		for(int j = 0; j < N - 1; j++){
+			short left = tiles[i * N + j];
+			if(left == 0 || goal_rows[left] != i){
+				continue;
+			}
+
+			for(int k = j + 1; k < N; k++){
+				short right = tiles[i * N + k];
+				if(right != 0 && goal_rows[right] == i && left > right){
+					linear_conflicts++;
+				}
+			}
+		}
+	}
+
+	//Two tiles in their goal column, with the bigger one above, are a conflict
+	for(int i = 0; i < N - 1; i++){
+		for(int j = 0; j < N; j++){
+			short above = tiles[i * N + j];
+			if(above == 0 || goal_columns[above] != j){
+				continue;
+			}
+
+			for(int k = i + 1; k < N; k++){
+				short below = tiles[k * N + j];
+				if(below != 0 && goal_columns[below] == j && above > below){
+					linear_conflicts++;
+				}
+			}
+		}
+	}
+
+	return manhattan_distance + 2 * linear_conflicts;
+}
+
+
+#ifdef HEURISTIC_KERNELS_X86
+
+/**
+ * Lay out the tiles that are in their goal column by row, and the tiles that are in their goal row by column(transposed),
+ * with zeros everywhere else, so that the conflict counts can compare whole rows of each at once
+ */
+static void fill_conflict_matrices(const int* row_values, const int* column_values, short matrices[2][MAX_VECTOR_N][MAX_VECTOR_N], const int N){
+	memset(matrices[0], 0, sizeof(short) * MAX_VECTOR_N * N);
+	memset(matrices[1], 0, sizeof(short) * MAX_VECTOR_N * N);
+
+	for(int i = 0, cell = 0; i < N; i++){
+		for(int j = 0; j < N; j++, cell++){
+			matrices[0][i][j] = column_values[cell];
+			matrices[1][j][i] = row_values[cell];
+		}
+	}
+}
+
+
+/**
+ * Count the conflicts in both matrices 8 columns at a time, for boards up to 8x8. Every pair of rows a above b is
+ * compared at once, and every lane where a > b > 0 is a conflict
+ */
+__attribute__((target("sse4.1,popcnt")))
+static int sse_count_conflicts(short matrices[2][MAX_VECTOR_N][MAX_VECTOR_N], const int N){
+	int linear_conflicts = 0;
+	__m128i zero = _mm_setzero_si128();
+
+	for(int m = 0; m < 2; m++){
+		for(int a = 0; a < N - 1; a++){
+			__m128i above = _mm_loadu_si128((const __m128i*)matrices[m][a]);
+
+			for(int b = a + 1; b < N; b++){
+				__m128i below = _mm_loadu_si128((const __m128i*)matrices[m][b]);
+				__m128i conflict = _mm_and_si128(_mm_cmpgt_epi16(above, below), _mm_cmpgt_epi16(below, zero));
+				//Every lane sets 2 bits of the mask
+				linear_conflicts += __builtin_popcount(_mm_movemask_epi8(conflict)) / 2;
+			}
+		}
+	}
+
+	return linear_conflicts;
+}
+
+
+/**
+ * The SSE4.1 kernel. There is no gather, so the goal rows and columns are loaded one at a time, 4 tiles to a vector
+ */
+__attribute__((target("sse4.1,popcnt")))
+static int sse_kernel(const short* tiles, const int N, const int conflicts){
+	int row_values[MAX_SSE_N * MAX_SSE_N], column_values[MAX_SSE_N * MAX_SSE_N];
+	__m128i sum = _mm_setzero_si128(), zero = _mm_setzero_si128();
+	int cells = N * N, i = 0;
+
+	for(; i + 4 <= cells; i += 4){
+		__m128i tile = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(tiles + i)));
+		__m128i goal_row = _mm_setr_epi32(goal_rows[tiles[i]], goal_rows[tiles[i + 1]], goal_rows[tiles[i + 2]], goal_rows[tiles[i + 3]]);
+		__m128i goal_column = _mm_setr_epi32(goal_columns[tiles[i]], goal_columns[tiles[i + 1]], goal_columns[tiles[i + 2]], goal_columns[tiles[i + 3]]);
+		__m128i row = _mm_loadu_si128((const __m128i*)(cell_rows + i));
+		__m128i column = _mm_loadu_si128((const __m128i*)(cell_columns + i));
+		__m128i blank = _mm_cmpeq_epi32(tile, zero);
+
+		//|row - goal row| + |column - goal column|, except for the blank
+		__m128i distance = _mm_add_epi32(_mm_abs_epi32(_mm_sub_epi32(row, goal_row)), _mm_abs_epi32(_mm_sub_epi32(column, goal_column)));
+		sum = _mm_add_epi32(sum, _mm_andnot_si128(blank, distance));
+
+		//The blank is 0, so it drops out of these on its own
+		_mm_storeu_si128((__m128i*)(row_values + i), _mm_and_si128(_mm_cmpeq_epi32(row, goal_row), tile));
+		_mm_storeu_si128((__m128i*)(column_values + i), _mm_and_si128(_mm_cmpeq_epi32(column, goal_column), tile));
+	}
+
+	//Add up the lanes
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	int manhattan_distance = _mm_cvtsi128_si32(sum);
+
+	//Whatever didn't fill a vector
+	for(; i < cells; i++){
+		short tile = tiles[i];
+		if(tile != 0){
+			manhattan_distance += abs(cell_rows[i] - goal_rows[tile]) + abs(cell_columns[i] - goal_columns[tile]);
+		}
+		row_values[i] = goal_rows[tile] == cell_rows[i] ? tile : 0;
+		column_values[i] = goal_columns[tile] == cell_columns[i] ? tile : 0;
+	}
+
+	if(!conflicts){
+		return manhattan_distance;
+	}
+
+	short matrices[2][MAX_VECTOR_N][MAX_VECTOR_N];
+	fill_conflict_matrices(row_values, column_values, matrices, N);
+	return manhattan_distance + 2 * sse_count_conflicts(matrices, N);
+}
+
+
+/**
+ * Count the conflicts in both matrices 16 columns at a time, for boards up to 16x16
+ */
+__attribute__((target("avx2,popcnt")))
+static int avx2_count_conflicts(short matrices[2][MAX_VECTOR_N][MAX_VECTOR_N], const int N){
+	int linear_conflicts = 0;
+	__m256i zero = _mm256_setzero_si256();
+
+	for(int m = 0; m < 2; m++){
+		for(int a = 0; a < N - 1; a++){
+			__m256i above = _mm256_loadu_si256((const __m256i*)matrices[m][a]);
+
+			for(int b = a + 1; b < N; b++){
+				__m256i below = _mm256_loadu_si256((const __m256i*)matrices[m][b]);
+				__m256i conflict = _mm256_and_si256(_mm256_cmpgt_epi16(above, below), _mm256_cmpgt_epi16(below, zero));
+				//Every lane sets 2 bits of the mask
+				linear_conflicts += __builtin_popcount(_mm256_movemask_epi8(conflict)) / 2;
+			}
+		}
+	}
+
+	return linear_conflicts;
+}
+
+
+/**
+ * The AVX2 kernel, 8 tiles to a vector with the goal rows and columns gathered
+ */
+__attribute__((target("avx2,popcnt")))
+static int avx2_kernel(const short* tiles, const int N, const int conflicts){
+	int row_values[MAX_VECTOR_N * MAX_VECTOR_N], column_values[MAX_VECTOR_N * MAX_VECTOR_N];
+	__m256i sum = _mm256_setzero_si256(), zero = _mm256_setzero_si256();
+	int cells = N * N, i = 0;
+
+	for(; i + 8 <= cells; i += 8){
+		__m256i tile = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(tiles + i)));
+		__m256i goal_row = _mm256_i32gather_epi32(goal_rows, tile, 4);
+		__m256i goal_column = _mm256_i32gather_epi32(goal_columns, tile, 4);
+		__m256i row = _mm256_loadu_si256((const __m256i*)(cell_rows + i));
+		__m256i column = _mm256_loadu_si256((const __m256i*)(cell_columns + i));
+		__m256i blank = _mm256_cmpeq_epi32(tile, zero);
+
+		//|row - goal row| + |column - goal column|, except for the blank
+		__m256i distance = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(row, goal_row)), _mm256_abs_epi32(_mm256_sub_epi32(column, goal_column)));
+		sum = _mm256_add_epi32(sum, _mm256_andnot_si256(blank, distance));
+
+		//The blank is 0, so it drops out of these on its own
+		_mm256_storeu_si256((__m256i*)(row_values + i), _mm256_and_si256(_mm256_cmpeq_epi32(row, goal_row), tile));
+		_mm256_storeu_si256((__m256i*)(column_values + i), _mm256_and_si256(_mm256_cmpeq_epi32(column, goal_column), tile));
+	}
+
+	//Add up the lanes
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+	int manhattan_distance = _mm_cvtsi128_si32(half);
+
+	//Whatever didn't fill a vector
+	for(; i < cells; i++){
+		short tile = tiles[i];
+		if(tile != 0){
+			manhattan_distance += abs(cell_rows[i] - goal_rows[tile]) + abs(cell_columns[i] - goal_columns[tile]);
+		}
+		row_values[i] = goal_rows[tile] == cell_rows[i] ? tile : 0;
+		column_values[i] = goal_columns[tile] == cell_columns[i] ? tile : 0;
+	}
+
+	if(!conflicts){
+		return manhattan_distance;
+	}
+
+	short matrices[2][MAX_VECTOR_N][MAX_VECTOR_N];
+	fill_conflict_matrices(row_values, column_values, matrices, N);
+	return manhattan_distance + 2 * (N <= MAX_SSE_N ? sse_count_conflicts(matrices, N) : avx2_count_conflicts(matrices, N));
+}
+
+
+/**
+ * Count the conflicts in both matrices 16 columns at a time, with the compares going straight into mask registers
+ */
+__attribute__((target("avx512f,avx512bw,avx512vl,popcnt")))
+static int avx512_count_conflicts(short matrices[2][MAX_VECTOR_N][MAX_VECTOR_N], const int N){
+	int linear_conflicts = 0;
+	__m256i zero = _mm256_setzero_si256();
+
+	for(int m = 0; m < 2; m++){
+		for(int a = 0; a < N - 1; a++){
+			__m256i above = _mm256_loadu_si256((const __m256i*)matrices[m][a]);
+
+			for(int b = a + 1; b < N; b++){
+				__m256i below = _mm256_loadu_si256((const __m256i*)matrices[m][b]);
+				linear_conflicts += __builtin_popcount(_mm256_mask_cmpgt_epi16_mask(_mm256_cmpgt_epi16_mask(below, zero), above, below));
+			}
+		}
+	}
+
+	return linear_conflicts;
+}
+
+
+/**
+ * The AVX-512 kernel, 16 tiles to a vector, so a 4x4 board is one vector. The last vector is loaded with a mask, so
+ * there is never a scalar tail
+ */
+__attribute__((target("avx512f,avx512bw,avx512vl,popcnt")))
+static int avx512_kernel(const short* tiles, const int N, const int conflicts){
+	int row_values[MAX_VECTOR_N * MAX_VECTOR_N], column_values[MAX_VECTOR_N * MAX_VECTOR_N];
+	__m512i sum = _mm512_setzero_si512(), zero = _mm512_setzero_si512();
+	int cells = N * N;
+
+	for(int i = 0; i < cells; i += 16){
+		__mmask16 present = cells - i >= 16 ? 0xFFFF : (__mmask16)((1 << (cells - i)) - 1);
+		__m512i tile = _mm512_cvtepi16_epi32(_mm256_maskz_loadu_epi16(present, tiles + i));
+		__mmask16 placed = _mm512_mask_cmpneq_epi32_mask(present, tile, zero);
+		__m512i goal_row = _mm512_mask_i32gather_epi32(zero, placed, tile, goal_rows, 4);
+		__m512i goal_column = _mm512_mask_i32gather_epi32(zero, placed, tile, goal_columns, 4);
+		__m512i row = _mm512_maskz_loadu_epi32(present, cell_rows + i);
+		__m512i column = _mm512_maskz_loadu_epi32(present, cell_columns + i);
+
+		//|row - goal row| + |column - goal column|, only for the tiles that are there
+		__m512i distance = _mm512_add_epi32(_mm512_abs_epi32(_mm512_sub_epi32(row, goal_row)), _mm512_abs_epi32(_mm512_sub_epi32(column, goal_column)));
+		sum = _mm512_mask_add_epi32(sum, placed, sum, distance);
+
+		_mm512_mask_storeu_epi32(row_values + i, present, _mm512_maskz_mov_epi32(_mm512_mask_cmpeq_epi32_mask(placed, row, goal_row), tile));
+		_mm512_mask_storeu_epi32(column_values + i, present, _mm512_maskz_mov_epi32(_mm512_mask_cmpeq_epi32_mask(placed, column, goal_column), tile));
+	}
+
+	int manhattan_distance = _mm512_reduce_add_epi32(sum);
+
+	if(!conflicts){
+		return manhattan_distance;
+	}
+
+	short matrices[2][MAX_VECTOR_N][MAX_VECTOR_N];
+	fill_conflict_matrices(row_values, column_values, matrices, N);
+	return manhattan_distance + 2 * (N <= MAX_SSE_N ? sse_count_conflicts(matrices, N) : avx512_count_conflicts(matrices, N));
+}
+
+#endif /* HEURISTIC_KERNELS_X86 */
+
+
+/**
+ * Build the goal and cell tables for N and pick the best kernel that this CPU supports for boards of this size. Must
+ * be called before searching with more than one thread, the kernels call it themselves the first time otherwise
+ */
+void initialize_heuristic_kernels(const int N){
+	if(kernel_N == N){
+		return;
+	}
+
+	free(goal_rows);
+	free(goal_columns);
+	free(cell_rows);
+	free(cell_columns);
+	goal_rows = (int*)malloc(sizeof(int) * N * N);
+	goal_columns = (int*)malloc(sizeof(int) * N * N);
+	cell_rows = (int*)malloc(sizeof(int) * N * N);
+	cell_columns = (int*)malloc(sizeof(int) * N * N);
+
+	for(int i = 0; i < N * N; i++){
+		//Tile i + 1 goes in cell i, and the blank goes in the last cell
+		goal_rows[(i + 1) % (N * N)] = i / N;
+		goal_columns[(i + 1) % (N * N)] = i % N;
+		cell_rows[i] = i / N;
+		cell_columns[i] = i % N;
+	}
+
+	kernel = scalar_kernel;
+	kernel_name = "scalar";
+
+#ifdef HEURISTIC_KERNELS_X86
+	__builtin_cpu_init();
+	if(N <= MAX_VECTOR_N && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl")){
+		kernel = avx512_kernel;
+		kernel_name = "avx512";
+	} else if(N <= MAX_VECTOR_N && __builtin_cpu_supports("avx2")){
+		kernel = avx2_kernel;
+		kernel_name = "avx2";
+	} else if(N <= MAX_SSE_N && __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt")){
+		kernel = sse_kernel;
+		kernel_name = "sse4.1";
+	}
+#endif
+
+	kernel_N = N;
+}
+
+
+/**
+ * The name of the kernel in use, for printing
+ */
+const char* heuristic_kernel_name(){
+	return kernel_name;
+}
+
+
+/**
+ * The Manhattan distance of the board to the standard goal
+ */
+int manhattan_kernel(const short* tiles, const int N){
+	if(kernel_N != N){
+		initialize_heuristic_kernels(N);
+	}
+
+	return kernel(tiles, N, 0);
+}
+
+
+/**
+ * The Manhattan distance of the board to the standard goal plus 2 for every generalized linear conflict
+ */
+int linear_conflict_kernel(const short* tiles, const int N){
+	if(kernel_N != N){
+		initialize_heuristic_kernels(N);
+	}
+
+	return kernel(tiles, N, 1);
+}
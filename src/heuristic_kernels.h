@@ -0,0 +1,21 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the function prototypes for the vectorized Manhattan distance and linear conflict kernels
+ * that are implemented in heuristic_kernels.c
+ */
+
+
+#ifndef HEURISTIC_KERNELS_H
+#define HEURISTIC_KERNELS_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+/* Method Protoypes */
+void initialize_heuristic_kernels(const int);
+const char* heuristic_kernel_name(void);
+int manhattan_kernel(const short*, const int);
+int linear_conflict_kernel(const short*, const int);
+
+#endif /* HEURISTIC_KERNELS_H */
@@ -0,0 +1,321 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in node_store.h. A search used to malloc a struct state for
+ * every successor, and keep the fringe and closed as arrays of pointers to them, so every heap sift and every duplicate
+ * check chased pointers all over memory. The node store keeps each field of every node in its own array instead, with
+ * the tiles packed, and a node is known by its index. The open list holds (f, id) pairs, so sifting only ever touches
+ * the heap itself, and duplicates are found with one hash probe on the packed tiles
+ */
+
+//Link to node_store.h
+#include "node_store.h"
+#include "table_memory.h"
+
+
+/**
+ * Hash a packed state. The packed bytes are folded together 8 at a time and mixed, so the node store never needs to
+ * keep a key for each node
+ */
+static unsigned long long hash_packed(const unsigned char* packed, int packed_size){
+	unsigned long long hash = 0x9E3779B97F4A7C15ULL;
+
+	for(int i = 0; i < packed_size; i += 8){
+		unsigned long long chunk = 0;
+		int length = packed_size - i < 8 ? packed_size - i : 8;
+		memcpy(&chunk, packed + i, length);
+
+		hash = (hash ^ chunk) * 0xBF58476D1CE4E5B9ULL;
+		hash ^= hash >> 31;
+	}
+
+	return hash;
+}
+
+
+/**
+ * Find the index slot that holds the node with these packed tiles, or the empty slot where it belongs
+ */
+static unsigned long long index_slot(struct node_store* store, const unsigned char* packed){
+	unsigned long long slot = hash_packed(packed, store->packed_size) & store->index_mask;
+
+	//Linear probing
+	while(store->index[slot] != 0){
+		unsigned int id = store->index[slot] - 1;
+		if(memcmp(store->tiles + (size_t)id * store->packed_size, packed, store->packed_size) == 0){
+			break;
+		}
+		slot = (slot + 1) & store->index_mask;
+	}
+
+	return slot;
+}
+
+
+/**
+ * Put every node into the index, which must be empty. Also used to index nodes that were read in all at once, like
+ * from a checkpoint
+ */
+void rebuild_node_store_index(struct node_store* store){
+	for(unsigned int id = 0; id < store->count; id++){
+		store->index[index_slot(store, store->tiles + (size_t)id * store->packed_size)] = id + 1;
+	}
+}
+
+
+/**
+ * Double the index, putting every node back in
+ */
+static void grow_index(struct node_store* store){
+	free_table(store->index, sizeof(unsigned int) * (store->index_mask + 1));
+	store->index_mask = store->index_mask * 2 + 1;
+	store->index = (unsigned int*)allocate_table(sizeof(unsigned int) * (store->index_mask + 1));
+
+	rebuild_node_store_index(store);
+}
+
+
+/**
+ * Double the room for nodes
+ */
+static void grow_nodes(struct node_store* store){
+	size_t old_capacity = store->capacity;
+	store->capacity *= 2;
+	store->tiles = (unsigned char*)resize_table(store->tiles, old_capacity * store->packed_size, (size_t)store->capacity * store->packed_size);
+	store->g = (unsigned short*)resize_table(store->g, sizeof(unsigned short) * old_capacity, sizeof(unsigned short) * store->capacity);
+	store->h = (unsigned char*)resize_table(store->h, sizeof(unsigned char) * old_capacity, sizeof(unsigned char) * store->capacity);
+	store->parent = (unsigned int*)resize_table(store->parent, sizeof(unsigned int) * old_capacity, sizeof(unsigned int) * store->capacity);
+	store->flags = (unsigned char*)resize_table(store->flags, sizeof(unsigned char) * old_capacity, sizeof(unsigned char) * store->capacity);
+}
+
+
+/**
+ * Create an empty node store with room for 2^bits nodes to start, for an N puzzle
+ */
+struct node_store* create_node_store(int bits, const int N){
+	struct node_store* store = (struct node_store*)malloc(sizeof(struct node_store));
+
+	store->N = N;
+	store->packed_size = packed_state_size(N);
+	store->count = 0;
+	store->capacity = 1u << bits;
+	//The big arrays come from the table allocator, which can back them with huge pages
+	store->tiles = (unsigned char*)allocate_table((size_t)store->capacity * store->packed_size);
+	store->g = (unsigned short*)allocate_table(sizeof(unsigned short) * store->capacity);
+	store->h = (unsigned char*)allocate_table(sizeof(unsigned char) * store->capacity);
+	store->parent = (unsigned int*)allocate_table(sizeof(unsigned int) * store->capacity);
+	store->flags = (unsigned char*)allocate_table(sizeof(unsigned char) * store->capacity);
+	store->packed = (unsigned char*)malloc(store->packed_size);
+
+	//Twice as many slots as nodes keeps the index at most half full
+	store->index_mask = (2ULL << bits) - 1;
+	store->index = (unsigned int*)allocate_table(sizeof(unsigned int) * (store->index_mask + 1));
+
+	store->open_count = 0;
+	store->open_capacity = 1u << bits;
+	store->open = (struct open_entry*)allocate_table(sizeof(struct open_entry) * store->open_capacity);
+
+	return store;
+}
+
+
+/**
+ * Free a node store and everything in it
+ */
+void destroy_node_store(struct node_store* store){
+	free_table(store->tiles, (size_t)store->capacity * store->packed_size);
+	free_table(store->g, sizeof(unsigned short) * store->capacity);
+	free_table(store->h, sizeof(unsigned char) * store->capacity);
+	free_table(store->parent, sizeof(unsigned int) * store->capacity);
+	free_table(store->flags, sizeof(unsigned char) * store->capacity);
+	free(store->packed);
+	free_table(store->index, sizeof(unsigned int) * (store->index_mask + 1));
+	free_table(store->open, sizeof(struct open_entry) * store->open_capacity);
+	free(store);
+}
+
+
+/**
+ * Find the node with the same tiles as a state. Returns its id, or NO_NODE if there isn't one
+ */
+unsigned int node_store_find(struct node_store* store, struct state* statePtr){
+	pack_state(statePtr, store->packed, store->N);
+
+	unsigned int entry = store->index[index_slot(store, store->packed)];
+
+	return entry == 0 ? NO_NODE : entry - 1;
+}
+
+
+/**
+ * Put a state into the store, reached from the node parent by move, with its current_travel and heuristic_cost already
+ * filled in. If the state is new, it becomes a new node and *is_new is set. If it is already there, its node only changes
+ * if the state's path is shorter, in which case it takes the new path and becomes unexpanded again. Returns the node's id
+ * if it is new or changed and so belongs in the open list, or NO_NODE if the state was no improvement
+ */
+unsigned int node_store_add(struct node_store* store, struct state* statePtr, unsigned int parent, int move, int* is_new){
+	pack_state(statePtr, store->packed, store->N);
+	unsigned long long slot = index_slot(store, store->packed);
+	unsigned int id;
+
+	*is_new = store->index[slot] == 0;
+
+	if(*is_new){
+		if(store->count == store->capacity){
+			grow_nodes(store);
+		}
+
+		id = store->count++;
+		memcpy(store->tiles + (size_t)id * store->packed_size, store->packed, store->packed_size);
+		store->index[slot] = id + 1;
+
+		//Keep the index at most half full
+		if((unsigned long long)store->count * 2 > store->index_mask + 1){
+			grow_index(store);
+		}
+	} else {
+		id = store->index[slot] - 1;
+
+		if(statePtr->current_travel >= store->g[id]){
+			return NO_NODE;
+		}
+	}
+
+	store->g[id] = statePtr->current_travel;
+	store->h[id] = statePtr->heuristic_cost > MAX_STORED_HEURISTIC ? MAX_STORED_HEURISTIC : statePtr->heuristic_cost;
+	store->parent[id] = parent;
+	store->flags[id] = move;
+
+	return id;
+}
+
+
+/**
+ * Unpack a node into a state that was set up with initialize_state. The state has no predecessor, and its total_cost is
+ * its unweighted g + h
+ */
+void node_store_load(struct node_store* store, unsigned int id, struct state* statePtr){
+	unpack_state(store->tiles + (size_t)id * store->packed_size, statePtr, store->N);
+
+	statePtr->current_travel = store->g[id];
+	statePtr->heuristic_cost = store->h[id];
+	statePtr->total_cost = statePtr->current_travel + statePtr->heuristic_cost;
+	statePtr->predecessor = NULL;
+	statePtr->next = NULL;
+}
+
+
+/**
+ * Turn the path from the start to a node back into states, linked through predecessor just like a search that never
+ * used the store would leave them. Returns the state for the node itself
+ * NOTE: the caller is responsible for freeing the states
+ */
+struct state* node_store_path(struct node_store* store, unsigned int id){
+	struct state* end = NULL;
+	struct state* previous = NULL;
+
+	//Build the states from the end back to the start, so each one is the predecessor of the one before it
+	for(; id != NO_NODE; id = store->parent[id]){
+		struct state* statePtr = (struct state*)malloc(sizeof(struct state));
+		initialize_state(statePtr, store->N);
+		node_store_load(store, id, statePtr);
+
+		if(previous == NULL){
+			end = statePtr;
+		} else {
+			previous->predecessor = statePtr;
+		}
+		previous = statePtr;
+	}
+
+	return end;
+}
+
+
+/**
+ * Whether open list entry a comes out before b. Entries with the same f go deepest first(lowest h), so that the last f
+ * layer, where every node ties, runs down toward the goal instead of fanning out across the whole layer
+ */
+static inline int open_entry_before(struct open_entry a, struct open_entry b){
+	return a.f < b.f || (a.f == b.f && a.h < b.h);
+}
+
+
+/**
+ * Put a node into the open list with priority f
+ */
+void open_list_push(struct node_store* store, int f, unsigned int id){
+	//Automatic resize
+	if(store->open_count == store->open_capacity){
+		store->open = (struct open_entry*)resize_table(store->open, sizeof(struct open_entry) * store->open_capacity,
+													  sizeof(struct open_entry) * store->open_capacity * 2);
+		store->open_capacity *= 2;
+	}
+
+	//Move parents down until the new entry's place is found, instead of swapping it up one level at a time
+	//The tie break is copied out of the node once, here, instead of on every compare
+	struct open_entry entry = {f, store->h[id], id};
+	unsigned int current_index = store->open_count++;
+	while(current_index > 0 && open_entry_before(entry, store->open[(current_index - 1) / 2])){
+		store->open[current_index] = store->open[(current_index - 1) / 2];
+		current_index = (current_index - 1) / 2;
+	}
+
+	store->open[current_index] = entry;
+}
+
+
+/**
+ * Take the entry with the lowest f out of the open list, the deepest of them if several tie
+ * NOTE: the open list must not be empty, must be checked by caller
+ */
+struct open_entry open_list_pop(struct node_store* store){
+	struct open_entry popped = store->open[0];
+	struct open_entry last = store->open[--store->open_count];
+
+	//Move the smaller child up until the last entry's place is found
+	unsigned int current_index = 0;
+	while(current_index * 2 + 1 < store->open_count){
+		unsigned int child = current_index * 2 + 1;
+		if(child + 1 < store->open_count && open_entry_before(store->open[child + 1], store->open[child])){
+			child++;
+		}
+
+		if(!open_entry_before(store->open[child], last)){
+			break;
+		}
+
+		store->open[current_index] = store->open[child];
+		current_index = child;
+	}
+	store->open[current_index] = last;
+
+	return popped;
+}
+
+
+/**
+ * Whether the open list is empty
+ */
+int open_list_empty(struct node_store* store){
+	return store->open_count == 0;
+}
+
+
+/**
+ * The entry that open_list_pop would give back next, without removing it
+ * NOTE: the open list must not be empty, must be checked by caller
+ */
+struct open_entry open_list_head(struct node_store* store){
+	return store->open[0];
+}
+
+
+/**
+ * How much memory the nodes, the index and the open list take up, in megabytes
+ */
+double node_store_megabytes(struct node_store* store){
+	size_t node_bytes = store->packed_size + sizeof(unsigned short) + sizeof(unsigned char) * 2 + sizeof(unsigned int);
+
+	return (node_bytes * store->capacity + sizeof(unsigned int) * (store->index_mask + 1)
+			+ sizeof(struct open_entry) * store->open_capacity) / 1048576.0;
+}
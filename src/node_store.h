@@ -0,0 +1,85 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the node store, which holds every state an A* search has generated in parallel arrays
+ * addressed by 32 bit node ids, along with the open list of (f, id) pairs that goes with it. The function prototypes
+ * are implemented in node_store.c
+ */
+
+
+#ifndef NODE_STORE_H
+#define NODE_STORE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "puzzle.h"
+
+
+//The node store starts out with room for 2^16 nodes, and doubles whenever it fills up
+#define DEFAULT_NODE_STORE_BITS 16
+//No node, used for the start state's parent and by node_store_find
+#define NO_NODE 0xFFFFFFFFu
+//The move(0 = left, 1 = right, 2 = down, 3 = up) that made the start state, which wasn't made by any move
+#define NO_MOVE 4
+//A node's flags hold the move that made it in the low bits, and whether it has been expanded in the high bit
+#define MOVE_MASK 0x07
+#define EXPANDED_FLAG 0x80
+//Heuristic values are kept in a byte. Anything bigger is stored as the largest byte, which is still admissable
+#define MAX_STORED_HEURISTIC 255
+
+
+/**
+ * An entry in the open list. The priority, and the node's stored heuristic that breaks ties in it, sit right in the
+ * heap, so sifting never has to look at the nodes. Both share one word, so an entry is still 8 bytes
+ */
+struct open_entry {
+	int f : 24;
+	unsigned int h : 8;
+	unsigned int id;
+};
+
+
+/**
+ * Every node that a search has generated, one array per field so that a node costs about 16 bytes for the 15-puzzle:
+ * 8 bytes of packed tiles, 2 of g, 1 of h, 4 of parent id and 1 of flags. A node's id is its index in every array.
+ * Nodes are found by their tiles through an open addressing index of ids, and a node that is reached again by a shorter
+ * path is updated in place and put into the open list a second time. The stale entry is skipped when it comes out,
+ * since by then the node has been expanded
+ */
+struct node_store {
+	//The size of the puzzle, and of a packed state
+	int N;
+	int packed_size;
+	//The fields of each node
+	unsigned char* tiles;
+	unsigned short* g;
+	unsigned char* h;
+	unsigned int* parent;
+	unsigned char* flags;
+	//How many nodes there are, and how many there is room for
+	unsigned int count, capacity;
+	//Where a state being looked up is packed
+	unsigned char* packed;
+	//The index holds node id + 1 in each slot, 0 means empty. It is kept at most half full
+	unsigned int* index;
+	unsigned long long index_mask;
+	//The open list, a binary min heap ordered by f
+	struct open_entry* open;
+	unsigned int open_count, open_capacity;
+};
+
+
+/* Method Protoypes */
+struct node_store* create_node_store(int, const int);
+void destroy_node_store(struct node_store*);
+unsigned int node_store_find(struct node_store*, struct state*);
+unsigned int node_store_add(struct node_store*, struct state*, unsigned int, int, int*);
+void node_store_load(struct node_store*, unsigned int, struct state*);
+struct state* node_store_path(struct node_store*, unsigned int);
+void open_list_push(struct node_store*, int, unsigned int);
+struct open_entry open_list_pop(struct node_store*);
+int open_list_empty(struct node_store*);
+struct open_entry open_list_head(struct node_store*);
+double node_store_megabytes(struct node_store*);
+void rebuild_node_store_index(struct node_store*);
+
+#endif /* NODE_STORE_H */
@@ -0,0 +1,39 @@
+/**
+ * Author: Jack Robbins
+ * This header file is the public interface of libnpuzzle, the library that every solver links against. It pulls
+ * in the state, fringe, closed and duplicate detection API from puzzle.h along with the heuristic API, so that a
+ * solver only needs this one include
+ */
+
+
+#ifndef NPUZZLE_H
+#define NPUZZLE_H
+
+//States, the fringe priority queue, closed and duplicate detection
+#include "puzzle.h"
+//Command line options shared by every solver
+#include "options.h"
+//The heuristic interface and its cache
+#include "heuristic.h"
+#include "heuristic_cache.h"
+//A set of states that many threads can share, for duplicate detection
+#include "concurrent_set.h"
+//Nodes kept in parallel arrays by id, with an open list of (f, id) pairs
+#include "node_store.h"
+//Optimal solutions kept on disk between runs
+#include "solution_cache.h"
+//Deadlines, node budgets and cancellation, shared by every solver
+#include "search_control.h"
+//Progress counters, and the thread that reports them
+#include "progress.h"
+//Huge page and NUMA aware memory for the big tables
+#include "table_memory.h"
+//Saving a search to a file and picking it back up later
+#include "checkpoint.h"
+//The individual heuristics, for solvers that want to use them directly
+#include "heuristic_kernels.h"
+#include "walking_distance.h"
+#include "pattern_database.h"
+#include "perimeter.h"
+
+#endif /* NPUZZLE_H */
@@ -0,0 +1,235 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in options.h. Every solver parses its optional flags
+ * through here, so that the same flag means the same thing everywhere
+ */
+
+//Link to options.h
+#include "options.h"
+#include "heuristic_cache.h"
+#include "solution_cache.h"
+#include "perimeter.h"
+#include "progress.h"
+#include "table_memory.h"
+#include "checkpoint.h"
+
+
+/**
+ * Fill in the default options. Each solver has its own default heuristic
+ */
+void default_solver_options(struct solver_options* options, const char* default_heuristic){
+	options->heuristic = default_heuristic;
+	options->cache_bits = DEFAULT_CACHE_BITS;
+	options->pattern_database = NULL;
+	options->work_directory = ".";
+	options->memory_limit = 256;
+	options->weight = 1.0;
+	options->deadline = 0;
+	options->node_limit = 0;
+	options->batch = 1;
+	options->threads = 0;
+	options->perimeter = 0;
+	options->solution_cache = NULL;
+	options->solution_cache_size = DEFAULT_SOLUTION_CACHE_SIZE;
+	options->progress_interval = DEFAULT_PROGRESS_INTERVAL;
+	options->progress_file = NULL;
+	options->progress_json = 0;
+	options->huge_pages = HUGE_PAGES_NONE;
+	options->numa = 0;
+	options->checkpoint = NULL;
+	options->checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL;
+	options->resume = NULL;
+	options->workers = 0;
+	options->listen = NULL;
+	options->join = NULL;
+	options->goal = NULL;
+}
+
+
+/**
+ * Parse every optional flag at the front of the program arguments. Parsing stops at the first argument that
+ * is not a flag, which should be <N>. Returns the number of arguments consumed, or -1 if a flag is unknown or
+ * malformed, in which case an error has already been printed
+ */
+int parse_solver_options(int argc, char** argv, struct solver_options* options){
+	//argv[0] is the program name
+	int index = 1;
+
+	while(index < argc && strncmp(argv[index], "--", 2) == 0){
+		//Every flag needs a value
+		if(index + 1 >= argc){
+			printf("Option %s needs a value.\n\n", argv[index]);
+			return -1;
+		}
+
+		char* flag = argv[index];
+		char* value = argv[index + 1];
+
+		if(strcmp(flag, "--heuristic") == 0){
+			options->heuristic = value;
+		} else if(strcmp(flag, "--cache-bits") == 0){
+			//Anything more than 2^34 entries(128 GB) is certainly a mistake
+			if(sscanf(value, "%d", &options->cache_bits) != 1 || options->cache_bits < 0 || options->cache_bits > 34){
+				printf("Incorrect cache size %s, must be between 0 and 34.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--pattern-db") == 0){
+			options->pattern_database = value;
+		} else if(strcmp(flag, "--weight") == 0){
+			//Weights under 1 would only make the search slower, with no better guarantee
+			if(sscanf(value, "%lf", &options->weight) != 1 || options->weight < 1.0 || options->weight > 100.0){
+				printf("Incorrect weight %s, must be between 1 and 100.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--deadline") == 0){
+			if(sscanf(value, "%ld", &options->deadline) != 1 || options->deadline < 0){
+				printf("Incorrect deadline %s, must be a number of milliseconds.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--node-limit") == 0){
+			if(sscanf(value, "%ld", &options->node_limit) != 1 || options->node_limit < 0){
+				printf("Incorrect node limit %s, must be a number of states.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--batch") == 0){
+			if(sscanf(value, "%d", &options->batch) != 1 || options->batch < 1 || options->batch > MAX_BATCH){
+				printf("Incorrect batch size %s, must be between 1 and %d.\n\n", value, MAX_BATCH);
+				return -1;
+			}
+		} else if(strcmp(flag, "--threads") == 0){
+			if(sscanf(value, "%d", &options->threads) != 1 || options->threads < 0 || options->threads > MAX_THREADS){
+				printf("Incorrect thread count %s, must be between 0 and %d.\n\n", value, MAX_THREADS);
+				return -1;
+			}
+		} else if(strcmp(flag, "--perimeter") == 0){
+			if(sscanf(value, "%d", &options->perimeter) != 1 || options->perimeter < 0 || options->perimeter > MAX_PERIMETER_DEPTH){
+				printf("Incorrect perimeter depth %s, must be between 0 and %d.\n\n", value, MAX_PERIMETER_DEPTH);
+				return -1;
+			}
+		} else if(strcmp(flag, "--solution-cache") == 0){
+			options->solution_cache = value;
+		} else if(strcmp(flag, "--solution-cache-size") == 0){
+			if(sscanf(value, "%ld", &options->solution_cache_size) != 1 || options->solution_cache_size < 1){
+				printf("Incorrect solution cache size %s, must be a positive number of megabytes.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--progress") == 0){
+			if(sscanf(value, "%ld", &options->progress_interval) != 1 || options->progress_interval < 0){
+				printf("Incorrect progress interval %s, must be a number of milliseconds.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--progress-file") == 0){
+			options->progress_file = value;
+		} else if(strcmp(flag, "--progress-format") == 0){
+			if(strcmp(value, "text") != 0 && strcmp(value, "json") != 0){
+				printf("Incorrect progress format %s, must be text or json.\n\n", value);
+				return -1;
+			}
+			options->progress_json = strcmp(value, "json") == 0;
+		} else if(strcmp(flag, "--huge-pages") == 0){
+			if(strcmp(value, "none") == 0){
+				options->huge_pages = HUGE_PAGES_NONE;
+			} else if(strcmp(value, "thp") == 0){
+				options->huge_pages = HUGE_PAGES_THP;
+			} else if(strcmp(value, "hugetlb") == 0){
+				options->huge_pages = HUGE_PAGES_HUGETLB;
+			} else {
+				printf("Incorrect huge page mode %s, must be none, thp or hugetlb.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--numa") == 0){
+			if(strcmp(value, "on") != 0 && strcmp(value, "off") != 0){
+				printf("Incorrect NUMA setting %s, must be on or off.\n\n", value);
+				return -1;
+			}
+			options->numa = strcmp(value, "on") == 0;
+		} else if(strcmp(flag, "--checkpoint") == 0){
+			options->checkpoint = value;
+		} else if(strcmp(flag, "--checkpoint-interval") == 0){
+			if(sscanf(value, "%ld", &options->checkpoint_interval) != 1 || options->checkpoint_interval < 1){
+				printf("Incorrect checkpoint interval %s, must be a positive number of milliseconds.\n\n", value);
+				return -1;
+			}
+		} else if(strcmp(flag, "--resume") == 0){
+			options->resume = value;
+		} else if(strcmp(flag, "--workers") == 0){
+			if(sscanf(value, "%d", &options->workers) != 1 || options->workers < 0 || options->workers > MAX_WORKERS){
+				printf("Incorrect worker count %s, must be between 0 and %d.\n\n", value, MAX_WORKERS);
+				return -1;
+			}
+		} else if(strcmp(flag, "--listen") == 0){
+			options->listen = value;
+		} else if(strcmp(flag, "--join") == 0){
+			options->join = value;
+		} else if(strcmp(flag, "--goal") == 0){
+			//Checked against N once N is known, in initialize_start_goal
+			options->goal = value;
+		} else if(strcmp(flag, "--dir") == 0){
+			options->work_directory = value;
+		} else if(strcmp(flag, "--memory") == 0){
+			//We need at least a little room for sorting
+			if(sscanf(value, "%ld", &options->memory_limit) != 1 || options->memory_limit < 1){
+				printf("Incorrect memory limit %s, must be a positive number of megabytes.\n\n", value);
+				return -1;
+			}
+		} else {
+			printf("Unknown option %s.\n\n", flag);
+			return -1;
+		}
+
+		index += 2;
+	}
+
+	//We don't count the program name
+	return index - 1;
+}
+
+
+/**
+ * Print out a description of every option, for the solvers' usage messages
+ */
+void print_solver_options_usage(){
+	printf("Options:\n");
+	printf("  --heuristic <h>     Heuristic to use. <h> is one of md, lc, wd or pdb, and they can be combined: a+b adds\n");
+	printf("                      two heuristics, a,b takes the maximum of them. + binds tighter than ,. Adding overlapping\n");
+	printf("                      heuristics can overestimate, so solutions found with a + aren't called optimal\n");
+	printf("  --cache-bits <b>    The heuristic cache has 2^<b> entries, 0 turns it off\n");
+	printf("  --pattern-db <file> Pattern database file for the pdb heuristic, default pattern_databases/<N>.patterndb\n");
+	printf("  --weight <w>        Order states by g + w*h, finding a solution at most w times longer than optimal, default 1\n");
+	printf("  --deadline <ms>     Stop searching after this long and report the best bound and path so far, default none\n");
+	printf("  --node-limit <n>    Stop searching after expanding about this many states, default none\n");
+	printf("  --batch <k>         Expand up to k states with(nearly) the lowest cost at once in solve, default 1\n");
+	printf("  --threads <t>       Worker threads for solve_parallel_ida, default 0 for one per core\n");
+	printf("  --perimeter <d>     solve knows the exact distance of every state within d moves of the goal, default 0\n");
+	printf("  --solution-cache <file>\n");
+	printf("                      File that solve keeps optimal solutions in across runs, default none\n");
+	printf("  --solution-cache-size <MB>\n");
+	printf("                      Size of a new solution cache file, default %d\n", DEFAULT_SOLUTION_CACHE_SIZE);
+	printf("  --progress <ms>     How often solve, solve_multi_threaded, solve_bidirectional and solve_pattern_db report\n");
+	printf("                      their progress, 0 turns it off, default %d\n", DEFAULT_PROGRESS_INTERVAL);
+	printf("  --progress-file <file>\n");
+	printf("                      Where progress reports go, default stderr\n");
+	printf("  --progress-format <text|json>\n");
+	printf("                      One line of text or one JSON object per report, default text\n");
+	printf("  --huge-pages <none|thp|hugetlb>\n");
+	printf("                      Back the node store, the caches, the perimeter and the pattern database with 2 MB pages,\n");
+	printf("                      transparent ones or reserved ones(falling back to transparent), default none\n");
+	printf("  --numa <on|off>     Pin the worker threads of solve_parallel_ida and solve_server to NUMA nodes, give each\n");
+	printf("                      node its own copy of the pattern database and interleave shared tables, default off\n");
+	printf("  --checkpoint <file> Where solve saves its whole search, every --checkpoint-interval and when it is stopped,\n");
+	printf("                      default none\n");
+	printf("  --checkpoint-interval <ms>\n");
+	printf("                      How often solve saves a checkpoint, default %d\n", DEFAULT_CHECKPOINT_INTERVAL);
+	printf("  --resume <file>     Pick a search back up from a checkpoint that solve saved, with the same puzzle, heuristic,\n");
+	printf("                      weight and perimeter, default none\n");
+	printf("  --workers <k>       Worker processes for solve_distributed, default 0 for one per core\n");
+	printf("  --listen <address>  Where solve_distributed waits for --workers workers to join it, instead of starting them\n");
+	printf("                      itself. A path is a Unix socket, and host:port is TCP, default none\n");
+	printf("  --join <address>    Run as a worker for the solve_distributed coordinator at this address, default none\n");
+	printf("  --goal <tiles>      The goal to solve for, its tiles in row-major order split by commas, like 0,1,2,3,4,5,6,7,8.\n");
+	printf("                      With the blank away from the corners only md and lc work, default the blank last and the\n");
+	printf("                      tiles in order\n");
+	printf("  --dir <directory>   Where solve_external keeps its layer files, default .\n");
+	printf("  --memory <MB>       How much memory solve_external uses to sort states before writing them, and the most that\n");
+	printf("                      the perimeter may take up, default 256\n\n");
+}
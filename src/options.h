@@ -0,0 +1,83 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the command line options that are shared by every solver, and the function
+ * prototypes for parsing them that are implemented in options.c
+ */
+
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+
+//The most states that can be expanded in one batch
+#define MAX_BATCH 256
+//The most worker threads that a parallel solver can be given
+#define MAX_THREADS 1024
+//The most worker processes that the distributed solver can be given
+#define MAX_WORKERS 64
+
+
+/**
+ * Every option that a solver can be given before <N>. Each option is a flag followed by exactly one value
+ */
+struct solver_options {
+	//The heuristic specification, see heuristic.c
+	const char* heuristic;
+	//The heuristic cache has 2^cache_bits entries, 0 turns it off
+	int cache_bits;
+	//The pattern database file for the pdb heuristic, NULL means use the default for N
+	const char* pattern_database;
+	//Where the external memory solver keeps its files
+	const char* work_directory;
+	//How many megabytes of memory the external memory solver may use for buffering, and the perimeter may take up
+	long memory_limit;
+	//Weighted A* orders states by g + weight * h, 1 is plain A*
+	double weight;
+	//How many milliseconds a solver may run for, 0 means until it is done
+	long deadline;
+	//How many states a solver may expand, 0 means no limit
+	long node_limit;
+	//How many states solve expands at once, 1 expands them one at a time
+	int batch;
+	//How many worker threads the parallel solvers use, 0 means one per core
+	int threads;
+	//How far from the goal the perimeter that solve uses reaches, 0 turns it off
+	int perimeter;
+	//The file that solve keeps optimal solutions in between runs, NULL turns it off
+	const char* solution_cache;
+	//How many megabytes a new solution cache file takes up
+	long solution_cache_size;
+	//How many milliseconds go by between progress reports, 0 turns them off
+	long progress_interval;
+	//Where progress reports go, NULL means stderr, and whether they are JSON lines instead of text
+	const char* progress_file;
+	int progress_json;
+	//What backs the big tables, one of the HUGE_PAGES_* modes in table_memory.h
+	int huge_pages;
+	//Whether threads are pinned to NUMA nodes, with the tables placed to match
+	int numa;
+	//Where solve saves its search every checkpoint_interval milliseconds, NULL turns it off
+	const char* checkpoint;
+	long checkpoint_interval;
+	//A checkpoint for solve to pick the search back up from, NULL starts a new search
+	const char* resume;
+	//How many worker processes the distributed solver uses, 0 means one per core
+	int workers;
+	//Where the distributed solver's coordinator waits for workers, and the coordinator that a worker joins, NULL if none
+	const char* listen;
+	const char* join;
+	//The goal configuration, its tiles in row-major order split by commas, NULL means the standard goal
+	const char* goal;
+};
+
+
+/* Method Protoypes */
+void default_solver_options(struct solver_options*, const char*);
+int parse_solver_options(int, char**, struct solver_options*);
+void print_solver_options_usage(void);
+
+#endif /* OPTIONS_H */
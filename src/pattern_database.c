@@ -0,0 +1,352 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementation of the disjoint pattern database heuristic, as described in pattern_database.h
+ *
+ * The database file is made by generate_pattern_db. Every line is "<pattern type> <cost> <positions...>". Pattern type 0
+ * is the first half of the tiles(1 to N^2/2), and pattern type 1 is the rest of the tiles. The positions are the row-major
+ * positions of each tile in the pattern, in tile order. The cost of a state is the sum of the costs of its two patterns,
+ * where a pattern that isn't in the database costs 0
+ */
+
+//Link to pattern_database.h
+#include "pattern_database.h"
+#include "table_memory.h"
+#include <stdatomic.h>
+
+
+/**
+ * All of the patterns of one type, stored back to back, with an open addressing index so that a lookup is a hash
+ * probe instead of a walk over every pattern
+ */
+struct pattern_table{
+	//How many tiles are in each pattern
+	int pattern_length;
+	//The patterns themselves, pattern_length positions each
+	unsigned char* patterns;
+	//The cost of each pattern
+	int* costs;
+	int num_patterns, max_patterns;
+	//The index holds pattern number + 1, 0 means empty
+	int* index;
+	int index_size;
+};
+
+
+/*================================= Global variables for convenience =========================== */
+//The first half and last half pattern tables
+struct pattern_table pattern_tables[2];
+//A copy of both tables on each NUMA node, NULL where there is none, and the tables that this thread looks patterns up in
+struct pattern_table* replicas[MAX_NUMA_NODES];
+_Thread_local struct pattern_table* local_tables = pattern_tables;
+//Keep track of our database hit rate
+atomic_long num_database_hits;
+/*============================================================================================== */
+
+
+/**
+ * A simple FNV-1a hash over the positions in a pattern
+ */
+static unsigned int hash_pattern(const unsigned char* pattern, int length){
+	unsigned int hash = 2166136261U;
+
+	for(int i = 0; i < length; i++){
+		hash ^= pattern[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+
+/**
+ * Find the index slot that holds the given pattern, or the empty slot where it belongs
+ */
+static int index_slot(struct pattern_table* table, const unsigned char* pattern){
+	int mask = table->index_size - 1;
+	int slot = hash_pattern(pattern, table->pattern_length) & mask;
+
+	//Linear probing
+	while(table->index[slot] != 0
+		  && memcmp(table->patterns + (table->index[slot] - 1) * table->pattern_length, pattern, table->pattern_length) != 0){
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+
+/**
+ * Rebuild the index of a table with double the size
+ */
+static void grow_index(struct pattern_table* table){
+	free_table(table->index, sizeof(int) * table->index_size);
+	table->index_size *= 2;
+	table->index = (int*)allocate_table(sizeof(int) * table->index_size);
+
+	for(int i = 0; i < table->num_patterns; i++){
+		table->index[index_slot(table, table->patterns + i * table->pattern_length)] = i + 1;
+	}
+}
+
+
+/**
+ * Add a pattern to a table. If the pattern is already there, we keep the lower cost
+ */
+static void add_pattern(struct pattern_table* table, const unsigned char* pattern, int cost){
+	int slot = index_slot(table, pattern);
+
+	//Repeat pattern, keep the lower cost
+	if(table->index[slot] != 0){
+		if(cost < table->costs[table->index[slot] - 1]){
+			table->costs[table->index[slot] - 1] = cost;
+		}
+		return;
+	}
+
+	//Grow the storage as needed
+	if(table->num_patterns == table->max_patterns){
+		table->patterns = (unsigned char*)resize_table(table->patterns, (size_t)table->max_patterns * table->pattern_length,
+													   (size_t)table->max_patterns * 2 * table->pattern_length);
+		table->costs = (int*)resize_table(table->costs, sizeof(int) * table->max_patterns, sizeof(int) * table->max_patterns * 2);
+		table->max_patterns *= 2;
+	}
+
+	memcpy(table->patterns + table->num_patterns * table->pattern_length, pattern, table->pattern_length);
+	table->costs[table->num_patterns] = cost;
+	table->num_patterns++;
+	table->index[slot] = table->num_patterns;
+
+	//Keep the index at most half full
+	if(table->num_patterns * 2 > table->index_size){
+		grow_index(table);
+	}
+}
+
+
+/**
+ * Read the entire pattern database file into memory. Returns 0 on success, or -1 if the file can't be read
+ */
+int initialize_pattern_database(const char* filename, const int N){
+	//Positions are stored in a byte
+	if(N * N > 256){
+		printf("ERROR. Pattern databases only support puzzles up to 16x16.\n");
+		return -1;
+	}
+
+	FILE* database = fopen(filename, "r");
+
+	//If we failed at opening the file, let the user know
+	if(database == NULL){
+		printf("ERROR. Pattern database %s not found.\n", filename);
+		return -1;
+	}
+
+	//The first half has the first N^2/2 tiles, the last half has every other tile except 0
+	pattern_tables[0].pattern_length = N * N / 2;
+	pattern_tables[1].pattern_length = N * N - 1 - N * N / 2;
+
+	for(int type = 0; type < 2; type++){
+		pattern_tables[type].num_patterns = 0;
+		pattern_tables[type].max_patterns = 1024;
+		pattern_tables[type].patterns = (unsigned char*)allocate_table(pattern_tables[type].max_patterns * pattern_tables[type].pattern_length);
+		pattern_tables[type].costs = (int*)allocate_table(sizeof(int) * pattern_tables[type].max_patterns);
+		pattern_tables[type].index_size = 2048;
+		pattern_tables[type].index = (int*)allocate_table(sizeof(int) * pattern_tables[type].index_size);
+	}
+
+	atomic_init(&num_database_hits, 0);
+
+	//Declare lines, tokens and buffer sizes for line reading
+	char line[1000];
+	char* token;
+	unsigned char pattern[N * N];
+	int num_patterns_loaded = 0;
+
+	//Grab each line in the file
+	while(fgets(line, sizeof(line), database) != NULL){
+		int pattern_type, cost, position;
+
+		//The first integer is always the pattern type, followed by the cost
+		token = strtok(line, " ");
+		if(token == NULL || sscanf(token, "%d", &pattern_type) != 1 || (pattern_type != 0 && pattern_type != 1)){
+			continue;
+		}
+
+		token = strtok(NULL, " ");
+		if(token == NULL || sscanf(token, "%d", &cost) != 1){
+			continue;
+		}
+
+		//Now we read in the pattern int by int
+		struct pattern_table* table = &pattern_tables[pattern_type];
+		int i;
+		for(i = 0; i < table->pattern_length; i++){
+			token = strtok(NULL, " ");
+			if(token == NULL || sscanf(token, "%d", &position) != 1){
+				break;
+			}
+			pattern[i] = position;
+		}
+
+		//Skip any line that was cut short
+		if(i < table->pattern_length){
+			continue;
+		}
+
+		add_pattern(table, pattern, cost);
+		num_patterns_loaded++;
+	}
+
+	fclose(database);
+
+	printf("\nSuccessfully loaded %d patterns into memory\n", num_patterns_loaded);
+	return 0;
+}
+
+
+/**
+ * Free all of the memory held by the pattern database
+ */
+void destroy_pattern_database(){
+	for(int node = 0; node < MAX_NUMA_NODES; node++){
+		if(replicas[node] == NULL){
+			continue;
+		}
+
+		for(int type = 0; type < 2; type++){
+			free_table_on_node(replicas[node][type].patterns, (size_t)replicas[node][type].num_patterns * replicas[node][type].pattern_length);
+			free_table_on_node(replicas[node][type].costs, sizeof(int) * replicas[node][type].num_patterns);
+			free_table_on_node(replicas[node][type].index, sizeof(int) * replicas[node][type].index_size);
+		}
+		free(replicas[node]);
+		replicas[node] = NULL;
+	}
+	local_tables = pattern_tables;
+
+	for(int type = 0; type < 2; type++){
+		free_table(pattern_tables[type].patterns, (size_t)pattern_tables[type].max_patterns * pattern_tables[type].pattern_length);
+		free_table(pattern_tables[type].costs, sizeof(int) * pattern_tables[type].max_patterns);
+		free_table(pattern_tables[type].index, sizeof(int) * pattern_tables[type].index_size);
+	}
+}
+
+
+/**
+ * Copy both tables onto every NUMA node, so that a thread pinned to a node never reaches across to another node's
+ * memory for a lookup. The database is read only once it's loaded, so the copies never have to be kept in step. A
+ * machine with one node gets no copies, since the tables are already local. Returns how many copies were made
+ */
+int replicate_pattern_database(){
+	int num_nodes = numa_node_count();
+
+	if(num_nodes < 2){
+		return 0;
+	}
+
+	for(int node = 0; node < num_nodes; node++){
+		replicas[node] = (struct pattern_table*)malloc(sizeof(struct pattern_table) * 2);
+
+		for(int type = 0; type < 2; type++){
+			struct pattern_table* original = &pattern_tables[type];
+			struct pattern_table* replica = &replicas[node][type];
+			size_t pattern_bytes = (size_t)original->num_patterns * original->pattern_length;
+
+			//Only what's in use is copied, so the copy is exactly full
+			*replica = *original;
+			replica->max_patterns = original->num_patterns;
+			replica->patterns = (unsigned char*)allocate_table_on_node(pattern_bytes, node);
+			replica->costs = (int*)allocate_table_on_node(sizeof(int) * original->num_patterns, node);
+			replica->index = (int*)allocate_table_on_node(sizeof(int) * original->index_size, node);
+
+			memcpy(replica->patterns, original->patterns, pattern_bytes);
+			memcpy(replica->costs, original->costs, sizeof(int) * original->num_patterns);
+			memcpy(replica->index, original->index, sizeof(int) * original->index_size);
+		}
+	}
+
+	return num_nodes;
+}
+
+
+/**
+ * Make the calling thread look patterns up in the copy on the node'th NUMA node, if there is one
+ */
+void use_pattern_database_replica(int node){
+	if(node < MAX_NUMA_NODES && replicas[node] != NULL){
+		local_tables = replicas[node];
+	}
+}
+
+
+/**
+ * Record the position of every tile in the appropriate pattern
+ */
+static void split_patterns(struct state* statePtr, unsigned char* first_half, unsigned char* last_half, const int N){
+	int half = N * N / 2;
+	short tile;
+
+	for(int i = 0; i < N * N; i++){
+		tile = statePtr->tiles[i];
+
+		if(tile == 0){
+			continue;
+		}
+
+		if(tile <= half){
+			first_half[tile - 1] = i;
+		} else {
+			last_half[tile - half - 1] = i;
+		}
+	}
+}
+
+
+/**
+ * Start loading the index slots where the state's two patterns would be into the CPU cache, so that looking up a
+ * whole batch of states doesn't wait on memory for each one in turn
+ */
+void pattern_database_prefetch(struct state* statePtr, const int N){
+	unsigned char first_half[N * N], last_half[N * N];
+	unsigned char* patterns[2] = {first_half, last_half};
+
+	split_patterns(statePtr, first_half, last_half, N);
+
+	for(int type = 0; type < 2; type++){
+		int slot = hash_pattern(patterns[type], local_tables[type].pattern_length) & (local_tables[type].index_size - 1);
+		__builtin_prefetch(&local_tables[type].index[slot], 0, 1);
+	}
+}
+
+
+/**
+ * Translate the state into its two patterns, and return the sum of their costs from the database
+ */
+int pattern_database_cost(struct state* statePtr, const int N){
+	//The patterns live on the stack, so there is nothing to free
+	unsigned char first_half[N * N], last_half[N * N];
+
+	split_patterns(statePtr, first_half, last_half, N);
+
+	int database_cost = 0;
+	unsigned char* patterns[2] = {first_half, last_half};
+
+	//A pattern that isn't in the database costs nothing
+	for(int type = 0; type < 2; type++){
+		int slot = index_slot(&local_tables[type], patterns[type]);
+
+		if(local_tables[type].index[slot] != 0){
+			atomic_fetch_add_explicit(&num_database_hits, 1, memory_order_relaxed);
+			database_cost += local_tables[type].costs[local_tables[type].index[slot] - 1];
+		}
+	}
+
+	return database_cost;
+}
+
+
+/**
+ * How many database lookups found their pattern
+ */
+long pattern_database_hits(){
+	return atomic_load(&num_database_hits);
+}
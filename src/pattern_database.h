@@ -0,0 +1,23 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the function prototypes for the disjoint pattern database heuristic, which are
+ * implemented in pattern_database.c
+ */
+
+
+#ifndef PATTERN_DATABASE_H
+#define PATTERN_DATABASE_H
+
+#include "puzzle.h"
+
+
+/* Method Protoypes */
+int initialize_pattern_database(const char*, const int);
+void destroy_pattern_database(void);
+int pattern_database_cost(struct state*, const int);
+void pattern_database_prefetch(struct state*, const int);
+long pattern_database_hits(void);
+int replicate_pattern_database(void);
+void use_pattern_database_replica(int);
+
+#endif /* PATTERN_DATABASE_H */
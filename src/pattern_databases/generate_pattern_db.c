@@ -219,8 +219,8 @@ int store_pattern(struct pattern_cost* patternPtr){
 		}
 	}
 
-	//Iterate through the entire linked list
-	while(cursor->next != NULL){
+	//Iterate through the entire linked list, tail included
+	while(cursor != NULL){
 		//If we have the same pattern, we've created a duplicate, which we don't want to store
 		if(patterns_same(patternPtr->pattern, cursor->pattern, patternPtr->pattern_length)){
 			//It is possible that we've found a lower cost version of this pattern
@@ -239,6 +239,11 @@ int store_pattern(struct pattern_cost* patternPtr){
 			return 1;
 		}
 	
+		//Stop on the tail, which is where patternPtr goes if it's new
+		if(cursor->next == NULL){
+			break;
+		}
+
 		//Iterate over linked list
 		cursor = cursor->next;
 	}
@@ -365,6 +370,8 @@ void* generator_worker(void* thread_params){
 		pc->cost = 0;
 		//Set the pattern type appropriately
 		pc->pattern_type = pattern_type;
+		//It isn't in any list yet. A pattern that becomes the head of a list is never given a next otherwise
+		pc->next = NULL;
 
 		//Store the value of the tile that was moved
 		int moved_tile = 0;
@@ -466,8 +473,8 @@ void generate_patterns(int max_moves){
 	 */
 
 	//Create the thread params structure
-	struct thread_params* parameters1 = malloc(sizeof(struct thread_params*));
-	struct thread_params* parameters2 = malloc(sizeof(struct thread_params*));
+	struct thread_params* parameters1 = malloc(sizeof(struct thread_params));
+	struct thread_params* parameters2 = malloc(sizeof(struct thread_params));
 
 	//Initialize max moves and pattern type for both thread_params
 	parameters1->max_moves = max_moves;
@@ -556,7 +563,7 @@ int main(int argc, char** argv){
 	}
 
 	//Filename is always of format "N.patterndb"
-	char db_filename[13];
+	char db_filename[32];
 
 	//Save the filename into a string
 	sprintf(db_filename, "%d.patterndb", N);
@@ -0,0 +1,313 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in perimeter.h. The perimeter is every state within a few
+ * moves of the goal, found by a breadth first search backwards from the goal, along with its exact distance. A search
+ * that reaches the perimeter knows the rest of the way to the goal without searching it, and every state outside of
+ * the perimeter is known to be more than depth moves away.
+ *
+ * The breadth first search keeps each level as a sorted array of packed states. A move always changes the parity of
+ * the 0 slider's position, so the neighbors of a state on level k can only be on levels k - 1 and k + 1, and only the
+ * level before needs to be checked for duplicates. Once built, the perimeter is saved so that it's only built once for
+ * each N and depth
+ */
+
+//Link to perimeter.h
+#include "perimeter.h"
+#include "table_memory.h"
+
+
+//Identifies a perimeter file
+#define PERIMETER_MAGIC "NPPERIM1"
+
+
+/*================================= Global variables for convenience =========================== */
+//The size of the packed states being sorted, since qsort can't pass it along
+static int sort_packed_size;
+/*============================================================================================== */
+
+
+/**
+ * Order packed states by their bytes, for qsort and bsearch
+ */
+static int compare_packed(const void* a, const void* b){
+	return memcmp(a, b, sort_packed_size);
+}
+
+
+/**
+ * How many slots the table needs for count states, keeping it at most half full
+ */
+static unsigned long long table_slots(long count){
+	unsigned long long slots = 1;
+
+	while(slots < 2 * (unsigned long long)count){
+		slots *= 2;
+	}
+
+	return slots;
+}
+
+
+/**
+ * How many bytes a table for count states takes
+ */
+static double table_bytes(long count, int packed_size){
+	return (double)table_slots(count) * (sizeof(unsigned long long) + packed_size + 1);
+}
+
+
+/**
+ * Put a packed state and its distance into the table
+ */
+static void table_insert(struct perimeter* perimeter, const unsigned char* packed, int distance, struct state* scratch){
+	unpack_state(packed, scratch, perimeter->N);
+	unsigned long long key = scratch->zobrist_key | 1;
+	unsigned long long slot = key & perimeter->mask;
+
+	//Linear probing, the table never fills up
+	while(perimeter->keys[slot] != 0){
+		slot = (slot + 1) & perimeter->mask;
+	}
+
+	perimeter->keys[slot] = key;
+	memcpy(perimeter->states + slot * perimeter->packed_size, packed, perimeter->packed_size);
+	perimeter->distances[slot] = distance;
+}
+
+
+/**
+ * Make the table out of every level of the breadth first search
+ */
+static struct perimeter* create_perimeter(unsigned char** levels, long* level_counts, int depth, const int N){
+	struct perimeter* perimeter = (struct perimeter*)malloc(sizeof(struct perimeter));
+	struct state scratch;
+	initialize_state(&scratch, N);
+
+	perimeter->N = N;
+	perimeter->packed_size = packed_state_size(N);
+	perimeter->depth = depth;
+	perimeter->count = 0;
+	for(int level = 0; level <= depth; level++){
+		perimeter->count += level_counts[level];
+	}
+
+	unsigned long long slots = table_slots(perimeter->count);
+	perimeter->mask = slots - 1;
+	perimeter->keys = (unsigned long long*)allocate_table(slots * sizeof(unsigned long long));
+	perimeter->states = (unsigned char*)allocate_table(slots * perimeter->packed_size);
+	perimeter->distances = (unsigned char*)allocate_table(slots);
+
+	for(int level = 0; level <= depth; level++){
+		for(long i = 0; i < level_counts[level]; i++){
+			table_insert(perimeter, levels[level] + i * perimeter->packed_size, level, &scratch);
+		}
+	}
+
+	destroy_state(&scratch);
+	return perimeter;
+}
+
+
+/**
+ * Search breadth first from the goal, one level at a time, until depth or until the next level would make the table
+ * take more than memory_limit megabytes. Each level is left sorted in levels, and the depth reached is returned
+ */
+static int build_levels(unsigned char** levels, long* level_counts, int depth, long memory_limit, const int N){
+	int packed_size = packed_state_size(N);
+	long total = 1;
+	struct state current, moved;
+	initialize_state(&current, N);
+	initialize_state(&moved, N);
+
+	//The goal is 1, 2, ..., 0
+	for(int i = 0; i < N * N; i++){
+		current.tiles[i] = (i + 1) % (N * N);
+	}
+	current.zero_row = current.zero_column = N - 1;
+	levels[0] = (unsigned char*)malloc(packed_size);
+	level_counts[0] = 1;
+	pack_state(&current, levels[0], N);
+
+	sort_packed_size = packed_size;
+
+	for(int level = 0; level < depth; level++){
+		//Every neighbor of this level
+		unsigned char* next = (unsigned char*)malloc((size_t)level_counts[level] * 4 * packed_size);
+		long count = 0;
+
+		for(long i = 0; i < level_counts[level]; i++){
+			unpack_state(levels[level] + i * packed_size, &current, N);
+
+			for(int move = 0; move < 4; move++){
+				//Skip the moves that would push the 0 slider off of the board
+				if((move == 0 && current.zero_column == 0) || (move == 1 && current.zero_column == N - 1)
+				   || (move == 2 && current.zero_row == N - 1) || (move == 3 && current.zero_row == 0)){
+					continue;
+				}
+
+				copy_state(&current, &moved, N);
+				if(move == 0){
+					move_left(&moved, N);
+				} else if(move == 1){
+					move_right(&moved, N);
+				} else if(move == 2){
+					move_down(&moved, N);
+				} else {
+					move_up(&moved, N);
+				}
+				pack_state(&moved, next + count * packed_size, N);
+				count++;
+			}
+		}
+
+		//Sort, then keep one of each state that isn't on the level before
+		qsort(next, count, packed_size, compare_packed);
+		long unique = 0;
+		for(long i = 0; i < count; i++){
+			unsigned char* candidate = next + i * packed_size;
+
+			if(unique > 0 && memcmp(next + (unique - 1) * packed_size, candidate, packed_size) == 0){
+				continue;
+			}
+			if(level > 0 && bsearch(candidate, levels[level - 1], level_counts[level - 1], packed_size, compare_packed) != NULL){
+				continue;
+			}
+
+			memmove(next + unique * packed_size, candidate, packed_size);
+			unique++;
+		}
+
+		//Stop at the last level that fits
+		if(table_bytes(total + unique, packed_size) > memory_limit * 1048576.0){
+			printf("The perimeter only fits in %ld MB up to depth %d.\n", memory_limit, level);
+			free(next);
+			depth = level;
+			break;
+		}
+
+		levels[level + 1] = (unsigned char*)realloc(next, unique * packed_size);
+		level_counts[level + 1] = unique;
+		total += unique;
+	}
+
+	destroy_state(&current);
+	destroy_state(&moved);
+	return depth;
+}
+
+
+/**
+ * Load the perimeter for NxN puzzles from filename. If the file isn't there, build a perimeter of the given depth,
+ * cutting it back if it wouldn't fit in memory_limit megabytes, and save it to filename for next time. Returns NULL
+ * if the perimeter can't be built
+ */
+struct perimeter* load_perimeter(const char* filename, int depth, long memory_limit, const int N){
+	int packed_size = packed_state_size(N);
+	unsigned char* levels[MAX_PERIMETER_DEPTH + 1];
+	long level_counts[MAX_PERIMETER_DEPTH + 1];
+
+	if(depth < 1 || depth > MAX_PERIMETER_DEPTH){
+		printf("ERROR. The perimeter depth must be between 1 and %d.\n", MAX_PERIMETER_DEPTH);
+		return NULL;
+	}
+
+	FILE* file = fopen(filename, "rb");
+
+	if(file != NULL){
+		//The file says how deep it really is, which may be less than asked for if it was cut back to fit
+		char magic[8];
+		int file_N, file_depth;
+		if(fread(magic, 1, 8, file) != 8 || memcmp(magic, PERIMETER_MAGIC, 8) != 0 || fread(&file_N, sizeof(int), 1, file) != 1
+		   || fread(&file_depth, sizeof(int), 1, file) != 1 || file_N != N || file_depth < 0 || file_depth > MAX_PERIMETER_DEPTH){
+			printf("ERROR. %s is not a perimeter for %dx%d puzzles.\n", filename, N, N);
+			fclose(file);
+			return NULL;
+		}
+
+		for(int level = 0; level <= file_depth; level++){
+			if(fread(&level_counts[level], sizeof(long), 1, file) != 1){
+				printf("ERROR. %s is cut short.\n", filename);
+				fclose(file);
+				return NULL;
+			}
+
+			levels[level] = (unsigned char*)malloc(level_counts[level] * packed_size);
+			if(fread(levels[level], packed_size, level_counts[level], file) != (size_t)level_counts[level]){
+				printf("ERROR. %s is cut short.\n", filename);
+				fclose(file);
+				return NULL;
+			}
+		}
+
+		fclose(file);
+		depth = file_depth;
+	} else {
+		printf("Building the depth %d perimeter, this only happens once.\n", depth);
+		depth = build_levels(levels, level_counts, depth, memory_limit, N);
+
+		//Save it for next time. Not being able to is no reason to stop
+		file = fopen(filename, "wb");
+		if(file == NULL){
+			printf("Could not save the perimeter to %s.\n", filename);
+		} else {
+			fwrite(PERIMETER_MAGIC, 1, 8, file);
+			fwrite(&N, sizeof(int), 1, file);
+			fwrite(&depth, sizeof(int), 1, file);
+			for(int level = 0; level <= depth; level++){
+				fwrite(&level_counts[level], sizeof(long), 1, file);
+				fwrite(levels[level], packed_size, level_counts[level], file);
+			}
+			fclose(file);
+		}
+	}
+
+	struct perimeter* perimeter = create_perimeter(levels, level_counts, depth, N);
+	for(int level = 0; level <= depth; level++){
+		free(levels[level]);
+	}
+
+	printf("Perimeter: depth %d, %ld states, %.2f MB\n", perimeter->depth, perimeter->count,
+		   table_bytes(perimeter->count, packed_size) / 1048576.0);
+
+	return perimeter;
+}
+
+
+/**
+ * Free all of the memory used by the perimeter
+ */
+void destroy_perimeter(struct perimeter* perimeter){
+	free_table(perimeter->keys, (perimeter->mask + 1) * sizeof(unsigned long long));
+	free_table(perimeter->states, (perimeter->mask + 1) * perimeter->packed_size);
+	free_table(perimeter->distances, perimeter->mask + 1);
+	free(perimeter);
+}
+
+
+/**
+ * The exact distance from a state to the goal if it's in the perimeter, otherwise -1. Every state outside of the
+ * perimeter is at least depth + 1 moves away
+ */
+int perimeter_distance(struct perimeter* perimeter, struct state* statePtr){
+	unsigned char packed[perimeter->packed_size];
+	unsigned long long key = statePtr->zobrist_key | 1;
+	int packed_valid = 0;
+
+	for(unsigned long long slot = key & perimeter->mask; perimeter->keys[slot] != 0; slot = (slot + 1) & perimeter->mask){
+		if(perimeter->keys[slot] != key){
+			continue;
+		}
+
+		//Only pack the state once a key matches, which is rare for states that aren't in the perimeter
+		if(!packed_valid){
+			pack_state(statePtr, packed, perimeter->N);
+			packed_valid = 1;
+		}
+
+		if(memcmp(perimeter->states + slot * perimeter->packed_size, packed, perimeter->packed_size) == 0){
+			return perimeter->distances[slot];
+		}
+	}
+
+	return -1;
+}
@@ -0,0 +1,45 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the goal perimeter structure and function prototypes that are implemented in perimeter.c
+ */
+
+
+#ifndef PERIMETER_H
+#define PERIMETER_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "puzzle.h"
+
+
+//Distances are stored in one byte, and no puzzle that we can search needs a deeper perimeter than this
+#define MAX_PERIMETER_DEPTH 64
+
+
+/**
+ * Every state within depth moves of the goal, with its exact distance to the goal, in an open addressing hash table
+ */
+struct perimeter {
+	//Every state in the perimeter is at most this far from the goal, and every state outside is farther
+	int depth;
+	//How many states are in the perimeter
+	long count;
+	//The Zobrist key of each slot's state with the lowest bit set, 0 means empty
+	unsigned long long* keys;
+	//The packed state and the distance in each slot
+	unsigned char* states;
+	unsigned char* distances;
+	//Number of slots - 1, the number of slots is always a power of 2
+	unsigned long long mask;
+	//The size of the puzzle, and of a packed state
+	int N;
+	int packed_size;
+};
+
+
+/* Method Protoypes */
+struct perimeter* load_perimeter(const char*, int, long, const int);
+void destroy_perimeter(struct perimeter*);
+int perimeter_distance(struct perimeter*, struct state*);
+
+#endif /* PERIMETER_H */
@@ -0,0 +1,70 @@
+#Author: Jack Robbins
+#The fixed workload that profile guided builds are trained on, and that the builds are compared with. It solves the
+#same 15-puzzles every time with solve, checks that every solution has the known optimal length, and prints how long
+#each build took. Given more than one build directory, it also prints the speedup of each build
+#over the first one
+#Usage: ./pgo_workload.sh <build directory> [<build directory> . . .]
+
+#!/bin/bash
+
+#Always run relative to src, no matter where we were called from
+cd "$(dirname "$0")"
+
+if [[ $# -lt 1 ]]; then
+	echo "Usage: ./pgo_workload.sh <build directory> [<build directory> . . .]"
+	exit 1
+fi
+
+#Each case is "<program> <options> | <optimal path length> | <configuration>", with random configurations hard enough
+#that the search loop dominates. solve_pattern_db is left out: generate_pattern_db seeds itself from the clock and costs
+#its patterns by random walks, so its database is different every time and its solutions have no known length to check
+CASES=(
+	"solve | 50 | 10 5 12 9 14 3 0 8 13 2 15 6 11 1 4 7"
+	"solve | 47 | 5 10 0 1 9 4 6 2 3 15 11 7 12 8 13 14"
+	"solve --heuristic wd | 45 | 2 3 4 13 9 1 6 7 0 15 10 14 12 5 11 8"
+)
+
+#Run the whole workload with the programs in one build directory, and print the total time in milliseconds last
+run_workload(){
+	local BUILD=$1
+	local TOTAL=0
+
+	for CASE in "${CASES[@]}"; do
+		IFS='|' read -r COMMAND EXPECTED CONFIGURATION <<< "$CASE"
+		read -r PROGRAM OPTIONS <<< "$COMMAND"
+		EXPECTED=$(echo $EXPECTED)
+
+		ARGUMENTS="4 $CONFIGURATION"
+
+		local START=$(date +%s%N)
+		LENGTH=$($BUILD/$PROGRAM --progress 0 $OPTIONS $ARGUMENTS | grep -a "Optimal solution path length" | awk '{print $NF}')
+		local END=$(date +%s%N)
+
+		#A wrong answer means a broken build, and a profile of a broken build is worthless
+		if [[ "$LENGTH" != "$EXPECTED" ]]; then
+			echo "$BUILD/$PROGRAM $OPTIONS found length '$LENGTH' instead of $EXPECTED for: $CONFIGURATION" >&2
+			return 1
+		fi
+
+		local MILLISECONDS_TAKEN=$(( (END - START) / 1000000 ))
+		TOTAL=$(( TOTAL + MILLISECONDS_TAKEN ))
+		printf "  %-40s %8d ms\n" "$PROGRAM $OPTIONS" $MILLISECONDS_TAKEN >&2
+	done
+
+	echo $TOTAL
+}
+
+FIRST_TOTAL=0
+for BUILD in "$@"; do
+	echo "Running the workload with $BUILD" >&2
+	TOTAL=$(run_workload $BUILD) || exit 1
+
+	if [[ $FIRST_TOTAL -eq 0 ]]; then
+		FIRST_TOTAL=$TOTAL
+		printf "%-20s %8d ms\n" $BUILD $TOTAL
+	else
+		#Speedup with two decimal places, in integer arithmetic
+		SPEEDUP=$(( FIRST_TOTAL * 100 / (TOTAL > 0 ? TOTAL : 1) ))
+		printf "%-20s %8d ms, %d.%02dx faster than %s\n" $BUILD $TOTAL $(( SPEEDUP / 100 )) $(( SPEEDUP % 100 )) $1
+	fi
+done
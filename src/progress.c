@@ -0,0 +1,210 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in progress.h. A search used to print a line every 1000
+ * iterations from inside its main loop, which made the search wait on stdout, and stdout may be a slow pipe. Now the
+ * search only stores its counters into a struct search_progress, and a reporter thread running at the lowest priority
+ * wakes up every --progress milliseconds, samples them and writes one line of text or JSON to stderr or to
+ * --progress-file. Whatever happens to the output, the search never waits on it, and neither does the reporter: a line
+ * that the output can't take right away, like when it is a pipe that nobody is reading, is dropped
+ */
+
+//For SCHED_IDLE and pthread_timedjoin_np
+#define _GNU_SOURCE
+//Link to progress.h
+#include "progress.h"
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+
+//How long stopping the reporter waits for it to finish before leaving it behind, in milliseconds
+#define STOP_WAIT 1000
+
+
+/**
+ * Publish what the search has done so far. Called from the main loop of a search, so it's nothing but relaxed stores
+ */
+void publish_progress(struct search_progress* progress, long expanded, long generated, int f_bound, long fringe_size, long closed_size){
+	atomic_store_explicit(&progress->expanded, expanded, memory_order_relaxed);
+	atomic_store_explicit(&progress->generated, generated, memory_order_relaxed);
+	atomic_store_explicit(&progress->f_bound, f_bound, memory_order_relaxed);
+	atomic_store_explicit(&progress->fringe_size, fringe_size, memory_order_relaxed);
+	atomic_store_explicit(&progress->closed_size, closed_size, memory_order_relaxed);
+}
+
+
+/**
+ * Sample the counters and write one line
+ */
+static void report(struct progress_reporter* reporter){
+	struct search_progress* progress = reporter->progress;
+	long expanded = atomic_load_explicit(&progress->expanded, memory_order_relaxed);
+	long generated = atomic_load_explicit(&progress->generated, memory_order_relaxed);
+	int f_bound = atomic_load_explicit(&progress->f_bound, memory_order_relaxed);
+	long fringe_size = atomic_load_explicit(&progress->fringe_size, memory_order_relaxed);
+	long closed_size = atomic_load_explicit(&progress->closed_size, memory_order_relaxed);
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	double seconds = (now.tv_sec - reporter->start.tv_sec) + (now.tv_nsec - reporter->start.tv_nsec) / 1e9;
+	//The rate over the last interval, not since the start, so that slowing down shows up right away
+	double rate = (expanded - reporter->last_expanded) * 1000.0 / reporter->interval;
+	reporter->last_expanded = expanded;
+
+	char line[512];
+	int length;
+	if(reporter->json){
+		length = snprintf(line, sizeof(line), "{\"seconds\": %.3f, \"expanded\": %ld, \"expanded_per_second\": %.0f, \"generated\": %ld, "
+						  "\"f_bound\": %d, \"fringe\": %ld, \"closed\": %ld}\n", seconds, expanded, rate, generated, f_bound, fringe_size, closed_size);
+	} else {
+		length = snprintf(line, sizeof(line), "Progress %8.2f s: %12ld expanded(%10.0f per second), %12ld generated, f bound %4d, fringe %10ld, closed %10ld\n",
+						  seconds, expanded, rate, generated, f_bound, fringe_size, closed_size);
+	}
+
+	//Only write if the output can take the line now, and drop it otherwise. A pipe that says so has room for a whole
+	//line, which is far less than PIPE_BUF, so the write goes in at once. The progress file is also non-blocking, so if
+	//anything else filled it up in between, the write fails with EAGAIN instead of waiting
+	struct pollfd output = {reporter->output, POLLOUT, 0};
+	if(poll(&output, 1, 0) == 1 && (output.revents & POLLOUT)){
+		//A write that fails or falls short loses the line, the same as not writing it
+		ssize_t written = write(reporter->output, line, length);
+		(void)written;
+	}
+}
+
+
+/**
+ * The reporter thread function. Sleep for an interval, report, and repeat until stopped
+ */
+static void* reporter_thread(void* argument){
+	struct progress_reporter* reporter = (struct progress_reporter*)argument;
+
+	//Only run when the search has nothing else to do with the core
+#ifdef SCHED_IDLE
+	struct sched_param parameters;
+	memset(&parameters, 0, sizeof(parameters));
+	pthread_setschedparam(pthread_self(), SCHED_IDLE, &parameters);
+#endif
+
+	struct timespec wake_time = reporter->start;
+
+	pthread_mutex_lock(&reporter->lock);
+	while(!reporter->stopping){
+		//Wake up on a fixed schedule, not interval after the last report, so that the lines don't drift
+		wake_time.tv_sec += reporter->interval / 1000;
+		wake_time.tv_nsec += (reporter->interval % 1000) * 1000000L;
+		if(wake_time.tv_nsec >= 1000000000L){
+			wake_time.tv_sec++;
+			wake_time.tv_nsec -= 1000000000L;
+		}
+
+		//Wait out the interval, unless we're told to stop first. A timed wait that returns 0 was woken up early
+		int waited = 0;
+		while(!reporter->stopping && waited == 0){
+			waited = pthread_cond_timedwait(&reporter->wake, &reporter->lock, &wake_time);
+		}
+		if(reporter->stopping){
+			break;
+		}
+
+		//Don't hold the lock while writing, so that asking the reporter to stop never waits on the output
+		pthread_mutex_unlock(&reporter->lock);
+		report(reporter);
+		pthread_mutex_lock(&reporter->lock);
+	}
+	pthread_mutex_unlock(&reporter->lock);
+
+	return NULL;
+}
+
+
+/**
+ * Start a reporter thread for the counters, as the options say. Returns NULL if progress reporting is turned off, or
+ * if the output file can't be opened, in which case the search just goes on without it
+ */
+struct progress_reporter* start_progress_reporter(struct search_progress* progress, const struct solver_options* options){
+	if(options->progress_interval == 0){
+		return NULL;
+	}
+
+	int output = STDERR_FILENO;
+	if(options->progress_file != NULL){
+		output = open(options->progress_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if(output < 0){
+			printf("Could not open %s for progress reports, going on without them.\n", options->progress_file);
+			return NULL;
+		}
+		//This file is only ours, so it can be made non-blocking. stderr can't be, since the flag would be shared with
+		//stdout and with whatever else has the terminal or pipe open, and they would start failing instead of waiting
+		fcntl(output, F_SETFL, fcntl(output, F_GETFL) | O_NONBLOCK);
+	}
+
+	struct progress_reporter* reporter = (struct progress_reporter*)malloc(sizeof(struct progress_reporter));
+	reporter->progress = progress;
+	reporter->interval = options->progress_interval;
+	reporter->output = output;
+	reporter->json = options->progress_json;
+	reporter->stopping = 0;
+	reporter->last_expanded = 0;
+	pthread_mutex_init(&reporter->lock, NULL);
+
+	//The timed wait has to use the same clock as the start time
+	pthread_condattr_t attributes;
+	pthread_condattr_init(&attributes);
+	pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+	pthread_cond_init(&reporter->wake, &attributes);
+	pthread_condattr_destroy(&attributes);
+
+	clock_gettime(CLOCK_MONOTONIC, &reporter->start);
+	if(pthread_create(&reporter->thread, NULL, reporter_thread, reporter) != 0){
+		printf("Could not start the progress reporter, going on without it.\n");
+		if(output != STDERR_FILENO){
+			close(output);
+		}
+		free(reporter);
+		return NULL;
+	}
+
+	return reporter;
+}
+
+
+/**
+ * Stop the reporter thread and free it, after any report that it's in the middle of writing. Writing never waits on the
+ * output, but in case something still holds the reporter up, it is only waited on for STOP_WAIT milliseconds before it
+ * is left to finish on its own, so that the solver always gets to print its results. Does nothing if reporter is NULL
+ */
+void stop_progress_reporter(struct progress_reporter* reporter){
+	if(reporter == NULL){
+		return;
+	}
+
+	pthread_mutex_lock(&reporter->lock);
+	reporter->stopping = 1;
+	pthread_cond_signal(&reporter->wake);
+	pthread_mutex_unlock(&reporter->lock);
+
+	struct timespec give_up;
+	clock_gettime(CLOCK_REALTIME, &give_up);
+	give_up.tv_sec += STOP_WAIT / 1000;
+	give_up.tv_nsec += (STOP_WAIT % 1000) * 1000000L;
+	if(give_up.tv_nsec >= 1000000000L){
+		give_up.tv_sec++;
+		give_up.tv_nsec -= 1000000000L;
+	}
+
+	//A reporter that is left behind may still be using everything, so none of it can be freed
+	if(pthread_timedjoin_np(reporter->thread, NULL, &give_up) != 0){
+		pthread_detach(reporter->thread);
+		return;
+	}
+
+	if(reporter->output != STDERR_FILENO){
+		close(reporter->output);
+	}
+	pthread_mutex_destroy(&reporter->lock);
+	pthread_cond_destroy(&reporter->wake);
+	free(reporter);
+}
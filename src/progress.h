@@ -0,0 +1,64 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the progress counters that a search publishes, the reporter thread that prints them, and
+ * the function prototypes that are implemented in progress.c
+ */
+
+
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "options.h"
+
+
+//How often progress is reported if the user doesn't say, in milliseconds
+#define DEFAULT_PROGRESS_INTERVAL 1000
+
+
+/**
+ * What a search has done so far. The search only ever stores into these, with relaxed ordering, and the reporter
+ * thread only ever loads them, so the search never waits on the reporter
+ */
+struct search_progress {
+	//States expanded, and unique states generated
+	atomic_long expanded, generated;
+	//The total cost of the states being expanded now, which only grows in A*
+	atomic_int f_bound;
+	//How many states are open and closed
+	atomic_long fringe_size, closed_size;
+};
+
+
+/**
+ * The reporter thread and everything it needs
+ */
+struct progress_reporter {
+	//The counters that it samples
+	struct search_progress* progress;
+	//How many milliseconds go by between samples
+	long interval;
+	//The file descriptor where the samples go, and whether they are JSON lines instead of text
+	int output;
+	int json;
+	//Lets the search stop the reporter without waiting out the interval
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	int stopping;
+	//When reporting started, and how many states had been expanded at the last sample
+	struct timespec start;
+	long last_expanded;
+};
+
+
+/* Method Protoypes */
+void publish_progress(struct search_progress*, long, long, int, long, long);
+struct progress_reporter* start_progress_reporter(struct search_progress*, const struct solver_options*);
+void stop_progress_reporter(struct progress_reporter*);
+
+#endif /* PROGRESS_H */
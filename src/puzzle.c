@@ -6,6 +6,7 @@
 
 //Link to puzzle.h
 #include "puzzle.h"
+#include "heuristic_kernels.h"
 
 
 /*================================= Global variables for convenience =========================== */
@@ -19,6 +20,19 @@ int fringe_max_size = 5000;
 //We will keep a reference to the next available closed and fringe indices
 int next_closed_index = 0;
 int next_fringe_index = 0;
+//The Zobrist value of every tile in every position, NULL until initialize_zobrist is called for a small enough N
+unsigned long long* zobrist_table = NULL;
+int zobrist_N = 0;
+//A goal other than the standard one is solved as the standard goal, relabeled: its rows and columns are flipped as needed
+//to put the blank in the bottom right corner, and every tile is renamed after the standard tile where it ends up. This
+//way the heuristic tables, pattern databases and perimeters made for the standard goal work for any of these goals.
+//standard_labels renames the user's tiles and user_labels names them back, both NULL when there's nothing to rename
+short* standard_labels = NULL;
+short* user_labels = NULL;
+int flip_rows = 0, flip_columns = 0;
+//A goal whose blank isn't in a corner can't be relabeled, so it is searched for as it is, and only heuristics that can
+//measure against any target work for it. This is where each of its tiles sits, NULL for the standard goal
+short* goal_positions = NULL;
 /*============================================================================================== */
 
 
@@ -42,6 +56,25 @@ void destroy_state(struct state* statePtr){
 }
 
 
+/**
+ * Where a position of the user's goal ends up once it is relabeled onto the standard goal. Flipping is its own inverse,
+ * so this also finds where a position of the standard goal came from
+ */
+static int relabeled_position(int position, const int N){
+	int row = position / N;
+	int column = position % N;
+
+	if(flip_rows){
+		row = N - 1 - row;
+	}
+	if(flip_columns){
+		column = N - 1 - column;
+	}
+
+	return row * N + column;
+}
+
+
 /**
  * Prints out a state by printing out the positions in the 4x4 grid. If option is 1, print the
  * state out in one line
@@ -50,13 +83,19 @@ void print_state(struct state* statePtr, const int N, int option){
 	//Go through tile by tile and print out
 	for (int i = 0; i < N; i++) {
 		for (int j = 0; j < N; j++){
+			//States are solved relabeled, but the user sees them the way they gave them
+			int tile = *(statePtr->tiles + i * N + j);
+			if(user_labels != NULL){
+				tile = user_labels[statePtr->tiles[relabeled_position(i * N + j, N)]];
+			}
+
 			//Support printing of states with 2 or 3 digit max integers
 			if(N < 11){	
 				//With numbers less than 11, N^2 is at most 99, so only 2 digits needed
-				printf("%2d ", *(statePtr->tiles + i * N + j));
+				printf("%2d ", tile);
 			} else {
 				//Ensures printing of large states will not be botched
-				printf("%3d ", *(statePtr->tiles + i * N + j));
+				printf("%3d ", tile);
 			}
 		}
 		//Support printing in a single line
@@ -78,6 +117,8 @@ void copy_state(struct state* predecessor, struct state* successor, const int N)
 		successor->tiles[i] = predecessor->tiles[i];
 	}
 
+	//The tiles are the same, so the key is too
+	successor->zobrist_key = predecessor->zobrist_key;
 	//Initialize the current travel to the predecessor travel + 1
 	successor->current_travel = predecessor->current_travel+1;
 	//Copy the zero row and column position
@@ -90,6 +131,69 @@ void copy_state(struct state* predecessor, struct state* successor, const int N)
 }
 
 
+/**
+ * The splitmix64 finalizer, which turns consecutive integers into well mixed 64 bit values
+ */
+static unsigned long long splitmix64(unsigned long long x){
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+
+/**
+ * The Zobrist value for a tile sitting in a position. Looked up in the table when there is one, otherwise computed
+ * on the spot, which gives the same value
+ */
+static inline unsigned long long zobrist_value(int position, short tile, const int N){
+	if(zobrist_table != NULL && zobrist_N == N){
+		return zobrist_table[position * N * N + tile];
+	}
+
+	return splitmix64((unsigned long long)position * N * N + tile);
+}
+
+
+/**
+ * Generate the Zobrist table for size N. The values come from a fixed seed, so every run and every process agrees on
+ * the key of a state. The table has N^4 entries, so for puzzles bigger than 16x16 the values are computed on the fly
+ * instead of being stored
+ */
+void initialize_zobrist(const int N){
+	//Already done for this size, or too big to store
+	if(zobrist_N == N || N > 16){
+		return;
+	}
+
+	free(zobrist_table);
+	zobrist_table = (unsigned long long*)malloc(sizeof(unsigned long long) * N * N * N * N);
+	for(int i = 0; i < N * N * N * N; i++){
+		zobrist_table[i] = splitmix64(i);
+	}
+	zobrist_N = N;
+}
+
+
+/**
+ * Compute the Zobrist key of a tile configuration from scratch. The key is the XOR of the values of every tile except
+ * the 0 slider, since where the 0 slider is follows from where everything else is. A move then only changes the
+ * position of one tile, which is two XORs. Only needed when a state's tiles are filled in by hand, every move and copy
+ * keeps the key up to date by itself
+ */
+unsigned long long compute_zobrist_key(const short* tiles, const int N){
+	unsigned long long key = 0;
+
+	for(int i = 0; i < N * N; i++){
+		if(tiles[i] != 0){
+			key ^= zobrist_value(i, tiles[i], N);
+		}
+	}
+
+	return key;
+}
+
+
 /**
  * A simple function that swaps two tiles in the provided state
  * Note: The swap function assumes all row positions are valid, this must be checked by the caller
@@ -97,6 +201,9 @@ void copy_state(struct state* predecessor, struct state* successor, const int N)
 static void swap_tiles(int row1, int column1, int row2, int column2, struct state* statePtr, const int N){
 	//Store the first tile in a temp variable
 	short tile = *(statePtr->tiles + row1 * N + column1);
+	//One of the two is the 0 slider, which isn't part of the key, so only the other tile moves in it
+	short moved = tile != 0 ? tile : *(statePtr->tiles + row2 * N + column2);
+	statePtr->zobrist_key ^= zobrist_value(row1 * N + column1, moved, N) ^ zobrist_value(row2 * N + column2, moved, N);
 	//Put the tile from row2, column2 into row1, column1
 	*(statePtr->tiles + row1 * N + column1) = *(statePtr->tiles + row2 * N + column2);
 	//Put the temp in row2, column2
@@ -180,22 +287,144 @@ void update_prediction_function(struct state* statePtr, const int N){
 		return;
 	}
 
-	//The current_travel of the state has already been updated by stateCopy, so we only need to find the heuristic_cost
-	statePtr->heuristic_cost = 0;
-
 	/**
-	* For heuristic_cost, we will use the manhattan distance from each tile to where it should be.
-	* Conveniently, each tile 1-15 should be in position 0-14, so we can find manhattan distance by
-	* doing the sum of the absolute difference in coordinates from a number's current state position
-	* to its goal state position
-	*/
+	 * For heuristic_cost, we use the manhattan distance from each tile to where it should be, plus the generalized
+	 * linear conflict heuristic. This heuristic takes two tiles in their goal row or goal column and accounts for the
+	 * fact that for each tile to be moved around, it actually takes at least 2 additional moves. Both are found by the
+	 * vectorized kernels in heuristic_kernels.c, which pick the best instruction set that this CPU has
+	 */
+	statePtr->heuristic_cost = linear_conflict_kernel(statePtr->tiles, N);
+
+	//Once we have the heuristic_cost, update the total_cost
+	statePtr->total_cost = statePtr->heuristic_cost + statePtr->current_travel;
+}
+
 
+/**
+ * The hash of a state, which is its Zobrist key. Equal states always hash to the same value, so this can be used to
+ * index hash tables of states, and since the key is maintained by every move, it costs nothing
+ */
+unsigned long long hash_state(struct state* statePtr, const int N){
+	//N is only kept so that callers don't depend on how the hash is made
+	(void)N;
+	return statePtr->zobrist_key;
+}
+
+
+/**
+ * How many bits each tile takes in a packed state. This is the fewest bits that can hold every tile from 0 to N^2 - 1
+ */
+static int packed_tile_bits(const int N){
+	int bits = 1;
+
+	while((1 << bits) < N * N){
+		bits++;
+	}
+
+	return bits;
+}
+
+
+/**
+ * How many bytes a packed state takes up, see pack_state
+ */
+int packed_state_size(const int N){
+	return (N * N * packed_tile_bits(N) + 7) / 8;
+}
+
+
+/**
+ * Pack the tiles of a state into packed_state_size(N) bytes, with each tile taking packed_tile_bits(N) bits. The tiles
+ * are packed in row-major order starting from the most significant bit, so comparing two packed states with memcmp
+ * orders them the same way as comparing their tiles one by one. Used to store states compactly, such as on disk
+ */
+void pack_state(struct state* statePtr, unsigned char* packed, const int N){
+	int bits = packed_tile_bits(N);
+	//Tiles go into the bottom of the buffer, and whole bytes come out of the top
+	unsigned long long buffer = 0;
+	int buffered = 0, byte = 0;
+
+	for(int i = 0; i < N * N; i++){
+		buffer = (buffer << bits) | (unsigned short)statePtr->tiles[i];
+		buffered += bits;
+
+		while(buffered >= 8){
+			buffered -= 8;
+			packed[byte++] = (unsigned char)(buffer >> buffered);
+		}
+	}
+
+	//Whatever is left is padded out with 0s at the bottom of the last byte
+	if(buffered > 0){
+		packed[byte] = (unsigned char)(buffer << (8 - buffered));
+	}
+}
+
+
+/**
+ * Unpack a state made by pack_state. Only the tiles, the key and the position of the 0 slider are filled in, every other
+ * field is left to the caller
+ */
+void unpack_state(const unsigned char* packed, struct state* statePtr, const int N){
+	int bits = packed_tile_bits(N);
+	//Bytes go into the bottom of the buffer, and whole tiles come out of the top
+	unsigned long long buffer = 0;
+	int buffered = 0, byte = 0;
+
+	for(int i = 0; i < N * N; i++){
+		while(buffered < bits){
+			buffer = (buffer << 8) | packed[byte++];
+			buffered += 8;
+		}
+
+		buffered -= bits;
+		short tile = (short)((buffer >> buffered) & ((1ULL << bits) - 1));
+		statePtr->tiles[i] = tile;
+
+		//Keep track of the 0 slider
+		if(tile == 0){
+			statePtr->zero_row = i / N;
+			statePtr->zero_column = i % N;
+		}
+	}
+
+	//The key isn't stored, so it has to be rebuilt
+	statePtr->zobrist_key = compute_zobrist_key(statePtr->tiles, N);
+}
+
+
+/**
+ * Builds a lookup table that stores the position of every tile in the target state. Index the table by tile
+ * number to get the row-major position that the tile occupies in the target. Used by target_heuristic to
+ * evaluate states against an arbitrary target, not just the goal state
+ * NOTE: the caller is responsible for freeing the returned table
+ */
+short* create_target_positions(struct state* target, const int N){
+	//One entry per tile
+	short* target_positions = (short*)malloc(sizeof(short) * N * N);
+
+	//Record where each tile lives in the target
+	for(int i = 0; i < N * N; i++){
+		target_positions[target->tiles[i]] = i;
+	}
+
+	return target_positions;
+}
+
+
+/**
+ * Calculates the same manhattan distance plus generalized linear conflict heuristic as update_prediction_function,
+ * but measured against an arbitrary target whose tile positions are given by target_positions(see create_target_positions).
+ * This is what lets a search run backwards from the goal towards the start state. The heuristic value is returned, the
+ * state itself is not modified
+ */
+int target_heuristic(struct state* statePtr, const short* target_positions, const int N){
+	//Keep track of the total heuristic cost
+	int heuristic_cost = 0;
 	//Declare all needed variables
 	short selected_num, goal_rowCor, goal_colCor;
-	//Keep track of the manhattan distance
-	int manhattan_distance;
-	
-	//Go through each tile in the state and calculate the heuristic_cost
+
+	//Manhattan distance from each tile to its position in the target
 	for(int i = 0; i < N; i++){
 		for(int j = 0; j < N; j++){
 			//grab the number to be examined
@@ -206,134 +435,285 @@ void update_prediction_function(struct state* statePtr, const int N){
 				continue;
 			}
 
-			//Otherwise mathematically find the needed position
-			//Goal row coordinate is the index of the number divided by number of rows
-			goal_rowCor = (selected_num - 1) / N;
-			//Goal column coordinate is the index modulated by column length 
-			goal_colCor = (selected_num - 1) % N;
-				
+			//Look up where this tile should be in the target
+			goal_rowCor = target_positions[selected_num] / N;
+			goal_colCor = target_positions[selected_num] % N;
 
-			//Manhattan distance is the absolute value of the x distance and the y distance
-			manhattan_distance = abs(i - goal_rowCor) + abs(j - goal_colCor);	
-		
 			//Add manhattan distance for each tile
-			statePtr->heuristic_cost += manhattan_distance;
+			heuristic_cost += abs(i - goal_rowCor) + abs(j - goal_colCor);
 		}
 	}
-		
-	/**
-	 * Now we must calculate the linear conflict heuristic. This heuristic takes two tiles in their goal row
-	 * or goal column and accounts for the fact that for each tile to be moved around, it actually takes
-	 * at least 2 additional moves. Given two tiles in their goal row, 2 additional vertical moves are added
-	 * to manhattan distance for each row/column amount that they have to move
-	 * 
-	 */
 
 	//We initially have no linear conflicts
 	int linear_conflicts = 0;
 	//Declare for convenience
 	short left, right, above, below;
-	//Also declare goal row coordinates for convenience
-	short goal_rowCor_left, goal_rowCor_right, goal_colCor_above, goal_colCor_below;
 
-	//Check each row for linear conflicts
+	//Check each row for linear conflicts. Two tiles conflict if they are both in their target row, but
+	//the target column of the left tile is greater than the target column of the right tile
 	for(int i = 0; i < N; i++){
 		for(int j = 0; j < N-1; j++){
 			//Grab the leftmost tile that we'll be comparing to
 			left = *(statePtr->tiles + i * N + j);
 
-			//If this tile is 0, it's irrelevant so do not explore further
-			if(left == 0){
+			//If this tile is 0 or is not in its target row, it can't be in a conflict
+			if(left == 0 || target_positions[left] / N != i){
 				continue;
 			}
-			
-			//Now go through every tile in the row after left, this is what makes this generalized linear conflict
+
+			//Now go through every tile in the row after left
 			for(int k = j+1; k < N; k++){
 				//Grab right tile for convenience
 				right = *(statePtr->tiles + i * N + k);
 
-				//Again, if the tile is 0, no use in wasting cycles with it
-				if(right == 0){
+				//Again, skip 0 and any tile that is not in its target row
+				if(right == 0 || target_positions[right] / N != i){
 					continue;
 				}
 
-				//Check if both tiles are in their goal row
-				goal_rowCor_left = (left - 1) / N;
-				goal_rowCor_right = (right - 1) / N;
-
-				//If these tiles are not BOTH their goal row, linear conflict does not apply
-				//This is conterintuitive, but as it turns out makes an enormous difference
-				if(goal_rowCor_left != goal_rowCor_right || goal_rowCor_right != i){
-					continue;
-				}
-			
-				//If the tiles are swapped, we have a linear conflict
-				if(left > right){
-					//To be more informed, we should add 2 moves for EACH time we have to swap
+				//If the tiles are swapped relative to the target, we have a linear conflict
+				if(target_positions[left] % N > target_positions[right] % N){
 					linear_conflicts++;
 				}
-			}	
+			}
 		}
 	}
 
-	//Now check each column for linear conflicts 
+	//Now check each column for linear conflicts
 	for(int i = 0; i < N-1; i++){
 		for(int j = 0; j < N; j++){
 			//Grab the abovemost tile that we'll be comparing to
 			above = *(statePtr->tiles + i * N + j);
 
-			//If this tile is 0, it's irrelevant so do not explore further
-			if(above == 0){
+			//If this tile is 0 or is not in its target column, it can't be in a conflict
+			if(above == 0 || target_positions[above] % N != j){
 				continue;
 			}
 
-			//Now go through every tile in the column below "above", this is what makes it generalized linear conflict
+			//Now go through every tile in the column below "above"
 			for(int k = i+1; k < N; k++){
-				//Grab the below tile for convenience HERE
+				//Grab the below tile for convenience
 				below = *(statePtr->tiles + k * N + j);
 
-				//We don't care about the 0 tile, skip if we find it
-				if(below == 0){
-					continue;
-				}
-
-				//Check if both tiles are in their goal column
-				goal_colCor_above = (above - 1) % N;
-				goal_colCor_below = (below - 1) % N;
-
-				//If these tiles are not BOTH in their goal column, linear conflict does not apply
-				//This is counterintutive, but as it turns out makes an enormous difference
-				if(goal_colCor_below != goal_colCor_above || goal_colCor_above != j){
+				//Skip 0 and any tile that is not in its target column
+				if(below == 0 || target_positions[below] % N != j){
 					continue;
 				}
 
-				//If above is more than below, we have a linear conflict
-				if(above > below){
-					//To be more informed, we should add 2 moves for EACH time we have to swap
-					linear_conflicts++;				
+				//If the tiles are swapped relative to the target, we have a linear conflict
+				if(target_positions[above] / N > target_positions[below] / N){
+					linear_conflicts++;
 				}
 			}
 		}
 	}
 
-	//Once we have calculated the number of linear conflicts, we add it into the heuristic cost
-	//For each linear conflict, a minimum of 2 additional moves are required to swap tiles, so add 2 to the heuristic_cost
-	statePtr->heuristic_cost += linear_conflicts * 2;
+	//For each linear conflict, a minimum of 2 additional moves are required
+	return heuristic_cost + linear_conflicts * 2;
+}
 
-	//Once we have the heuristic_cost, update the total_cost
-	statePtr->total_cost = statePtr->heuristic_cost + statePtr->current_travel;
+
+
+/**
+ * Whether a state can be brought to the standard goal. Every move swaps the blank with a tile, so the parity of the
+ * permutation of all cells(with the blank as the last) must match the parity of the blank's distance from its goal
+ */
+int reaches_standard_goal(struct state* statePtr, const int N){
+	char* visited = (char*)calloc(N * N, 1);
+	int cycles = 0;
+
+	//Count the cycles of the permutation that takes each cell to where its tile goes
+	for(int i = 0; i < N * N; i++){
+		if(visited[i]){
+			continue;
+		}
+
+		cycles++;
+		for(int j = i; !visited[j]; ){
+			visited[j] = 1;
+			j = statePtr->tiles[j] == 0 ? N * N - 1 : statePtr->tiles[j] - 1;
+		}
+	}
+
+	free(visited);
+
+	int blank_distance = (N - 1 - statePtr->zero_row) + (N - 1 - statePtr->zero_column);
+	return (N * N - cycles) % 2 == blank_distance % 2;
+}
+
+
+/**
+ * Whether the goal can be reached from the start at all. Moves never change whether a state reaches the standard goal,
+ * so the two can only reach each other if both of them reach it, or neither does
+ */
+int solvable(struct state* start_state, struct state* goal_state, const int N){
+	return reaches_standard_goal(start_state, N) == reaches_standard_goal(goal_state, N);
+}
+
+
+/**
+ * Read the user's goal into goal, from its tiles in row-major order split by commas, and work out how to relabel it onto
+ * the standard one. Returns 0 if it can be relabeled, 1 if it can't because its blank isn't in a corner, or -1 if it
+ * isn't a goal for this N, in which case an error has already been printed
+ */
+int relabel_goal(const char* goal_configuration, short* goal, const int N){
+	int seen[N * N];
+	int count = 0, blank = -1;
+	char copy[strlen(goal_configuration) + 1];
+	strcpy(copy, goal_configuration);
+	memset(seen, 0, sizeof(seen));
+
+	//Nothing is relabeled until we know that the goal can be
+	free(standard_labels);
+	free(user_labels);
+	standard_labels = user_labels = NULL;
+	flip_rows = flip_columns = 0;
+
+	//Every tile from 0 to N^2 - 1 has to be there exactly once
+	for(char* token = strtok(copy, ", "); token != NULL; token = strtok(NULL, ", ")){
+		int tile;
+		if(count == N * N || sscanf(token, "%d", &tile) != 1 || tile < 0 || tile >= N * N || seen[tile]){
+			count = -1;
+			break;
+		}
+		seen[tile] = 1;
+		goal[count] = tile;
+		if(tile == 0){
+			blank = count;
+		}
+		count++;
+	}
+
+	if(count != N * N){
+		printf("ERROR. The goal %s must have every tile from 0 to %d exactly once.\n", goal_configuration, N * N - 1);
+		return -1;
+	}
+
+	//The heuristics ignore the blank, but every one of them needs every other tile to have a home in the standard goal,
+	//which only a blank in the corner leaves them
+	if((blank / N != 0 && blank / N != N - 1) || (blank % N != 0 && blank % N != N - 1)){
+		return 1;
+	}
+	flip_rows = blank / N == 0;
+	flip_columns = blank % N == 0;
+
+	//Each tile is named after the standard tile in the position it's flipped to
+	standard_labels = (short*)malloc(sizeof(short) * N * N);
+	user_labels = (short*)malloc(sizeof(short) * N * N);
+	int renamed = flip_rows || flip_columns;
+	for(int i = 0; i < N * N; i++){
+		short standard = (relabeled_position(i, N) + 1) % (N * N);
+		standard_labels[goal[i]] = standard;
+		user_labels[standard] = goal[i];
+		renamed |= standard != goal[i];
+	}
+
+	//The standard goal given by hand needs no relabeling at all
+	if(!renamed){
+		free(standard_labels);
+		free(user_labels);
+		standard_labels = user_labels = NULL;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Relabel a state given the way that the user sees it onto the standard goal, the same way as the goal was, in place.
+ * Does nothing if there is nothing to relabel
+ */
+void relabel_state(struct state* statePtr, const int N){
+	if(standard_labels == NULL){
+		return;
+	}
+
+	short user_tiles[N * N];
+	memcpy(user_tiles, statePtr->tiles, sizeof(short) * N * N);
+
+	for(int i = 0; i < N * N; i++){
+		//Tiles that don't belong in the puzzle are left for the caller's checks to find
+		int position = relabeled_position(i, N);
+		statePtr->tiles[position] = user_tiles[i] >= 0 && user_tiles[i] < N * N ? standard_labels[user_tiles[i]] : user_tiles[i];
+
+		if(user_tiles[i] == 0){
+			statePtr->zero_row = position / N;
+			statePtr->zero_column = position % N;
+		}
+	}
+
+	statePtr->zobrist_key = compute_zobrist_key(statePtr->tiles, N);
+}
+
+
+/**
+ * Turn a move of the blank made on the relabeled puzzle(0 = left, 1 = right, 2 = down, 3 = up) into the move that the
+ * user sees. Flipping the columns swaps left and right, and flipping the rows swaps up and down
+ */
+int user_move(int move){
+	if((move <= 1 && flip_columns) || (move >= 2 && flip_rows)){
+		return move ^ 1;
+	}
+
+	return move;
 }
 
 
+/**
+ * Search for a goal as it is, with the heuristic measured against where its tiles are, unless it's the standard goal
+ */
+void set_goal_target(struct state* goal_state, const int N){
+	free(goal_positions);
+	goal_positions = NULL;
+
+	for(int i = 0; i < N * N; i++){
+		if(goal_state->tiles[i] != (i + 1) % (N * N)){
+			goal_positions = create_target_positions(goal_state, N);
+			break;
+		}
+	}
+}
+
+
+/**
+ * Where every tile sits in the goal, if the goal couldn't be relabeled onto the standard one, or NULL if the search is
+ * for the standard goal
+ */
+const short* goal_target_positions(){
+	return goal_positions;
+}
+
 
 /**
  * The initialization function takes in the command line arguments and translates them into the initial
- * state. It also initializes the goal state mathematically, as it is always the same
+ * state. It also initializes the goal state mathematically, as it is always the same. A goal given by the user is
+ * solved relabeled onto the standard goal, so the start state is relabeled the same way, and print_state undoes it.
+ * A goal whose blank isn't in a corner is searched for as it is instead, see set_goal_target.
+ * Returns 0, or -1 if the user's goal can't be used, in which case an error has already been printed
  * Note: Assumes a correct number of command line arguments(16 numbers), must be checked by caller
  */
-void initialize_start_goal(char** argv, struct state* start_state, struct state* goal_state, const int N){
+int initialize_start_goal(char** argv, struct state* start_state, struct state* goal_state, const char* goal_configuration, const int N){
+	short user_goal[N * N];
+
+	//Nothing is relabeled unless the user gave a goal
+	free(standard_labels);
+	free(user_labels);
+	standard_labels = user_labels = NULL;
+	flip_rows = flip_columns = 0;
+	int as_given = 0;
+	if(goal_configuration != NULL){
+		int relabeled = relabel_goal(goal_configuration, user_goal, N);
+		if(relabeled == -1){
+			return -1;
+		}
+		as_given = relabeled == 1;
+	}
+
 	/* Begin by creating the start state */
 
+	//Every move keeps the keys up to date from here on
+	initialize_zobrist(N);
+
 	//Dynamically allocate memory needed in the start_state
 	initialize_state(start_state, N);
 
@@ -356,7 +736,9 @@ void initialize_start_goal(char** argv, struct state* start_state, struct state*
 		}
 	}
 
-	//Initialize everything else in the start state
+	//Initialize everything else in the start state, relabeled if need be
+	start_state->zobrist_key = compute_zobrist_key(start_state->tiles, N);
+	relabel_state(start_state, N);
 	start_state->total_cost = 0;
 	start_state->current_travel = 0;
 	start_state->heuristic_cost = 0;
@@ -382,9 +764,24 @@ void initialize_start_goal(char** argv, struct state* start_state, struct state*
 
 	//0 is always at the last spot in the goal state
 	goal_state->tiles[N * N -1] = 0;
+	goal_state->zero_row = (goal_state)->zero_column = N-1;
+
+	//Unless it's the user's own goal, taken as it is
+	if(as_given){
+		printf("The blank isn't in a corner of the goal, so the goal can't be relabeled onto the standard one. It is searched "
+			   "for as it is, with a heuristic that measures against it.\n");
+		for(int i = 0; i < N * N; i++){
+			goal_state->tiles[i] = user_goal[i];
+			if(user_goal[i] == 0){
+				goal_state->zero_row = i / N;
+				goal_state->zero_column = i % N;
+			}
+		}
+	}
+	set_goal_target(goal_state, N);
 
 	//Initialize everything else in the goal state
-	goal_state->zero_row = (goal_state)->zero_column = N-1;
+	goal_state->zobrist_key = compute_zobrist_key(goal_state->tiles, N);
 	goal_state->total_cost = 0;
 	goal_state->current_travel = 0;
 	goal_state->heuristic_cost = 0;
@@ -393,6 +790,8 @@ void initialize_start_goal(char** argv, struct state* start_state, struct state*
 	//Print to the console for the user
 	printf("Goal state\n");
 	print_state(goal_state, N, 0);
+
+	return 0;
 }
 
 
@@ -536,6 +935,31 @@ struct state* dequeue(){
 }
 
 
+/**
+ * The state that dequeue would give back next, without removing it
+ * NOTE: the fringe must not be empty, must be checked by caller
+ */
+struct state* fringe_head(){
+	return fringe[0];
+}
+
+
+/**
+ * How many states are in the fringe
+ */
+int fringe_size(){
+	return next_fringe_index;
+}
+
+
+/**
+ * How many states are in closed
+ */
+int closed_size(){
+	return next_closed_index;
+}
+
+
 /**
  * A very simple helper function that lets solve know if the fringe is empty
  */
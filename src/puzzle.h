@@ -23,6 +23,10 @@ struct state {
    int total_cost, current_travel, heuristic_cost;
    //location (row and colum) of blank tile 0
    short zero_row, zero_column;
+   //The Zobrist key of the tiles, kept up to date by every move so that the state never has to be rehashed
+   unsigned long long zobrist_key;
+   //Row and column configuration codes for the walking distance heuristic, see walking_distance.c
+   unsigned long long wd_row_code, wd_column_code;
    //The next state in the linked list(fringe or closed), NOT a successor
    struct state* next;
    //The predecessor of the current state, used for tracing back a solution	
@@ -41,13 +45,31 @@ void move_up(struct state*, const int);
 void move_left(struct state*, const int);
 int states_same(struct state*, struct state*, const int);
 void update_prediction_function(struct state*, int);
-void initialize_start_goal(char**, struct state*, struct state*, const int N);
+void initialize_zobrist(const int);
+unsigned long long compute_zobrist_key(const short*, const int);
+unsigned long long hash_state(struct state*, const int);
+int packed_state_size(const int);
+void pack_state(struct state*, unsigned char*, const int);
+void unpack_state(const unsigned char*, struct state*, const int);
+short* create_target_positions(struct state*, const int);
+int target_heuristic(struct state*, const short*, const int);
+int reaches_standard_goal(struct state*, const int);
+int solvable(struct state*, struct state*, const int);
+int relabel_goal(const char*, short*, const int);
+void relabel_state(struct state*, const int);
+int user_move(int);
+void set_goal_target(struct state*, const int);
+const short* goal_target_positions();
+int initialize_start_goal(char**, struct state*, struct state*, const char*, const int N);
 void initialize_closed(void);
 void initialize_fringe(void);
 void merge_to_closed(struct state*);
 void priority_queue_insert(struct state*);
 struct state* dequeue();
 int fringe_empty();
+struct state* fringe_head();
+int fringe_size();
+int closed_size();
 void check_repeating_fringe(struct state**, const int);
 void check_repeating_closed(struct state**, const int);
 int merge_to_fringe(struct state*[4]);
@@ -5,16 +5,14 @@
 #!/bin/bash
 
 #Make sure that the files exists
-if [[ ! -f ./solve.c ]] || [[ ! -f ./generate_start_config.c ]] || [[ ! -f ./solve_multi_threaded.c ]]; then
+if [[ ! -f ./solve.c ]] || [[ ! -f ./generate_start_config.c ]] || [[ ! -f ./solve_multi_threaded.c ]] || [[ ! -f ./solve_bidirectional.c ]] || [[ ! -f ./solve_external.c ]]; then
 	echo "Files not found."
 	exit 1;
 fi
 
-#Compile with aggressive warnings
-gcc -Wall -Wextra generate_start_config.c puzzle.c -o generate_start_config 
-gcc -Wall -Wextra solve.c puzzle.c -o solve
-#IMPORTANT - must link pthread library when compiling
-gcc -Wall -Wextra -pthread solve_multi_threaded.c puzzle.c -o solve_multi_threaded
+#Build every program with optimizations, see the Makefile for the other builds
+make release || exit 1
+BIN=build/release
 
 #Get the puzzle size from user
 read -p "Enter a positive integer for the NxN puzzle size: " SIZE
@@ -32,15 +30,45 @@ while [[ $COMPLEXITY -lt 0 ]]; do
 	read -p "Enter a positive integer for complexity of initial configuration: " COMPLEXITY
 done
 
+#The search based solvers can't handle big puzzles, so offer the macro solver for them
+if [[ $SIZE -gt 5 ]]; then
+	read -p "Puzzles this big are best solved without searching. Do you want to use the macro solver[Y/n]: " MACRO
+fi
+
 #Get the multithreaded option from user
-read -p "Do you want to use multithreading[Y/n]: " MULTITHREADED
+if [[ $MACRO != "Y" ]] && [[ $MACRO != "y" ]]; then
+	read -p "Do you want to use multithreading[Y/n]: " MULTITHREADED
+fi
+
+#Parallel IDA* keeps every core busy with almost no memory
+if [[ $MULTITHREADED == "Y" ]] || [[ $MULTITHREADED == "y" ]]; then
+	read -p "Do you want to use parallel IDA*[Y/n]: " PARALLEL_IDA
+fi
+
+#Bidirectional search is only offered for the single threaded solver
+if [[ $MACRO != "Y" ]] && [[ $MACRO != "y" ]] && [[ $MULTITHREADED != "Y" ]] && [[ $MULTITHREADED != "y" ]]; then
+	read -p "Do you want to use bidirectional search[Y/n]: " BIDIRECTIONAL
+fi
+
+#External memory search is for problems that don't fit in memory
+if [[ $MACRO != "Y" ]] && [[ $MACRO != "y" ]] && [[ $MULTITHREADED != "Y" ]] && [[ $MULTITHREADED != "y" ]] && [[ $BIDIRECTIONAL != "Y" ]] && [[ $BIDIRECTIONAL != "y" ]]; then
+	read -p "Do you want to use external memory search[Y/n]: " EXTERNAL
+fi
 
 #Grab the input(last line of gen output)
-input=$(./generate_start_config $SIZE $COMPLEXITY | tail -n 1)
+input=$($BIN/generate_start_config $SIZE $COMPLEXITY | tail -n 1)
 
 #Use the appropriate version of the program depending on what the user inputted
-if [[ $MULTITHREADED == "Y" ]] || [[ $MULTITHREADED == "y" ]]; then
-	./solve_multi_threaded $SIZE $input 
+if [[ $MACRO == "Y" ]] || [[ $MACRO == "y" ]]; then
+	$BIN/solve_macro --optimize --verify $SIZE $input
+elif [[ $PARALLEL_IDA == "Y" ]] || [[ $PARALLEL_IDA == "y" ]]; then
+	$BIN/solve_parallel_ida $SIZE $input
+elif [[ $MULTITHREADED == "Y" ]] || [[ $MULTITHREADED == "y" ]]; then
+	$BIN/solve_multi_threaded $SIZE $input 
+elif [[ $BIDIRECTIONAL == "Y" ]] || [[ $BIDIRECTIONAL == "y" ]]; then
+	$BIN/solve_bidirectional $SIZE $input
+elif [[ $EXTERNAL == "Y" ]] || [[ $EXTERNAL == "y" ]]; then
+	$BIN/solve_external $SIZE $input
 else
-	./solve $SIZE $input
+	$BIN/solve $SIZE $input
 fi
@@ -9,15 +9,13 @@ if [[ ! -f ./pattern_databases/generate_pattern_db.c ]] || [[ ! -f ./pattern_dat
 	exit 1
 fi
 
-#Compile all with aggressive warnings
-gcc -Wall -Wextra generate_start_config.c -o generate_start_config
+#Build every program with optimizations, see the Makefile for the other builds
+make release || exit 1
+BIN=build/release
 
 #Switch into the pattern_databases directory
 cd pattern_databases
 
-gcc -Wall -Wextra -pthread generate_pattern_db.c -o generate_pattern_db
-gcc -Wall -Wextra solve_pattern_db.c -o solve_pattern_db
-
 #Get the puzzle size from the user
 read  -p "Enter a positive integer for the NxN puzzle size: " SIZE
 
@@ -29,7 +27,7 @@ done
 #If there is no pattern database, we must generate it
 if [[ ! -f "${SIZE}.patterndb" ]]; then
 	echo "Pattern database $SIZE is nonexistent\nNow generating pattern database for ${SIZE}x${SIZE}, this may take a while"
-	./generate_pattern_db 4
+	../$BIN/generate_pattern_db 4
 fi
 
 #Go back up to src for generate start config
@@ -44,11 +42,11 @@ while [[ $COMPLEXITY -lt 0 ]]; do
 done
 
 #Grab the last line of generator input
-input=$(./generate_start_config $SIZE $COMPLEXITY | tail -n 1)
+input=$($BIN/generate_start_config $SIZE $COMPLEXITY | tail -n 1)
 
 cd pattern_databases
 
 #Run the solver
-./solve_pattern_db $SIZE "${SIZE}.patterndb" $input
+../$BIN/solve_pattern_db $SIZE "${SIZE}.patterndb" $input
 
 cd ..
@@ -0,0 +1,220 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in search_control.h. Every solver can be given a deadline
+ * in wall time(--deadline) and a budget of states to expand(--node-limit), and can be cancelled from another thread
+ * or with Ctrl-C. None of these kill the search outright: the solver notices at its next check, stops, and reports
+ * what it learned, which is the proven lower bound on the solution length, the best path it has, and its statistics.
+ *
+ * Searches call search_should_stop after every expansion, and it only looks at the clock and the shared node count once
+ * every SEARCH_CHECK_INTERVAL expansions, so checking costs next to nothing
+ */
+
+//Link to search_control.h
+#include "search_control.h"
+#include <signal.h>
+
+
+/*================================= Global variables for convenience =========================== */
+//The search that Ctrl-C cancels, NULL if none
+static struct search_control* interrupted_search = NULL;
+//Expansions that this thread hasn't added to the shared count yet
+static _Thread_local long unchecked_expansions = 0;
+/*============================================================================================== */
+
+
+/**
+ * Start the clock on a search, with the limits from the options
+ */
+void start_search_control(struct search_control* control, const struct solver_options* options){
+	clock_gettime(CLOCK_MONOTONIC, &control->start);
+
+	control->has_deadline = options->deadline > 0;
+	control->deadline = control->start;
+	control->deadline.tv_sec += options->deadline / 1000;
+	control->deadline.tv_nsec += (options->deadline % 1000) * 1000000L;
+	if(control->deadline.tv_nsec >= 1000000000L){
+		control->deadline.tv_sec++;
+		control->deadline.tv_nsec -= 1000000000L;
+	}
+
+	control->node_limit = options->node_limit;
+	atomic_init(&control->expanded, 0);
+	unchecked_expansions = 0;
+	atomic_init(&control->stop_reason, SEARCH_RUNNING);
+}
+
+
+/**
+ * Stop the search for a reason, unless it has already stopped for another. This only sets a flag, so it is safe from
+ * any thread and from a signal handler
+ */
+void stop_search(struct search_control* control, int reason){
+	int running = SEARCH_RUNNING;
+	atomic_compare_exchange_strong(&control->stop_reason, &running, reason);
+}
+
+
+/**
+ * Cancel the search. This only sets a flag, so it is safe from any thread and from a signal handler
+ */
+void cancel_search(struct search_control* control){
+	stop_search(control, SEARCH_CANCELLED);
+}
+
+
+/**
+ * The signal handler for Ctrl-C and SIGTERM
+ */
+static void interrupt_handler(int signal_number){
+	(void)signal_number;
+	cancel_search(interrupted_search);
+}
+
+
+/**
+ * Make Ctrl-C and SIGTERM cancel the search instead of killing the solver, so that it still reports what it has
+ */
+void cancel_on_interrupt(struct search_control* control){
+	interrupted_search = control;
+	signal(SIGINT, interrupt_handler);
+	signal(SIGTERM, interrupt_handler);
+}
+
+
+/**
+ * Called after every expansion, or batch of expansions, with how many states were just expanded. Returns the reason
+ * that the search has to stop, or SEARCH_RUNNING(0) if it can go on. Each thread only adds to the shared count once it
+ * has SEARCH_CHECK_INTERVAL expansions to add, so the node limit holds to within that many expansions per thread
+ */
+int search_should_stop(struct search_control* control, int expansions){
+	//A cancel is seen right away, everything else only every so often
+	int reason = atomic_load_explicit(&control->stop_reason, memory_order_relaxed);
+	unchecked_expansions += expansions;
+	if(reason != SEARCH_RUNNING || unchecked_expansions < SEARCH_CHECK_INTERVAL){
+		return reason;
+	}
+
+	long total = atomic_fetch_add_explicit(&control->expanded, unchecked_expansions, memory_order_relaxed) + unchecked_expansions;
+	unchecked_expansions = 0;
+	if(control->node_limit > 0 && total >= control->node_limit){
+		reason = SEARCH_NODE_LIMIT;
+	} else if(control->has_deadline){
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		if(now.tv_sec > control->deadline.tv_sec || (now.tv_sec == control->deadline.tv_sec && now.tv_nsec >= control->deadline.tv_nsec)){
+			reason = SEARCH_DEADLINE;
+		}
+	}
+
+	//The first reason sticks, so every thread reports the same one
+	if(reason != SEARCH_RUNNING){
+		stop_search(control, reason);
+	}
+
+	return atomic_load(&control->stop_reason);
+}
+
+
+/**
+ * Why the search stopped, or SEARCH_RUNNING(0) if it hasn't, without counting an expansion
+ */
+int search_stopped(struct search_control* control){
+	return atomic_load(&control->stop_reason);
+}
+
+
+/**
+ * Milliseconds left until the deadline, 0 once it has passed, or -1 if the search has no deadline
+ */
+long search_time_left(struct search_control* control){
+	if(!control->has_deadline){
+		return -1;
+	}
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	long left = (control->deadline.tv_sec - now.tv_sec) * 1000 + (control->deadline.tv_nsec - now.tv_nsec) / 1000000;
+
+	return left < 0 ? 0 : left;
+}
+
+
+/**
+ * A description of why a search stopped
+ */
+const char* stop_reason_name(int reason){
+	switch(reason){
+		case SEARCH_DEADLINE:
+			return "deadline reached";
+		case SEARCH_NODE_LIMIT:
+			return "node limit reached";
+		case SEARCH_CANCELLED:
+			return "cancelled";
+		default:
+			return "running";
+	}
+}
+
+
+/**
+ * Wall time since the search started, in seconds
+ */
+double search_seconds(struct search_control* control){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - control->start.tv_sec) + (now.tv_nsec - control->start.tv_nsec) / 1e9;
+}
+
+
+/**
+ * Print the part of a stopped search's report that every solver shares: why it stopped, the length that the optimal
+ * solution is now known to be at least(counting states, like every path length), and how much it searched. A lower
+ * bound of -1 means the solver can't prove one
+ */
+void print_search_stopped(struct search_control* control, int lower_bound, long expanded){
+	printf("Search stopped: %s\n", stop_reason_name(search_stopped(control)));
+	if(lower_bound != -1){
+		printf("Proven lower bound on the optimal path length: %d\n", lower_bound);
+	}
+	printf("States expanded before stopping: %ld\n", expanded);
+	printf("Wall time spent: %.3f seconds\n", search_seconds(control));
+}
+
+
+/**
+ * Of two expanded states, the one that a stopped search should report its partial path to: the one closest to the goal
+ * by its heuristic, with ties going to the shorter path. Either may be NULL
+ */
+struct state* closer_to_goal(struct state* best, struct state* candidate){
+	if(best == NULL || (candidate != NULL && (candidate->heuristic_cost < best->heuristic_cost
+	   || (candidate->heuristic_cost == best->heuristic_cost && candidate->current_travel < best->current_travel)))){
+		return candidate;
+	}
+
+	return best;
+}
+
+
+/**
+ * Print the path from the start to a state by following predecessors, the same way that a solution is printed.
+ * Returns the length of the path
+ */
+int print_partial_path(struct state* end, const int N){
+	int pathlen = 0;
+	struct state* partial_path = NULL;
+
+	//Put the states in order by inserting each at the head
+	for(struct state* curr_state = end; curr_state != NULL; curr_state = curr_state->predecessor){
+		curr_state->next = partial_path;
+		partial_path = curr_state;
+		pathlen++;
+	}
+
+	printf("\nSearch stopped before a solution was found. Now displaying the best partial path\n");
+	printf("Path Length: %d\n\n", pathlen);
+	for(; partial_path != NULL; partial_path = partial_path->next){
+		print_state(partial_path, N, 0);
+	}
+
+	return pathlen;
+}
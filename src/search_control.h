@@ -0,0 +1,61 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the search control structure, which decides when a search has to stop before it is done,
+ * and the function prototypes that are implemented in search_control.c
+ */
+
+
+#ifndef SEARCH_CONTROL_H
+#define SEARCH_CONTROL_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "options.h"
+#include "puzzle.h"
+
+
+//How many expansions go by between looks at the clock and the node budget
+#define SEARCH_CHECK_INTERVAL 256
+//Why a search stopped, SEARCH_RUNNING means that it hasn't
+#define SEARCH_RUNNING 0
+#define SEARCH_DEADLINE 1
+#define SEARCH_NODE_LIMIT 2
+#define SEARCH_CANCELLED 3
+//What a solver exits with when it stopped before it was done, so that whatever ran it can tell
+#define SEARCH_STOPPED_EXIT 2
+
+
+/**
+ * The limits on one search, and whether it has run into them. Any thread may cancel the search at any time, and the
+ * threads that search it all share one node count
+ */
+struct search_control {
+	//When the search started, and when it has to stop
+	struct timespec start, deadline;
+	int has_deadline;
+	//The most states that may be expanded, 0 means no limit
+	long node_limit;
+	//States expanded so far, added by each thread SEARCH_CHECK_INTERVAL or more at a time
+	atomic_long expanded;
+	//Why the search stopped, or SEARCH_RUNNING
+	atomic_int stop_reason;
+};
+
+
+/* Method Protoypes */
+void start_search_control(struct search_control*, const struct solver_options*);
+void cancel_on_interrupt(struct search_control*);
+void stop_search(struct search_control*, int);
+void cancel_search(struct search_control*);
+int search_should_stop(struct search_control*, int);
+int search_stopped(struct search_control*);
+long search_time_left(struct search_control*);
+const char* stop_reason_name(int);
+double search_seconds(struct search_control*);
+void print_search_stopped(struct search_control*, int, long);
+struct state* closer_to_goal(struct state*, struct state*);
+int print_partial_path(struct state*, const int);
+
+#endif /* SEARCH_CONTROL_H */
@@ -0,0 +1,300 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in solution_cache.h. The solution cache is a file of optimal
+ * solutions, keyed by start state, that every solver process maps into memory. A start state and its reflection across
+ * the main diagonal share one record, since the reflection of a solution solves the reflected start state. Records are
+ * grouped in buckets of SOLUTION_CACHE_WAYS, and a full bucket drops its least recently used record.
+ *
+ * Many processes can use the same file at once. Each record has a sequence number that a writer makes odd while it
+ * writes and even again once it is done, so a reader that sees the same even number before and after copying the record
+ * knows that its copy is whole. Only creating the file takes a file lock
+ */
+
+//Link to solution_cache.h
+#include "solution_cache.h"
+//For the file and the mapping
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "table_memory.h"
+
+
+//Identifies a solution cache file
+#define SOLUTION_CACHE_MAGIC "NPSOLVE1"
+
+
+/**
+ * The size of one record: the fixed part, the packed start state and 2 bits per move, rounded up to 8 bytes
+ */
+static int record_size(const int N){
+	int size = sizeof(struct solution_record) + packed_state_size(N) + MAX_CACHED_MOVES / 4;
+
+	return (size + 7) & ~7;
+}
+
+
+/**
+ * Where a record lives in the mapping
+ */
+static struct solution_record* get_record(struct solution_cache* cache, long index){
+	return (struct solution_record*)(cache->map + sizeof(struct solution_cache_header) + index * cache->header->record_size);
+}
+
+
+/**
+ * Reflect tiles across the main diagonal. The tile at row r, column c moves to row c, column r, and is renamed to the
+ * tile whose goal position is the reflection of its own, so that the goal reflects onto itself
+ */
+static void reflect_tiles(const short* tiles, short* reflected, const int N){
+	for(int row = 0; row < N; row++){
+		for(int column = 0; column < N; column++){
+			short tile = tiles[row * N + column];
+
+			//The 0 slider stays the 0 slider
+			if(tile != 0){
+				int goal = tile - 1;
+				tile = (goal % N) * N + goal / N + 1;
+			}
+
+			reflected[column * N + row] = tile;
+		}
+	}
+}
+
+
+/**
+ * Find the canonical form of a start state: whichever of the state and its reflection packs to the smaller bytes.
+ * The packed form and key are filled in, and 1 is returned if the reflection was the one picked
+ */
+static int canonical_form(struct solution_cache* cache, struct state* statePtr, unsigned char* packed, unsigned long long* key){
+	const int N = cache->N;
+	unsigned char reflected_packed[cache->packed_size];
+	struct state reflected;
+	initialize_state(&reflected, N);
+
+	reflect_tiles(statePtr->tiles, reflected.tiles, N);
+	pack_state(statePtr, packed, N);
+	pack_state(&reflected, reflected_packed, N);
+
+	int use_reflection = memcmp(reflected_packed, packed, cache->packed_size) < 0;
+	if(use_reflection){
+		memcpy(packed, reflected_packed, cache->packed_size);
+		*key = compute_zobrist_key(reflected.tiles, N);
+	} else {
+		*key = compute_zobrist_key(statePtr->tiles, N);
+	}
+
+	destroy_state(&reflected);
+	return use_reflection;
+}
+
+
+/**
+ * Reflecting the board swaps rows and columns, so left(0) and up(3) trade places, as do right(1) and down(2)
+ */
+static char reflect_move(char move){
+	return 3 - move;
+}
+
+
+/**
+ * Open the cache file at path for NxN puzzles, creating a file of size_mb megabytes if there isn't one. An existing file
+ * keeps the size it was made with. Returns NULL if the file can't be used, after printing why
+ */
+struct solution_cache* open_solution_cache(const char* path, long size_mb, const int N){
+	int file = open(path, O_RDWR | O_CREAT, 0644);
+	if(file < 0){
+		printf("Could not open solution cache %s, continuing without it.\n", path);
+		return NULL;
+	}
+
+	//Only one process may set up a new file
+	flock(file, LOCK_EX);
+
+	struct stat file_info;
+	fstat(file, &file_info);
+
+	//A new file gets its header, and every record starts out never written(0)
+	if(file_info.st_size == 0){
+		struct solution_cache_header header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, SOLUTION_CACHE_MAGIC, 8);
+		header.N = N;
+		header.record_size = record_size(N);
+		header.num_records = (size_mb * 1048576 - (long)sizeof(header)) / header.record_size / SOLUTION_CACHE_WAYS * SOLUTION_CACHE_WAYS;
+		if(header.num_records < SOLUTION_CACHE_WAYS){
+			header.num_records = SOLUTION_CACHE_WAYS;
+		}
+
+		//ftruncate fills the records with zeros
+		if(ftruncate(file, sizeof(header) + header.num_records * header.record_size) != 0
+		   || pwrite(file, &header, sizeof(header), 0) != sizeof(header)){
+			printf("Could not create solution cache %s, continuing without it.\n", path);
+			flock(file, LOCK_UN);
+			close(file);
+			return NULL;
+		}
+
+		fstat(file, &file_info);
+	}
+
+	flock(file, LOCK_UN);
+
+	struct solution_cache* cache = (struct solution_cache*)malloc(sizeof(struct solution_cache));
+	cache->file = file;
+	cache->map_size = file_info.st_size;
+	cache->map = (unsigned char*)mmap(NULL, cache->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	cache->header = (struct solution_cache_header*)cache->map;
+	cache->N = N;
+	cache->packed_size = packed_state_size(N);
+
+	//Make sure that the file is really a solution cache for this size
+	if(cache->map == MAP_FAILED || cache->map_size < sizeof(struct solution_cache_header)
+	   || memcmp(cache->header->magic, SOLUTION_CACHE_MAGIC, 8) != 0 || cache->header->N != N
+	   || cache->header->record_size != record_size(N)
+	   || sizeof(struct solution_cache_header) + cache->header->num_records * cache->header->record_size > cache->map_size){
+		printf("%s is not a solution cache for %dx%d puzzles, continuing without it.\n", path, N, N);
+		if(cache->map != MAP_FAILED){
+			munmap(cache->map, cache->map_size);
+		}
+		close(file);
+		free(cache);
+		return NULL;
+	}
+
+	//Only does anything if the file is on tmpfs, but then probes land on huge pages like every other table's
+	advise_table_mapping(cache->map, cache->map_size);
+
+	return cache;
+}
+
+
+/**
+ * Unmap and close the cache. Everything written is already in the file
+ */
+void close_solution_cache(struct solution_cache* cache){
+	munmap(cache->map, cache->map_size);
+	close(cache->file);
+	free(cache);
+}
+
+
+/**
+ * Look up the optimal solution for a start state. If it is cached, its moves are written to moves, which must have room
+ * for MAX_CACHED_MOVES, and its length is returned. Otherwise -1 is returned
+ */
+int solution_cache_lookup(struct solution_cache* cache, struct state* start_state, char* moves){
+	unsigned char packed[cache->packed_size];
+	unsigned char record_packed[cache->packed_size];
+	unsigned char record_moves[MAX_CACHED_MOVES / 4];
+	unsigned long long key;
+	int reflected = canonical_form(cache, start_state, packed, &key);
+
+	long bucket = (key % (cache->header->num_records / SOLUTION_CACHE_WAYS)) * SOLUTION_CACHE_WAYS;
+
+	for(long index = bucket; index < bucket + SOLUTION_CACHE_WAYS; index++){
+		struct solution_record* record = get_record(cache, index);
+		unsigned char* record_data = (unsigned char*)(record + 1);
+
+		//Skip records that were never written or are being written right now
+		unsigned int sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+		if(sequence == 0 || (sequence & 1)){
+			continue;
+		}
+
+		//Copy everything out, then make sure that nobody wrote to the record while we were copying
+		unsigned long long record_key = record->key;
+		unsigned int cost = record->cost;
+		memcpy(record_packed, record_data, cache->packed_size);
+		memcpy(record_moves, record_data + cache->packed_size, MAX_CACHED_MOVES / 4);
+		atomic_thread_fence(memory_order_acquire);
+		if(atomic_load_explicit(&record->sequence, memory_order_relaxed) != sequence){
+			continue;
+		}
+
+		if(record_key != key || cost > MAX_CACHED_MOVES || memcmp(record_packed, packed, cache->packed_size) != 0){
+			continue;
+		}
+
+		//A hit, so this record was just used
+		atomic_store_explicit(&record->last_used, atomic_fetch_add(&cache->header->clock, 1), memory_order_relaxed);
+
+		//Unpack the moves, reflecting them back if the start state was reflected
+		for(unsigned int i = 0; i < cost; i++){
+			char move = (record_moves[i / 4] >> (2 * (i % 4))) & 3;
+			moves[i] = reflected ? reflect_move(move) : move;
+		}
+
+		return cost;
+	}
+
+	return -1;
+}
+
+
+/**
+ * Store the optimal solution for a start state. It replaces the record for the same start state if there is one,
+ * otherwise an empty record in its bucket, otherwise the least recently used one. If another process is writing that
+ * record right now, the solution is simply not stored
+ */
+void solution_cache_insert(struct solution_cache* cache, struct state* start_state, const char* moves, int length){
+	//Too long to fit in a record
+	if(length > MAX_CACHED_MOVES){
+		return;
+	}
+
+	unsigned char packed[cache->packed_size];
+	unsigned char packed_moves[MAX_CACHED_MOVES / 4];
+	unsigned long long key;
+	int reflected = canonical_form(cache, start_state, packed, &key);
+
+	long bucket = (key % (cache->header->num_records / SOLUTION_CACHE_WAYS)) * SOLUTION_CACHE_WAYS;
+
+	//Pick the record to replace
+	long victim = bucket;
+	unsigned long long oldest = ~0ULL;
+	for(long index = bucket; index < bucket + SOLUTION_CACHE_WAYS; index++){
+		struct solution_record* record = get_record(cache, index);
+		unsigned int sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+
+		//The same start state, it's worth comparing the whole thing only if the key matches
+		if(sequence != 0 && record->key == key && memcmp(record + 1, packed, cache->packed_size) == 0){
+			victim = index;
+			break;
+		}
+
+		//An empty record is better than anything else, except the same start state
+		unsigned long long last_used = sequence == 0 ? 0 : atomic_load_explicit(&record->last_used, memory_order_relaxed);
+		if(last_used < oldest){
+			oldest = last_used;
+			victim = index;
+		}
+	}
+
+	//Pack the moves, in the orientation of the canonical form
+	memset(packed_moves, 0, sizeof(packed_moves));
+	for(int i = 0; i < length; i++){
+		char move = reflected ? reflect_move(moves[i]) : moves[i];
+		packed_moves[i / 4] |= move << (2 * (i % 4));
+	}
+
+	//Take the record by making its sequence odd. If it's odd already, someone else is writing it
+	struct solution_record* record = get_record(cache, victim);
+	unsigned int sequence = atomic_load_explicit(&record->sequence, memory_order_relaxed);
+	if((sequence & 1) || !atomic_compare_exchange_strong(&record->sequence, &sequence, sequence + 1)){
+		return;
+	}
+
+	unsigned char* record_data = (unsigned char*)(record + 1);
+	record->key = key;
+	record->cost = length;
+	memcpy(record_data, packed, cache->packed_size);
+	memcpy(record_data + cache->packed_size, packed_moves, MAX_CACHED_MOVES / 4);
+	atomic_store_explicit(&record->last_used, atomic_fetch_add(&cache->header->clock, 1), memory_order_relaxed);
+
+	//Publish the record. Sequence 0 means empty, so skip past it when wrapping around
+	unsigned int published = sequence + 2 == 0 ? 2 : sequence + 2;
+	atomic_store_explicit(&record->sequence, published, memory_order_release);
+}
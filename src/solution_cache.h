@@ -0,0 +1,79 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the persistent solution cache structures and function prototypes that are implemented
+ * in solution_cache.c
+ */
+
+
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "puzzle.h"
+
+
+//The default solution cache file is 64 MB
+#define DEFAULT_SOLUTION_CACHE_SIZE 64
+//Longer solutions than this are not cached. Each move takes 2 bits
+#define MAX_CACHED_MOVES 256
+//Every instance can go in any one of this many records in its bucket
+#define SOLUTION_CACHE_WAYS 4
+
+
+/**
+ * The start of the cache file, which says what kind of records follow
+ */
+struct solution_cache_header {
+	//Always "NPSOLVE1"
+	char magic[8];
+	//The size of the puzzle and of one record
+	int N;
+	int record_size;
+	//How many records follow the header
+	long num_records;
+	//Goes up by one on every use, so the least recently used record in a bucket is the one with the smallest stamp
+	_Atomic unsigned long long clock;
+	//Keep the records aligned
+	char padding[32];
+};
+
+
+/**
+ * The fixed part of one record. The packed start state and the moves follow it in the file
+ */
+struct solution_record {
+	//Odd while a process is writing the record, 0 if the record has never been written
+	_Atomic unsigned int sequence;
+	//The optimal number of moves
+	unsigned int cost;
+	//The clock when the record was last written or found
+	_Atomic unsigned long long last_used;
+	//The Zobrist key of the start state, to skip most records without comparing the whole state
+	unsigned long long key;
+};
+
+
+/**
+ * An open solution cache, mapped into memory. Any number of processes can have the same file open at once
+ */
+struct solution_cache {
+	//The file and the mapping of all of it
+	int file;
+	unsigned char* map;
+	size_t map_size;
+	struct solution_cache_header* header;
+	//The size of the puzzle, and of a packed state
+	int N;
+	int packed_size;
+};
+
+
+/* Method Protoypes */
+struct solution_cache* open_solution_cache(const char*, long, const int);
+void close_solution_cache(struct solution_cache*);
+int solution_cache_lookup(struct solution_cache*, struct state*, char*);
+void solution_cache_insert(struct solution_cache*, struct state*, const char*, int);
+
+#endif /* SOLUTION_CACHE_H */
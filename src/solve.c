@@ -9,75 +9,545 @@
 
 //For timing
 #include <time.h>
-#include "puzzle.h"
+#include "npuzzle.h"
 
 
 /**
- * This function generates all possible successors to a state and stores them in the successor array
+ * A successor in a batch, along with its key so that duplicates can be found by sorting, and the node and move that
+ * made it
+ */
+struct batch_entry {
+	unsigned long long key;
+	struct state* state;
+	unsigned int parent;
+	int move;
+};
+
+
+/*================================= Global variables for convenience =========================== */
+//The heuristic cache that sits in front of the heuristic, NULL if turned off
+struct heuristic_cache* cache = NULL;
+//How many states are expanded at once, 1 is plain A*
+int batch_size = 1;
+//How many batches were expanded, and how many states were expanded in all
+int num_batches = 0, num_expansions = 0;
+//States expanded at the highest cost so far. Every lower cost is expanded in full no matter how states are batched,
+//so once the goal is found, comparing this with a run without batching shows the work that batching added
+int layer_cost = -1, layer_expansions = 0;
+//The goal, once a batch has taken it out of the open list. It has the lowest cost, so it is the next node to look at
+struct open_entry pending_goal = {0, 0, NO_NODE};
+//Every node the search has generated, along with the open list
+struct node_store* store = NULL;
+//The states that nodes are loaded into to be expanded, and the states that their successors are generated into
+struct state expanded_states[MAX_BATCH];
+struct state successor_states[MAX_BATCH * 4];
+//Optimal solutions from earlier runs, NULL if turned off
+struct solution_cache* solution_cache = NULL;
+//Every state near the goal with its exact distance, NULL if turned off
+struct perimeter* perimeter = NULL;
+//How many moves at the end of the solution came from the perimeter instead of the search
+int perimeter_moves = 0;
+//The node with the shortest known path to the goal through the perimeter, and that path's length, NO_NODE if none yet
+unsigned int incumbent_node = NO_NODE;
+int incumbent_cost = 0;
+//The deadline and node limit, and whether the search was cancelled
+struct search_control control;
+//What the search has done so far, for the progress reporter
+struct search_progress progress;
+//The expanded node closest to the goal by its heuristic, the end of the best partial path if the search is stopped
+unsigned int closest_node = NO_NODE;
+//Saves the search every so often, and the checkpoint to pick the search back up from, NULL to start a new one
+struct checkpointer checkpointer;
+const char* resume_file = NULL;
+//The moves, in the order that they are numbered(0 = left, 1 = right, 2 = down, 3 = up)
+void (*const make_move[4])(struct state*, const int) = {move_left, move_right, move_down, move_up};
+/*============================================================================================== */
+
+
+/**
+ * This function generates all possible successors to a state into the four states of scratch, and points the successor
+ * array at them. The move that would undo last_move is skipped, since it only leads back to the predecessor
  * Note: 4 successors are not always possible, if a successor isn't possible, NULL will be put in its place 
  */
-void generate_successors(struct state* predecessor, struct state** successors, int N){
-	//Create four pointers, one for each possible move, and initialize to NULL by default
-	struct state* leftMove = NULL;
-	struct state* rightMove = NULL;
-	struct state* upMove = NULL;
-	struct state* downMove = NULL;
-	
-	//Generate successor by moving left one if possible
-	if(predecessor->zero_column > 0){
-		//Create a new state
-		leftMove = (struct state*)malloc(sizeof(struct state));
-		//Dynamically allocate the memory needed in leftMove
-		initialize_state(leftMove, N);
-		//Perform a deep copy on the state
-		copy_state(predecessor, leftMove, N);
-		//Move right by one
-		move_left(leftMove, N);
-	}
-	//Put leftMove into the array
-	successors[0] = leftMove;
-
-	//Generate successor by moving right one if possible
-	if(predecessor->zero_column < N-1){
-		//Create a new state
-		rightMove = (struct state*)malloc(sizeof(struct state));
-		//Dynamically allocate the memory needed in rightMove
-		initialize_state(rightMove, N);
-		//Perform a deep copy on the state
-		copy_state(predecessor, rightMove, N);
-		//Move right by one
-		move_right(rightMove, N);
-	}
-	//Put rightMove into the array
-	successors[1] = rightMove;
-	
-	//Generate successor by moving down one if possible
-	if(predecessor->zero_row < N-1){
-		//Create a new state
-		downMove = (struct state*)malloc(sizeof(struct state));
-		//Dynamically allocate the memory needed in downMove
-		initialize_state(downMove, N);
-		//Perform a deep copy on the state
-		copy_state(predecessor, downMove, N);
-		//Move down by one
-		move_down(downMove, N);
-	}
-	//Put downMove into the array
-	successors[2] = downMove;
-	
-	//Generate successor by moving down one if possible
-	if(predecessor->zero_row > 0){
-		//Create a new state
-		upMove = (struct state*)malloc(sizeof(struct state));
-		//Dynamically allocate the memory needed in upMove
-		initialize_state(upMove, N);
-		//Perform a deep copy on the state
-		copy_state(predecessor, upMove, N);
-		//Move up by one
-		move_up(upMove, N);
+void generate_successors(struct state* predecessor, int last_move, struct state* scratch, struct state** successors, int N){
+	//Whether the 0 slider can move left, right, down and up, in the order that the moves are numbered
+	int possible[4] = {predecessor->zero_column > 0, predecessor->zero_column < N-1, predecessor->zero_row < N-1, predecessor->zero_row > 0};
+
+	for(int move = 0; move < 4; move++){
+		//Moves come in pairs that undo each other, left and right(0 and 1) and down and up(2 and 3)
+		if(!possible[move] || (last_move != NO_MOVE && move == (last_move ^ 1))){
+			successors[move] = NULL;
+			continue;
+		}
+
+		//Perform a deep copy on the state, then make the move
+		copy_state(predecessor, &scratch[move], N);
+		make_move[move](&scratch[move], N);
+		successors[move] = &scratch[move];
+	}
+}
+
+
+/**
+ * Count an expansion towards the cost layer it belongs to
+ */
+static void count_expansion(struct open_entry expanded){
+	if(expanded.f != layer_cost){
+		layer_cost = expanded.f;
+		layer_expansions = 0;
+	}
+
+	layer_expansions++;
+	num_expansions++;
+
+	//Closest to the goal by its heuristic, with ties going to the shorter path
+	if(closest_node == NO_NODE || store->h[expanded.id] < store->h[closest_node]
+	   || (store->h[expanded.id] == store->h[closest_node] && store->g[expanded.id] < store->g[closest_node])){
+		closest_node = expanded.id;
+	}
+}
+
+
+/**
+ * Load a node into a state to expand it. Incremental heuristics evaluate successors from their predecessor's per-state
+ * information, which the node store doesn't keep, so for them the state is evaluated in full once here
+ */
+static void load_expanded(struct open_entry entry, struct state* statePtr, const int N){
+	node_store_load(store, entry.id, statePtr);
+	statePtr->total_cost = entry.f;
+
+	if(heuristic_is_incremental()){
+		evaluate_heuristic(statePtr, N);
+	}
+}
+
+
+/**
+ * Take the next node to expand out of the open list, and mark it as expanded. Returns 0 if the entry was stale, because
+ * its node was reached again by a shorter path and already expanded through the newer entry
+ */
+static int pop_unexpanded(struct open_entry* entry){
+	*entry = open_list_pop(store);
+
+	if(store->flags[entry->id] & EXPANDED_FLAG){
+		return 0;
+	}
+
+	store->flags[entry->id] |= EXPANDED_FLAG;
+	return 1;
+}
+
+
+/**
+ * Use the perimeter to sharpen a state's heuristic. Inside the perimeter the exact distance is known, and outside of it
+ * the goal is at least depth + 1 moves away. Both are admissible, so the solution stays optimal
+ */
+static void apply_perimeter(struct state* statePtr){
+	if(perimeter == NULL || statePtr == NULL){
+		return;
+	}
+
+	int distance = perimeter_distance(perimeter, statePtr);
+	if(distance != -1){
+		statePtr->heuristic_cost = distance;
+	} else if(statePtr->heuristic_cost <= perimeter->depth){
+		statePtr->heuristic_cost = perimeter->depth + 1;
+	}
+
+	statePtr->total_cost = statePtr->current_travel + (int)(heuristic_weight() * statePtr->heuristic_cost);
+}
+
+
+/**
+ * Whether a state that went through apply_perimeter is inside the perimeter. Only those have a heuristic of depth or less
+ */
+static int in_perimeter(struct state* statePtr){
+	return perimeter != NULL && statePtr->heuristic_cost <= perimeter->depth;
+}
+
+
+/**
+ * Remember a node that was just added if it's inside the perimeter and makes for the shortest path to the goal so far.
+ * Its distance to the goal is exact, so that path is known in full the moment the node is generated
+ */
+static void record_incumbent(unsigned int id, struct state* statePtr){
+	if(!in_perimeter(statePtr)){
+		return;
+	}
+
+	int cost = statePtr->current_travel + statePtr->heuristic_cost;
+	if(incumbent_node == NO_NODE || cost < incumbent_cost){
+		incumbent_node = id;
+		incumbent_cost = cost;
+	}
+}
+
+
+/**
+ * Whether the path through the incumbent is as short as any there can be. Every path not yet looked at costs at least the
+ * lowest cost left open, so once the incumbent costs no more than that, it can't be beaten, and the states on the last
+ * layers before the goal never have to be expanded. A stale entry at the head only makes this wait a little longer
+ */
+static int incumbent_wins(){
+	if(incumbent_node == NO_NODE){
+		return 0;
+	}
+
+	if(pending_goal.id != NO_NODE){
+		return incumbent_cost <= pending_goal.f;
+	}
+
+	return open_list_empty(store) || incumbent_cost <= open_list_head(store).f;
+}
+
+
+/**
+ * Walk from a state inside the perimeter to the goal, always moving to a neighbor one step closer. No searching is
+ * needed since every distance is exact. Returns the goal, with the path back through predecessor as usual
+ */
+static struct state* finish_from_perimeter(struct state* statePtr, const int N){
+	struct state* successors[4];
+
+	for(int distance = statePtr->heuristic_cost; distance > 0; distance--){
+		struct state* closer = NULL;
+		generate_successors(statePtr, NO_MOVE, successor_states, successors, N);
+
+		//Make the first move that gets one step closer for real, the rest were only looked at
+		for(int move = 0; move < 4 && closer == NULL; move++){
+			if(successors[move] != NULL && perimeter_distance(perimeter, successors[move]) == distance - 1){
+				closer = (struct state*)malloc(sizeof(struct state));
+				initialize_state(closer, N);
+				copy_state(statePtr, closer, N);
+				make_move[move](closer, N);
+			}
+		}
+
+		closer->heuristic_cost = distance - 1;
+		closer->total_cost = closer->current_travel + closer->heuristic_cost;
+		statePtr = closer;
+		perimeter_moves++;
+	}
+
+	return statePtr;
+}
+
+
+/**
+ * Expand a node that was loaded into expanded. Successors that are already in the store by a path at least as short
+ * are thrown out before their heuristic is evaluated, and the rest are added or updated and put into the open list.
+ * Returns the number of new nodes
+ */
+static int expand(struct open_entry entry, struct state* expanded, const int N){
+	struct state* successors[4];
+	int num_new = 0;
+
+	generate_successors(expanded, store->flags[entry.id] & MOVE_MASK, successor_states, successors, N);
+
+	for(int move = 0; move < 4; move++){
+		//If the state is already null, there is no point in further exploration
+		if(successors[move] == NULL){
+			continue;
+		}
+
+		//Only states that are new, or reached by a shorter path than before, are worth evaluating
+		unsigned int found = node_store_find(store, successors[move]);
+		if(found != NO_NODE && store->g[found] <= successors[move]->current_travel){
+			continue;
+		}
+
+		update_heuristic(successors[move], N, cache);
+		apply_perimeter(successors[move]);
+
+		int is_new;
+		unsigned int id = node_store_add(store, successors[move], entry.id, move, &is_new);
+		open_list_push(store, successors[move]->total_cost, id);
+		record_incumbent(id, successors[move]);
+		num_new += is_new;
+	}
+
+	//A node expanded on its own is a batch of one, so the batch counts stay right for a search that is resumed with
+	//another --batch
+	num_batches++;
+	count_expansion(entry);
+	return num_new;
+}
+
+
+/**
+ * Order batch entries by key, and equal keys by current_travel, so that the shortest path to each successor comes first.
+ * For qsort
+ */
+static int compare_batch_entries(const void* a, const void* b){
+	const struct batch_entry* first = (const struct batch_entry*)a;
+	const struct batch_entry* second = (const struct batch_entry*)b;
+
+	if(first->key != second->key){
+		return (first->key > second->key) - (first->key < second->key);
+	}
+
+	return first->state->current_travel - second->state->current_travel;
+}
+
+
+/**
+ * Expand the node that was just taken out of the open list, already loaded into expanded_states[0], together with up to
+ * batch_size - 1 more nodes of exactly the same total cost. Every successor goes into one buffer, copies within the
+ * buffer are removed in one sorted pass, the ones that are already in the store by a path at least as short are thrown
+ * out, and the heuristic is evaluated over the rest at once with prefetching. Only nodes of equal cost are batched,
+ * since with a consistent heuristic all of them already have their best current_travel, so batching never expands a node
+ * too early. The goal is never expanded, it is handed back to the main loop through pending_goal. Returns the number of
+ * new nodes
+ */
+static int expand_batch(struct open_entry first, struct state* goal_state, const int N){
+	struct open_entry batch[MAX_BATCH];
+	struct batch_entry entries[MAX_BATCH * 4];
+	struct state* successors[MAX_BATCH * 4];
+	int count = 0, num_entries = 0, num_successors = 0, num_new = 0;
+
+	batch[count++] = first;
+
+	//Take more nodes of the same cost, stopping at the goal
+	while(count < batch_size && !open_list_empty(store) && open_list_head(store).f == first.f){
+		struct open_entry next;
+		if(!pop_unexpanded(&next)){
+			continue;
+		}
+
+		load_expanded(next, &expanded_states[count], N);
+		if(states_same(&expanded_states[count], goal_state, N) || in_perimeter(&expanded_states[count])){
+			pending_goal = next;
+			break;
+		}
+
+		batch[count++] = next;
+	}
+
+	for(int i = 0; i < count; i++){
+		count_expansion(batch[i]);
+	}
+	num_batches++;
+
+	//Generate every successor into one buffer
+	for(int i = 0; i < count; i++){
+		struct state* generated[4];
+		generate_successors(&expanded_states[i], store->flags[batch[i].id] & MOVE_MASK, successor_states + i * 4, generated, N);
+
+		for(int move = 0; move < 4; move++){
+			if(generated[move] != NULL){
+				entries[num_entries].key = hash_state(generated[move], N);
+				entries[num_entries].state = generated[move];
+				entries[num_entries].parent = batch[i].id;
+				entries[num_entries++].move = move;
+			}
+		}
+	}
+
+	//Two nodes of the batch can share a successor. Sort so that copies sit next to each other with the shortest path
+	//first, and keep only that one, so that no successor has its heuristic evaluated twice
+	qsort(entries, num_entries, sizeof(struct batch_entry), compare_batch_entries);
+
+	int num_unique = 0;
+	for(int i = 0; i < num_entries; i++){
+		int duplicate = 0;
+		for(int j = num_unique - 1; j >= 0 && entries[j].key == entries[i].key; j--){
+			if(states_same(entries[j].state, entries[i].state, N)){
+				duplicate = 1;
+				break;
+			}
+		}
+
+		if(!duplicate){
+			entries[num_unique++] = entries[i];
+		}
+	}
+
+	//Keep only those that are new or reached by a shorter path, compacting them to the front of the buffer
+	for(int i = 0; i < num_unique; i++){
+		unsigned int found = node_store_find(store, entries[i].state);
+		if(found == NO_NODE || store->g[found] > entries[i].state->current_travel){
+			entries[num_successors] = entries[i];
+			successors[num_successors++] = entries[i].state;
+		}
+	}
+
+	//Evaluate the heuristic over the whole batch
+	update_heuristic_batch(successors, num_successors, N, cache);
+	for(int i = 0; i < num_successors; i++){
+		apply_perimeter(successors[i]);
+	}
+
+	for(int i = 0; i < num_successors; i++){
+		int is_new;
+		unsigned int id = node_store_add(store, successors[i], entries[i].parent, entries[i].move, &is_new);
+		open_list_push(store, successors[i]->total_cost, id);
+		record_incumbent(id, successors[i]);
+		num_new += is_new;
+	}
+
+	return num_new;
+}
+
+
+/**
+ * Which move(0 = left, 1 = right, 2 = down, 3 = up) takes the 0 slider from one state to the next
+ */
+static char move_between(struct state* from, struct state* to){
+	if(to->zero_column < from->zero_column){
+		return 0;
+	} else if(to->zero_column > from->zero_column){
+		return 1;
+	} else if(to->zero_row > from->zero_row){
+		return 2;
+	}
+
+	return 3;
+}
+
+
+/**
+ * Print a solution that came out of the solution cache, replaying its moves from the start state
+ */
+static void print_cached_solution(struct state* start_state, const char* moves, int length, const int N){
+	//No search was done, so there's only the lookup to time
+	clock_t begin_CPU = clock();
+
+	printf("\nSolution found! Now displaying solution path\n");
+	//Display the path length for the user, counting the start state
+	printf("Path Length: %d\n\n", length + 1);
+
+	struct state cursor;
+	initialize_state(&cursor, N);
+	copy_state(start_state, &cursor, N);
+	print_state(&cursor, N, 0);
+	for(int i = 0; i < length; i++){
+		if(moves[i] == 0){
+			move_left(&cursor, N);
+		} else if(moves[i] == 1){
+			move_right(&cursor, N);
+		} else if(moves[i] == 2){
+			move_down(&cursor, N);
+		} else {
+			move_up(&cursor, N);
+		}
+		print_state(&cursor, N, 0);
+	}
+	destroy_state(&cursor);
+
+	printf("------------- Program Running Statistics -------------\n\n");
+	printf("Optimal solution path length: %d\n", length + 1);
+	printf("Found in the solution cache, no search needed\n");
+	printf("Total CPU time spent: %.7f seconds\n\n", (double)(clock() - begin_CPU) / CLOCKS_PER_SEC);
+	printf("------------------------------------------------------\n\n");
+}
+
+
+/**
+ * Report on a search that was stopped before it found the goal: the best partial path, which ends at the expanded state
+ * closest to the goal, and a proven lower bound. With a consistent heuristic, every state with a lower cost than the head
+ * of the open list has been expanded, so the head's cost bounds the optimal solution from below. A weighted search can close
+ * states before their best path is known, so all that it proves is the start state's heuristic, and an overlapping one
+ * proves nothing
+ */
+static void print_stopped_search(struct state* start_state, int num_unique_configs, clock_t begin_CPU, const int N){
+	//A stale entry at the head only has a lower cost than the node it stands for, so the bound stays sound
+	int lowest = pending_goal.id != NO_NODE ? pending_goal.f : (open_list_empty(store) ? -1 : open_list_head(store).f);
+	//Plus one since path lengths count the start state. A heuristic that overestimates proves nothing at all
+	int lower_bound = heuristic_is_admissible() ? start_state->heuristic_cost + 1 : -1;
+	if(lowest != -1 && heuristic_proves_optimality() && lowest + 1 > lower_bound){
+		lower_bound = lowest + 1;
+	}
+
+	struct state* closest_state = closest_node == NO_NODE ? NULL : node_store_path(store, closest_node);
+	int pathlen = print_partial_path(closest_state, N);
+
+	printf("------------- Program Running Statistics -------------\n\n");
+	print_search_stopped(&control, lower_bound, num_expansions);
+	if(closest_state != NULL){
+		printf("Best partial path length: %d, ending %d moves or more from the goal\n", pathlen, closest_state->heuristic_cost);
+	}
+	printf("Unique configurations generated by solver: %d\n", num_unique_configs);
+	printf("Memory consumed: %.2f MB\n", node_store_megabytes(store));
+	printf("Heuristic: %s\n", heuristic_name());
+	print_checkpoint_stats(&checkpointer);
+	printf("Total CPU time spent: %.7f seconds\n\n", (double)(clock() - begin_CPU) / CLOCKS_PER_SEC);
+	printf("------------------------------------------------------\n\n");
+}
+
+
+/**
+ * Fill in a checkpoint header with what the search is and where it is
+ */
+static void describe_search(struct checkpoint_header* header, int num_unique_configs, const int N){
+	memset(header, 0, sizeof(struct checkpoint_header));
+	memcpy(header->magic, CHECKPOINT_MAGIC, 8);
+	header->N = N;
+	snprintf(header->heuristic, sizeof(header->heuristic), "%s", heuristic_name());
+	header->weight = heuristic_weight();
+	header->perimeter = perimeter == NULL ? 0 : perimeter->depth;
+	header->expanded = num_expansions;
+	header->generated = num_unique_configs;
+	header->batches = num_batches;
+	header->layer_cost = layer_cost;
+	header->layer_expansions = layer_expansions;
+	header->closest_node = closest_node;
+	header->pending_goal = pending_goal;
+	header->incumbent_node = incumbent_node;
+	header->incumbent_cost = incumbent_cost;
+}
+
+
+/**
+ * Pick the search back up from a checkpoint. The node store and the open list come back exactly as they were, so the
+ * search goes on just as if it had never stopped, and finds the same optimal solution. That only holds for the same
+ * puzzle with the same heuristic, weight and perimeter, so anything else is refused. Returns 0 on success, or -1 on
+ * failure, in which case an error has already been printed
+ */
+static int resume_search(struct state* start_state, int* num_unique_configs, const int N){
+	struct checkpoint_header header;
+	store = read_checkpoint(resume_file, &header);
+	if(store == NULL){
+		return -1;
+	}
+
+	//The start state is always the first node
+	int depth = perimeter == NULL ? 0 : perimeter->depth;
+	if(header.N != N || strcmp(header.heuristic, heuristic_name()) != 0 || header.weight != heuristic_weight()
+	   || header.perimeter != depth || store->count == 0 || node_store_find(store, start_state) != 0){
+		printf("ERROR. %s was saved by a search for another puzzle, or with another heuristic, weight or perimeter:\n", resume_file);
+		printf("%dx%d, heuristic %s, weight %.2f, perimeter %d.\n", header.N, header.N, header.heuristic, header.weight, header.perimeter);
+		return -1;
+	}
+
+	num_expansions = header.expanded;
+	*num_unique_configs = header.generated;
+	num_batches = header.batches;
+	layer_cost = header.layer_cost;
+	layer_expansions = header.layer_expansions;
+	closest_node = header.closest_node;
+	pending_goal = header.pending_goal;
+	incumbent_node = header.incumbent_node;
+	incumbent_cost = header.incumbent_cost;
+
+	printf("Resuming from %s: %d states expanded, %u nodes, %u in the open list\n", resume_file, num_expansions, store->count, store->open_count);
+	return 0;
+}
+
+
+/**
+ * Save a search that is about to stop, so that it can be resumed, if the user asked for checkpoints
+ */
+static void save_stopped_search(int num_unique_configs, const int N){
+	if(checkpointer.path == NULL){
+		return;
+	}
+
+	struct checkpoint_header header;
+	describe_search(&header, num_unique_configs, N);
+	if(write_checkpoint(&checkpointer, &header, store) == 0){
+		printf("Search saved to %s, pick it back up with --resume %s\n", checkpointer.path, checkpointer.path);
+	} else {
+		printf("Could not save the search to %s.\n", checkpointer.path);
 	}
-	//Put upMove into the array
-	successors[3] = upMove;
 }
 
 
@@ -89,36 +559,95 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 	//Get the CPU clock start time
 	clock_t begin_CPU = clock();
 
-	//We will keep track of the number of iterations as a sanity check for large problems
-	int iteration = 0;
 	//Keep track of the number of unique configurations made
 	int num_unique_configs = 0;
-	//Define an array for holding successor states. We can generate at most 4 each time
-	struct state* successors[4];
+	//The moves of the solution, for the solution cache
+	char moves[MAX_CACHED_MOVES];
 
-	//Initialize the closed and fringe data structures 
-	initialize_closed();
-	initialize_fringe();
+	//If this instance(or its reflection) was solved before, there's nothing to search
+	if(solution_cache != NULL){
+		int length = solution_cache_lookup(solution_cache, start_state, moves);
+		if(length != -1){
+			print_cached_solution(start_state, moves, length, N);
+			return 0;
+		}
+	}
+
+	//Set up the node store, or read it back in, and the states that nodes are expanded in
+	if(resume_file != NULL){
+		if(resume_search(start_state, &num_unique_configs, N) != 0){
+			return 1;
+		}
+	} else {
+		store = create_node_store(DEFAULT_NODE_STORE_BITS, N);
+	}
+	for(int i = 0; i < MAX_BATCH; i++){
+		initialize_state(&expanded_states[i], N);
+	}
+	for(int i = 0; i < MAX_BATCH * 4; i++){
+		initialize_state(&successor_states[i], N);
+	}
 
-	//Put the start state into the fringe to begin the search
-	priority_queue_insert(start_state);
+	//Evaluate the start state and put it into the open list to begin the search. A resumed search already has it
+	update_heuristic(start_state, N, cache);
+	apply_perimeter(start_state);
+	if(resume_file == NULL){
+		int is_new;
+		open_list_push(store, start_state->total_cost, node_store_add(store, start_state, NO_NODE, NO_MOVE, &is_new));
+		record_incumbent(0, start_state);
+	}
 	
 	//Maintain a pointer for the current state in the search
 	struct state* curr_state;
 
-	//Algorithm main loop -- while there are still states to be expanded, keep iterating until we find a solution
-	while (!fringe_empty()){
-		//Remove or "pop" the head of the fringe linked list -- because fringe is a priority queue, this is the most
-		//promising state to explore next
-		curr_state = dequeue();
+	//Algorithm main loop -- while there are still nodes to be expanded, keep iterating until we find a solution
+	while (!open_list_empty(store) || pending_goal.id != NO_NODE || incumbent_node != NO_NODE){
+		//Give up with what we have once the deadline or node limit runs out, or if someone cancels the search
+		if(search_stopped(&control) != SEARCH_RUNNING){
+			save_stopped_search(num_unique_configs, N);
+			print_stopped_search(start_state, num_unique_configs, begin_CPU, N);
+			return SEARCH_STOPPED_EXIT;
+		}
+
+		//Once nothing left open can beat the best path through the perimeter, the search is over
+		struct state* solution_end = NULL;
+		struct open_entry entry = pending_goal;
+		if(incumbent_wins()){
+			solution_end = finish_from_perimeter(node_store_path(store, incumbent_node), N);
+		} else {
+			//Remove or "pop" the head of the open list -- because it is a priority queue, this is the most promising node
+			//to explore next. Stale entries for nodes that were already expanded are skipped
+			if(pending_goal.id != NO_NODE){
+				pending_goal.id = NO_NODE;
+			} else if(!pop_unexpanded(&entry)){
+				continue;
+			}
+
+			curr_state = &expanded_states[0];
+			load_expanded(entry, curr_state, N);
+
+			//Inside the perimeter, the rest of the way to the goal is already known. The node has the lowest cost in the
+			//open list, and its heuristic is exact, so the path through it is as short as any other. The incumbent
+			//always gets there first, so this is only a safety net
+			if(in_perimeter(curr_state)){
+				solution_end = finish_from_perimeter(node_store_path(store, entry.id), N);
+			} else if(states_same(curr_state, goal_state, N)){
+				solution_end = node_store_path(store, entry.id);
+			}
+		}
 
 		//Check to see if we have found the solution. If we did, we will print out the solution path and stop
-		if(states_same(curr_state, goal_state, N)){
+		if(solution_end != NULL){
+			//A checkpoint may still be being written, and its writer has to be waited on
+			finish_checkpoints(&checkpointer);
+			curr_state = solution_end;
 			//Stop the clock if we find solution
 			clock_t end_CPU = clock();
 
 			//Determine the time spent for CPU time 
 			double time_spent_CPU = (double)(end_CPU - begin_CPU) / CLOCKS_PER_SEC;
+			//Remember the solution's cost before we walk back up the path
+			int solution_cost = curr_state->total_cost;
 
 			//Now find the solution path
 			//Keep track of how long the path is	
@@ -141,20 +670,50 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 			//Display the path length for the user
 			printf("Path Length: %d\n\n", pathlen); 
 
-			//Print out the solution path in order
-			while(solution_path != NULL){
+			//Print out the solution path in order, noting each move along the way
+			for(int i = 0; solution_path != NULL; i++){
 				print_state(solution_path, N, 0);
+				if(solution_path->next != NULL && i < MAX_CACHED_MOVES){
+					moves[i] = move_between(solution_path, solution_path->next);
+				}
 				solution_path = solution_path->next;
-			}	
+			}
+
+			//Only optimal solutions are worth keeping
+			if(solution_cache != NULL && heuristic_proves_optimality()){
+				solution_cache_insert(solution_cache, start_state, moves, pathlen - 1);
+			}
 
 			//Print out all running statistics
 			printf("------------- Program Running Statistics -------------\n\n");
-			//Print out the path length
-			printf("Optimal solution path length: %d\n", pathlen);
+			//Print out the path length. Weighted and overlapping heuristics can't promise that it's optimal
+			print_solution_path_length(pathlen);
 			//Print out the number of unique configurations generated
 			printf("Unique configurations generated by solver: %d\n", num_unique_configs);
+			//Print out how much expanding was done, and how much of it was on the last cost layer, the only one where batching
+			//can add work. Compare it with a run without --batch to see how much it added
+			if(batch_size > 1){
+				printf("States expanded: %d, in %d batches of up to %d(%.2f on average)\n", num_expansions, num_batches, batch_size, (double)num_expansions / num_batches);
+			} else {
+				printf("States expanded: %d\n", num_expansions);
+			}
+			printf("States expanded on the last f layer(f = %d): %d\n", solution_cost, layer_cost == solution_cost ? layer_expansions : 0);
+			//Print out how much of the end of the path the perimeter saved us from searching
+			if(perimeter != NULL){
+				printf("Perimeter: depth %d, the last %d moves needed no search\n", perimeter->depth, perimeter_moves);
+			}
 			//Print out total memory consumption in Megabytes
-			printf("Memory consumed: %.2f MB\n", (sizeof(struct state) + N*N*sizeof(short)) * num_unique_configs / 1048576.0);
+			printf("Memory consumed: %.2f MB\n", node_store_megabytes(store));
+			//Print out which heuristic was used
+			printf("Heuristic: %s\n", heuristic_name());
+			//Print out how well the heuristic cache did
+			if(cache != NULL){
+				print_heuristic_cache_stats(cache);
+			}
+			//Print out whether the tables got the huge pages and NUMA placement that were asked for
+			print_table_memory_stats();
+			//Print out how many checkpoints were saved along the way
+			print_checkpoint_stats(&checkpointer);
 			//Print out CPU time(NOT wall time) spent
 			printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);	
 			printf("------------------------------------------------------\n\n");
@@ -163,42 +722,28 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 			return 0;	
 		}
 
-		//Generate successors to the current state once we know it isn't a solution
-		generate_successors(curr_state, successors, N);
-
-		//Go through each of the successor states, and check for repetition/update prediction function
-		for(int i = 0; i < 4; i++){
-			//If the state is already null, there is no point in further exploration
-			if(successors[i] == NULL){
-				continue;
-			}
-
-			//Check each successor state against fringe and closed to see if it is repeating
-			//Check the current state in the closed array
-			check_repeating_closed(&(successors[i]), N);
-			//Check against fringe
-			check_repeating_fringe(&(successors[i]), N);
-			//Update the prediction function on states that don't repeat
-			update_prediction_function(successors[i], N); 
+		//Expand many nodes at once if the user asked for it
+		if(batch_size > 1){
+			int expanded_before = num_expansions;
+			num_unique_configs += expand_batch(entry, goal_state, N);
+			search_should_stop(&control, num_expansions - expanded_before);
+		} else {
+			num_unique_configs += expand(entry, curr_state, N);
+			search_should_stop(&control, 1);
 		}
 
-		//Add all necessary states to fringe now that we have checked for repeats and updated predictions 
-		//Additionally, we need to update the num_unique_configs, this will be done in merge_to_fringe 
-		num_unique_configs += merge_to_fringe(successors); 
-
-		//Merge the current state into closed
-		merge_to_closed(curr_state);
+		//For very complex problems, let the progress reporter know how far along we are
+		publish_progress(&progress, num_expansions, num_unique_configs, entry.f, store->open_count, num_expansions);
 
-		//For very complex problems, print the iteration count to the console for a sanity check
-		if(iteration > 1 && iteration % 1000 == 0) {
-			printf("Iteration: %6d, %6d total unique states generated\n", iteration, num_unique_configs);
+		//Every so often, save the whole search so that a restart doesn't have to begin again
+		if(checkpoint_due(&checkpointer)){
+			struct checkpoint_header header;
+			describe_search(&header, num_unique_configs, N);
+			write_checkpoint_async(&checkpointer, &header, store);
 		}
-		
-		//End of one full iteration
-		iteration++;
 	}
 	
-	//If we end up here, fringe became NULL with no goal configuration found, so there is no solution
+	//If we end up here, the open list emptied out with no goal configuration found, so there is no solution
 	printf("No solution.\n");
 	
 	return 0;
@@ -212,12 +757,27 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 int main(int argc, char** argv){
 	//The size of our N puzzle
 	int N;
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
 
 	//If the user put in a non-integer or nonpositive integer, print an error
-	if(sscanf(argv[1], "%d", &N) != 1 || N < 1){
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1){
 		printf("Incorrect type of program arguments.\n");
-		printf("Usage: ./solve <N> <n0. . .nN>\n");
+		printf("Usage: ./solve [options] <N> <n0. . .nN>\n");
 		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
 		return 1;
 	}
 
@@ -225,8 +785,9 @@ int main(int argc, char** argv){
 	if(argc != N*N + 2){
 		//Give an error message
 		printf("Incorrect number of program arguments.\n");
-		printf("Usage: ./solve <N> <n0. . .nN>\n");
+		printf("Usage: ./solve [options] <N> <n0. . .nN>\n");
 		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
 		return 1;
 	}
 
@@ -238,8 +799,55 @@ int main(int argc, char** argv){
 	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
 
 	//Initialize the goal and start states 
-	initialize_start_goal(argv, start_state, goal_state, N);
+	if(initialize_start_goal(argv, start_state, goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//Load or build everything the heuristic needs once, up front
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+
+	//Create the heuristic cache, unless the user turned it off
+	cache = create_heuristic_cache_for(&options);
+	batch_size = options.batch;
+
+	//The perimeter and the solution cache only know about the standard goal, so a goal that couldn't be relabeled onto it
+	//is searched for without them
+	if(goal_target_positions() != NULL && (options.perimeter > 0 || options.solution_cache != NULL)){
+		printf("The perimeter and the solution cache only work for the standard goal, so the search goes on without them.\n");
+		options.perimeter = 0;
+		options.solution_cache = NULL;
+	}
+
+	//Load the perimeter, building it first if this is the first time for this N and depth
+	if(options.perimeter > 0){
+		char filename[256];
+		sprintf(filename, "pattern_databases/%d.perimeter%d", N, options.perimeter);
+		perimeter = load_perimeter(filename, options.perimeter, options.memory_limit, N);
+		if(perimeter == NULL){
+			return 1;
+		}
+	}
+
+	//Open the solution cache if the user gave one. It's only a speedup, so the search goes on without it if it can't be used
+	if(options.solution_cache != NULL){
+		solution_cache = open_solution_cache(options.solution_cache, options.solution_cache_size, N);
+	}
+
+	//Save the search as the user asked, or pick up an old one
+	start_checkpointer(&checkpointer, &options);
+	resume_file = options.resume;
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Progress is reported from its own thread, so the search never waits on the output
+	struct progress_reporter* reporter = start_progress_reporter(&progress, &options);
 
 	//Call the solve() funciton and hand off the rest of the program execution to it
-	return solve(N, start_state, goal_state);
+	int result = solve(N, start_state, goal_state);
+	stop_progress_reporter(reporter);
+	return result;
 }
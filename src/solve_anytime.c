@@ -0,0 +1,619 @@
+/**
+ * Author: Jack Robbins
+ * This program implements an anytime repairing A* search(ARA*) for the N-puzzle problem. It takes in an N-puzzle problem
+ * starting configuration in row-major order as a command line argument, following a number N for the NxN size of the
+ * puzzle. It prints a solution as soon as it has one, keeps printing better solutions as it finds them, and finally prints
+ * the full path of the best solution it found.
+ *
+ * The search starts out as weighted A*, ordering states by g + w*h, which finds a solution at most w times longer than
+ * optimal very quickly. Then w is lowered and the search continues, reusing everything it has already found. States whose
+ * g improved after they were expanded are set aside(the inconsistent list) and go back onto the open list for the next
+ * round, so no work is thrown away. After every round, the solver prints the length of its best solution along with a
+ * bound on how far from optimal it can be, which is the smaller of w and the best length divided by the smallest g + h on
+ * the open and inconsistent lists. It stops once that bound reaches 1(optimal), or when the deadline or node limit runs
+ * out, or when it's cancelled with Ctrl-C.
+ *
+ * Note: This is the anytime version of the solver
+ */
+
+//For timing
+#include <time.h>
+//For DBL_MAX
+#include <float.h>
+#include "npuzzle.h"
+
+
+//Define an initial starting size for the open heap and the state table
+#define INITIAL_HEAP_SIZE 5000
+#define INITIAL_TABLE_SIZE 8192
+//The weight that the first round uses if the user didn't pick one
+#define DEFAULT_INITIAL_WEIGHT 3.0
+
+
+/**
+ * Every state that ARA* has generated, along with its bookkeeping
+ */
+struct anytime_node{
+	//The state itself. current_travel is g, heuristic_cost is the unweighted h, and predecessor is the best parent
+	struct state* state;
+	//The key that the open heap is ordered by, g + w*h with the w at the time the node was last queued
+	double key;
+	//Where this node is in the open heap, or -1 if it isn't open
+	int heap_index;
+	//The round this node was last expanded in, so closed can be cleared by starting a new round
+	int closed_round;
+	//1 if this node is on the inconsistent list
+	int inconsistent;
+	//The next node in the same bucket of the state table, and the next node on the inconsistent list
+	struct anytime_node* next_in_bucket;
+	struct anytime_node* next_inconsistent;
+};
+
+
+/*================================= Global variables for convenience =========================== */
+//The heuristic cache that sits in front of the heuristic, NULL if turned off
+struct heuristic_cache* cache = NULL;
+//The open list, maintained as a minHeap ordered by key
+struct anytime_node** heap;
+int heap_size = 0, heap_max_size = INITIAL_HEAP_SIZE;
+//A chained hash table of every node ever generated
+struct anytime_node** table;
+int table_size = INITIAL_TABLE_SIZE, table_count = 0;
+//States whose g improved after they were expanded this round
+struct anytime_node* inconsistent_list = NULL;
+//The current weight and round
+double current_weight;
+int current_round = 1;
+//Running statistics
+long expansions = 0;
+//The deadline and node limit, and whether the search was cancelled
+struct search_control control;
+/*============================================================================================== */
+
+
+/**
+ * The key of a node under the current weight
+ */
+static double node_key(struct anytime_node* node){
+	return node->state->current_travel + current_weight * node->state->heuristic_cost;
+}
+
+
+/**
+ * Whether node a should come out of the heap before node b. Ties go to the deeper node
+ */
+static int comes_before(struct anytime_node* a, struct anytime_node* b){
+	if(a->key != b->key){
+		return a->key < b->key;
+	}
+
+	return a->state->current_travel > b->state->current_travel;
+}
+
+
+/**
+ * Put a node at an index in the heap, keeping its heap_index up to date
+ */
+static void heap_place(struct anytime_node* node, int index){
+	heap[index] = node;
+	node->heap_index = index;
+}
+
+
+/**
+ * Move the node at index up the heap until its parent comes before it
+ */
+static void sift_up(int index){
+	struct anytime_node* node = heap[index];
+
+	while(index > 0 && comes_before(node, heap[(index - 1) / 2])){
+		heap_place(heap[(index - 1) / 2], index);
+		index = (index - 1) / 2;
+	}
+
+	heap_place(node, index);
+}
+
+
+/**
+ * Move the node at index down the heap until it comes before both of its children
+ */
+static void sift_down(int index){
+	struct anytime_node* node = heap[index];
+
+	while(1){
+		int child = index * 2 + 1;
+
+		if(child >= heap_size){
+			break;
+		}
+		if(child + 1 < heap_size && comes_before(heap[child + 1], heap[child])){
+			child++;
+		}
+		if(!comes_before(heap[child], node)){
+			break;
+		}
+
+		heap_place(heap[child], index);
+		index = child;
+	}
+
+	heap_place(node, index);
+}
+
+
+/**
+ * Put a node on the open heap, or move it up if it is already there and its key went down
+ */
+static void open_push(struct anytime_node* node){
+	node->key = node_key(node);
+
+	if(node->heap_index >= 0){
+		sift_up(node->heap_index);
+		return;
+	}
+
+	if(heap_size == heap_max_size){
+		heap_max_size *= 2;
+		heap = (struct anytime_node**)realloc(heap, sizeof(struct anytime_node*) * heap_max_size);
+	}
+
+	heap[heap_size] = node;
+	sift_up(heap_size++);
+}
+
+
+/**
+ * Take the node with the smallest key off of the open heap
+ */
+static struct anytime_node* open_pop(){
+	struct anytime_node* node = heap[0];
+	node->heap_index = -1;
+
+	heap_size--;
+	if(heap_size > 0){
+		heap_place(heap[heap_size], 0);
+		sift_down(0);
+	}
+
+	return node;
+}
+
+
+/**
+ * Rebuild the heap from scratch, after the weight changes every key
+ */
+static void open_rebuild(){
+	for(int i = 0; i < heap_size; i++){
+		heap[i]->key = node_key(heap[i]);
+	}
+
+	for(int i = heap_size / 2 - 1; i >= 0; i--){
+		sift_down(i);
+	}
+}
+
+
+/**
+ * Find the bucket of the state table that a state belongs in
+ */
+static int table_bucket(struct state* statePtr, const int N){
+	return hash_state(statePtr, N) & (table_size - 1);
+}
+
+
+/**
+ * Find the node holding the same tiles as statePtr, or NULL if it has never been generated
+ */
+static struct anytime_node* table_lookup(struct state* statePtr, const int N){
+	struct anytime_node* cursor = table[table_bucket(statePtr, N)];
+
+	while(cursor != NULL && !states_same(cursor->state, statePtr, N)){
+		cursor = cursor->next_in_bucket;
+	}
+
+	return cursor;
+}
+
+
+/**
+ * Add a brand new node to the state table, doubling the table when it gets as many nodes as it has buckets
+ */
+static void table_insert(struct anytime_node* node, const int N){
+	if(table_count == table_size){
+		struct anytime_node** old_table = table;
+		int old_size = table_size;
+
+		table_size *= 2;
+		table = (struct anytime_node**)calloc(table_size, sizeof(struct anytime_node*));
+
+		for(int i = 0; i < old_size; i++){
+			struct anytime_node* cursor = old_table[i];
+			while(cursor != NULL){
+				struct anytime_node* next = cursor->next_in_bucket;
+				int bucket = table_bucket(cursor->state, N);
+				cursor->next_in_bucket = table[bucket];
+				table[bucket] = cursor;
+				cursor = next;
+			}
+		}
+
+		free(old_table);
+	}
+
+	int bucket = table_bucket(node->state, N);
+	node->next_in_bucket = table[bucket];
+	table[bucket] = node;
+	table_count++;
+}
+
+
+/**
+ * Make a node for a state that has never been seen before. The node takes over the state's memory
+ */
+static struct anytime_node* create_node(struct state* statePtr, const int N){
+	struct anytime_node* node = (struct anytime_node*)malloc(sizeof(struct anytime_node));
+	node->state = statePtr;
+	node->heap_index = -1;
+	node->closed_round = 0;
+	node->inconsistent = 0;
+	node->next_inconsistent = NULL;
+	table_insert(node, N);
+	return node;
+}
+
+
+/**
+ * Expand states in order of their keys until nothing left on the open list could lead to a better solution than the
+ * one we have under the current weight. Returns 0 if it finished, or 1 if the search had to stop first
+ */
+static int improve_path(struct anytime_node* goal, const int N){
+	//Used to make successors, only kept when it turns out to be new
+	struct state* successor = (struct state*)malloc(sizeof(struct state));
+	initialize_state(successor, N);
+
+	while(heap_size > 0){
+		//Once we have a solution, anything with a bigger key can't improve it
+		if(goal->state->current_travel >= 0 && heap[0]->key >= goal->state->current_travel){
+			break;
+		}
+
+		//Give up once the deadline or node limit runs out, or if someone cancels the search
+		if(search_stopped(&control) != SEARCH_RUNNING){
+			destroy_state(successor);
+			free(successor);
+			return 1;
+		}
+
+		struct anytime_node* current = open_pop();
+		current->closed_round = current_round;
+		expansions++;
+		search_should_stop(&control, 1);
+
+		//Make every successor. 0 = left, 1 = right, 2 = down, 3 = up
+		for(int move = 0; move < 4; move++){
+			if((move == 0 && current->state->zero_column == 0) || (move == 1 && current->state->zero_column == N - 1)
+			   || (move == 2 && current->state->zero_row == N - 1) || (move == 3 && current->state->zero_row == 0)){
+				continue;
+			}
+
+			copy_state(current->state, successor, N);
+			if(move == 0){
+				move_left(successor, N);
+			} else if(move == 1){
+				move_right(successor, N);
+			} else if(move == 2){
+				move_down(successor, N);
+			} else {
+				move_up(successor, N);
+			}
+
+			struct anytime_node* node = table_lookup(successor, N);
+
+			//Never seen before, so evaluate it and give it a node of its own
+			if(node == NULL){
+				update_heuristic(successor, N, cache);
+				node = create_node(successor, N);
+				successor = (struct state*)malloc(sizeof(struct state));
+				initialize_state(successor, N);
+				open_push(node);
+				continue;
+			}
+
+			//Nothing to do unless we found a shorter way to it
+			if(node->state->current_travel >= 0 && node->state->current_travel <= current->state->current_travel + 1){
+				continue;
+			}
+
+			node->state->current_travel = current->state->current_travel + 1;
+			node->state->predecessor = current->state;
+
+			//Expanded this round already, so it waits for the next round
+			if(node->closed_round == current_round){
+				if(!node->inconsistent){
+					node->inconsistent = 1;
+					node->next_inconsistent = inconsistent_list;
+					inconsistent_list = node;
+				}
+			} else {
+				open_push(node);
+			}
+		}
+	}
+
+	destroy_state(successor);
+	free(successor);
+	return 0;
+}
+
+
+/**
+ * The smallest g + h of anything on the open or inconsistent lists, no more than limit. Every path that hasn't been
+ * looked at goes through one of them, so this is a lower bound on the optimal solution
+ */
+static int lowest_open_cost(int limit){
+	int smallest = limit;
+
+	for(int i = 0; i < heap_size; i++){
+		int f = heap[i]->state->current_travel + heap[i]->state->heuristic_cost;
+		if(f < smallest){
+			smallest = f;
+		}
+	}
+	for(struct anytime_node* cursor = inconsistent_list; cursor != NULL; cursor = cursor->next_inconsistent){
+		int f = cursor->state->current_travel + cursor->state->heuristic_cost;
+		if(f < smallest){
+			smallest = f;
+		}
+	}
+
+	return smallest;
+}
+
+
+/**
+ * How far from optimal the current solution can be: the smaller of the cap and the solution length divided by the
+ * smallest g + h of anything on the open or inconsistent lists. The cap is the weight after a finished round, and the
+ * previous bound after a round that was cut short
+ */
+static double suboptimality_bound(struct anytime_node* goal, double cap){
+	int smallest = lowest_open_cost(goal->state->current_travel);
+	double bound = smallest > 0 ? (double)goal->state->current_travel / smallest : 1.0;
+	return bound < cap ? bound : cap;
+}
+
+
+/**
+ * Use ARA* to solve the N-puzzle problem, printing every improved solution as it is found, and the path of the best one
+ * at the end
+ */
+int solve(int N, struct state* start_state, struct state* goal_state, double initial_weight){
+	//Get the CPU clock start time
+	clock_t begin_CPU = clock();
+
+	heap = (struct anytime_node**)malloc(sizeof(struct anytime_node*) * heap_max_size);
+	table = (struct anytime_node**)calloc(table_size, sizeof(struct anytime_node*));
+	current_weight = initial_weight;
+
+	//The goal gets a node up front with no known g(-1), so that we always know how good our solution is
+	struct state* goal_copy = (struct state*)malloc(sizeof(struct state));
+	initialize_state(goal_copy, N);
+	copy_state(goal_state, goal_copy, N);
+	goal_copy->current_travel = -1;
+	goal_copy->heuristic_cost = 0;
+	goal_copy->predecessor = NULL;
+	struct anytime_node* goal = create_node(goal_copy, N);
+
+	//The start state may be the goal itself
+	struct anytime_node* start = table_lookup(start_state, N);
+	if(start == NULL){
+		start_state->current_travel = 0;
+		start_state->predecessor = NULL;
+		update_heuristic(start_state, N, cache);
+		start = create_node(start_state, N);
+	}
+	start->state->current_travel = 0;
+	open_push(start);
+
+	int best_length = -1;
+	double best_bound = 0;
+	int stopped = 0;
+
+	printf("\n");
+
+	//Every round lowers the weight, until the solution is optimal or we run out of time
+	while(1){
+		stopped = improve_path(goal, N);
+
+		//Publish the solution if this round improved it
+		if(goal->state->current_travel >= 0){
+			//A round that was cut short only guarantees the ratio, and whatever the previous round guaranteed
+			double cap = current_weight;
+			if(stopped){
+				cap = best_length != -1 ? best_bound : DBL_MAX;
+			}
+			double bound = suboptimality_bound(goal, cap);
+			if(goal->state->current_travel != best_length || bound < best_bound){
+				best_length = goal->state->current_travel;
+				best_bound = bound;
+				printf("Round %2d, weight %.3f: solution of length %d, at most %.3f times optimal, %.1f ms, %ld expansions\n",
+					   current_round, current_weight, best_length + 1, best_bound, search_seconds(&control) * 1000.0, expansions);
+				fflush(stdout);
+			}
+
+			if(best_bound <= 1.0){
+				break;
+			}
+		}
+
+		if(stopped || (heap_size == 0 && inconsistent_list == NULL)){
+			break;
+		}
+
+		//Halve the distance to a weight of 1, and snap to 1 once we're close
+		current_weight = 1.0 + (current_weight - 1.0) / 2.0;
+		if(current_weight < 1.01){
+			current_weight = 1.0;
+		}
+
+		//Everything that became inconsistent goes back onto the open list, and closed is emptied by starting a new round
+		while(inconsistent_list != NULL){
+			struct anytime_node* node = inconsistent_list;
+			inconsistent_list = node->next_inconsistent;
+			node->inconsistent = 0;
+			open_push(node);
+		}
+		open_rebuild();
+		current_round++;
+	}
+
+	//Stop the clock
+	clock_t end_CPU = clock();
+	double time_spent_CPU = (double)(end_CPU - begin_CPU) / CLOCKS_PER_SEC;
+
+	//Nothing on the open or inconsistent lists can lead to a shorter solution than their lowest g + h
+	int lower_bound = start_state->heuristic_cost;
+	if(stopped){
+		lower_bound = lowest_open_cost(best_length != -1 ? best_length : __INT_MAX__);
+	}
+
+	if(best_length == -1){
+		if(!stopped){
+			printf("No solution.\n");
+			return 0;
+		}
+
+		printf("\nSearch stopped before a solution was found, so there is no path to show\n");
+		printf("------------- Program Running Statistics -------------\n\n");
+		//Plus one since path lengths count the start state
+		print_search_stopped(&control, lower_bound + 1, expansions);
+		printf("Heuristic: %s\n", heuristic_name());
+		printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);
+		printf("------------------------------------------------------\n\n");
+		return SEARCH_STOPPED_EXIT;
+	}
+
+	//Put the states into the solution path in reverse order(insert at the head) using their predecessor
+	struct state* solution_path = NULL;
+	int pathlen = 0;
+	for(struct state* cursor = goal->state; cursor != NULL; cursor = cursor->predecessor){
+		cursor->next = solution_path;
+		solution_path = cursor;
+		pathlen++;
+	}
+
+	//Print out the solution path first
+	printf("\nSolution found! Now displaying solution path\n");
+	//Display the path length for the user
+	printf("Path Length: %d\n\n", pathlen);
+
+	//Print out the solution path in order
+	while(solution_path != NULL){
+		print_state(solution_path, N, 0);
+		solution_path = solution_path->next;
+	}
+
+	//Print out all running statistics
+	printf("------------- Program Running Statistics -------------\n\n");
+	//Print out the path length, and how good it is guaranteed to be
+	if(best_bound <= 1.0){
+		printf("Optimal solution path length: %d\n", pathlen);
+	} else {
+		printf("Solution path length: %d, at most %.3f times optimal\n", pathlen, best_bound);
+		print_search_stopped(&control, lower_bound + 1, expansions);
+	}
+	//Print out the work done
+	printf("Rounds: %d, expansions: %ld, unique configurations generated by solver: %d\n", current_round, expansions, table_count);
+	//Print out total memory consumption in Megabytes
+	printf("Memory consumed: %.2f MB\n", (sizeof(struct anytime_node) + sizeof(struct state) + N*N*sizeof(short)) * table_count / 1048576.0);
+	//Print out which heuristic was used
+	printf("Heuristic: %s\n", heuristic_name());
+	//Print out how well the heuristic cache did
+	if(cache != NULL){
+		print_heuristic_cache_stats(cache);
+	}
+	//Print out CPU time(NOT wall time) spent
+	printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);
+	printf("------------------------------------------------------\n\n");
+
+	return best_bound <= 1.0 ? 0 : SEARCH_STOPPED_EXIT;
+}
+
+
+/**
+ * The main function simply makes the needed calls to the initialize and solve function after checking command
+ * line arguments
+ */
+int main(int argc, char** argv){
+	//The size of our N puzzle
+	int N;
+	//Manhattan distance plus linear conflict by default, starting out with a large weight
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+	options.weight = DEFAULT_INITIAL_WEIGHT;
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
+
+	//If the user put in a non-integer or nonpositive integer, print an error
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1){
+		printf("Incorrect type of program arguments.\n");
+		printf("Usage: ./solve_anytime [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n");
+		printf("--weight is the weight of the first round, default %.1f.\n\n", DEFAULT_INITIAL_WEIGHT);
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Check if the number of arguments is correct. If not, exit the program and print an error
+	if(argc != N*N + 2){
+		//Give an error message
+		printf("Incorrect number of program arguments.\n");
+		printf("Usage: ./solve_anytime [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n");
+		printf("--weight is the weight of the first round, default %.1f.\n\n", DEFAULT_INITIAL_WEIGHT);
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Important: Move the address of argv up by 1 so that initialize_start_goal can only see the initial config
+	argv += 1;
+
+	//The starting and goal states, must create and reserve space
+	struct state* start_state = (struct state*)malloc(sizeof(struct state));
+	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
+
+	//Initialize the goal and start states
+	if(initialize_start_goal(argv, start_state, goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//Every bound that this search proves rests on a heuristic that never overestimates
+	if(!heuristic_specification_admissible(options.heuristic)){
+		printf("ERROR. Heuristic %s adds overlapping heuristics, which can overestimate, so it is not supported by anytime search, use solve.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//Load or build everything the heuristic needs once, up front
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+
+	//Create the heuristic cache, unless the user turned it off
+	cache = create_heuristic_cache_for(&options);
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Call the solve() funciton and hand off the rest of the program execution to it
+	return solve(N, start_state, goal_state, options.weight);
+}
@@ -0,0 +1,684 @@
+/**
+ * Author: Jack Robbins
+ * This program implements a bidirectional heuristic search(MM, "meet in the middle") to find the shortest solve path
+ * for the N-puzzle problem. It takes in an N-puzzle problem starting configuration in row-major order as a command line
+ * argument, following a number N for the NxN size of the puzzle, and prints out the full solution path to the problem,
+ * step by step, if such a solution exists.
+ *
+ * One search runs forward from the start state towards the goal state, and a second search runs backward from the goal
+ * state towards the start state. Each direction uses the heuristic chosen with --heuristic, evaluated against the opposite
+ * endpoint, so only heuristics that support arbitrary targets(md and lc) can be used. Nodes are prioritized by MM's priority function
+ * pr(n) = max(f(n), 2g(n)), which guarantees that neither search goes past the midpoint of an optimal path.
+ *
+ * Note: This is the bidirectional version of the solver
+ */
+
+//For timing
+#include <time.h>
+#include "npuzzle.h"
+
+
+//Define an initial starting size for the open heaps and the state tables
+#define INITIAL_HEAP_SIZE 5000
+#define INITIAL_TABLE_SIZE 8192
+
+//Our two search directions
+#define FORWARD 0
+#define BACKWARD 1
+
+
+/*================================= Global variables for convenience =========================== */
+//The deadline and node limit, and whether the search was cancelled
+struct search_control control;
+//What the search has done so far, for the progress reporter
+struct search_progress progress;
+/*============================================================================================== */
+
+
+/**
+ * Each search direction keeps its own open list(a minHeap ordered by MM priority) and its own table of every
+ * state that it has generated, which doubles as the closed list
+ */
+struct search_side{
+	//The name of this direction, for printing statistics
+	const char* name;
+	//The open list, maintained as a minHeap of state pointers. Stale entries are skipped when dequeued
+	struct state** heap;
+	int heap_size, heap_max_size;
+	//An open addressing hash table of every state this side has generated
+	struct state** table;
+	//Whether or not the state in the same slot of table has been expanded
+	unsigned char* table_closed;
+	int table_size, table_count;
+	//How many open states we have at each travel cost, used to find the minimum g on the open list
+	int* open_g_count;
+	int open_g_max, open_g_min, num_open;
+	//Target positions of the opposite endpoint, used for the heuristic
+	short* target_positions;
+	//Each side has its own heuristic cache since each side has its own target, NULL if turned off
+	struct heuristic_cache* cache;
+	//Running statistics for this side
+	long expansions, generated;
+	int peak_open;
+};
+
+
+/**
+ * MM priority of a state -- the larger of f(n) and 2g(n)
+ */
+static int priority(struct state* statePtr){
+	//f is stored in total_cost, g is stored in current_travel
+	if(statePtr->total_cost > 2 * statePtr->current_travel){
+		return statePtr->total_cost;
+	}
+
+	return 2 * statePtr->current_travel;
+}
+
+
+/**
+ * A simple helper function that calculates the parent of a certain index in the minHeap
+ */
+static int parent_index(int index){
+	return (index - 1) / 2;
+}
+
+
+/**
+ * A simple helper function that will swap two pointers in our minHeap
+ */
+static void swap(struct state** a, struct state** b){
+	struct state* temp = *a;
+	*a = *b;
+	*b = temp;
+}
+
+
+/**
+ * Insert a state into the open heap of the given side, keyed by MM priority
+ */
+static void heap_insert(struct search_side* side, struct state* statePtr){
+	//Automatic resize
+	if(side->heap_size == side->heap_max_size){
+		side->heap_max_size *= 2;
+		side->heap = (struct state**)realloc(side->heap, sizeof(struct state*) * side->heap_max_size);
+	}
+
+	//Insert value at the very end
+	int current_index = side->heap_size;
+	side->heap[current_index] = statePtr;
+	side->heap_size++;
+
+	//Reheapify upwards
+	while(current_index > 0 && priority(side->heap[parent_index(current_index)]) > priority(side->heap[current_index])){
+		swap(&side->heap[parent_index(current_index)], &side->heap[current_index]);
+		current_index = parent_index(current_index);
+	}
+}
+
+
+/**
+ * Down heapify the open heap of the given side, starting at index
+ */
+static void min_heapify(struct search_side* side, int index){
+	//Iterative version of the usual recursive minHeapify
+	while(1){
+		int smallest = index;
+		int left_child = index * 2 + 1;
+		int right_child = index * 2 + 2;
+
+		if(left_child < side->heap_size && priority(side->heap[left_child]) < priority(side->heap[smallest])){
+			smallest = left_child;
+		}
+
+		if(right_child < side->heap_size && priority(side->heap[right_child]) < priority(side->heap[smallest])){
+			smallest = right_child;
+		}
+
+		//Heap property restored
+		if(smallest == index){
+			return;
+		}
+
+		swap(&side->heap[index], &side->heap[smallest]);
+		index = smallest;
+	}
+}
+
+
+/**
+ * Remove the top of the open heap of the given side
+ */
+static struct state* heap_dequeue(struct search_side* side){
+	struct state* dequeued = side->heap[0];
+
+	//Put the last element in the front to "prime" the heap
+	side->heap[0] = side->heap[side->heap_size - 1];
+	side->heap_size--;
+	min_heapify(side, 0);
+
+	return dequeued;
+}
+
+
+/**
+ * Find the slot in the state table of the given side that either holds a state equal to statePtr, or is the
+ * empty slot where statePtr belongs
+ */
+static int table_slot(struct search_side* side, struct state* statePtr, const int N){
+	//Table size is always a power of 2, so we can mask instead of modulo
+	int mask = side->table_size - 1;
+	int slot = hash_state(statePtr, N) & mask;
+
+	//Linear probing
+	while(side->table[slot] != NULL && !states_same(side->table[slot], statePtr, N)){
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+
+/**
+ * Double the size of the state table of the given side, rehashing everything that is in it
+ */
+static void table_grow(struct search_side* side, const int N){
+	struct state** old_table = side->table;
+	unsigned char* old_closed = side->table_closed;
+	int old_size = side->table_size;
+
+	side->table_size *= 2;
+	side->table = (struct state**)calloc(side->table_size, sizeof(struct state*));
+	side->table_closed = (unsigned char*)calloc(side->table_size, sizeof(unsigned char));
+
+	//Move every state over to the new table
+	for(int i = 0; i < old_size; i++){
+		if(old_table[i] != NULL){
+			int slot = table_slot(side, old_table[i], N);
+			side->table[slot] = old_table[i];
+			side->table_closed[slot] = old_closed[i];
+		}
+	}
+
+	free(old_table);
+	free(old_closed);
+}
+
+
+/**
+ * Keep track of how many open states there are at each travel cost, so that we can find the smallest
+ * g value on the open list cheaply. Delta is +1 when a state is opened, and -1 when it is closed or replaced
+ */
+static void update_open_g(struct search_side* side, int g, int delta){
+	//Grow the counter array as needed
+	if(g >= side->open_g_max){
+		int new_max = side->open_g_max;
+		while(g >= new_max){
+			new_max *= 2;
+		}
+		side->open_g_count = (int*)realloc(side->open_g_count, sizeof(int) * new_max);
+		memset(side->open_g_count + side->open_g_max, 0, sizeof(int) * (new_max - side->open_g_max));
+		side->open_g_max = new_max;
+	}
+
+	side->open_g_count[g] += delta;
+	side->num_open += delta;
+
+	//Keep track of the peak open list size for statistics
+	if(side->num_open > side->peak_open){
+		side->peak_open = side->num_open;
+	}
+
+	//A newly opened state may be the new minimum
+	if(delta > 0 && g < side->open_g_min){
+		side->open_g_min = g;
+	}
+}
+
+
+/**
+ * Smallest g value of any state on the open list of the given side
+ */
+static int open_g_min(struct search_side* side){
+	//Advance the cached minimum past empty buckets
+	while(side->open_g_min < side->open_g_max && side->open_g_count[side->open_g_min] == 0){
+		side->open_g_min++;
+	}
+
+	return side->open_g_min;
+}
+
+
+/**
+ * Evaluate the heuristic of a state against the opposite endpoint of the given side, going through
+ * the side's heuristic cache if it has one
+ */
+static int side_heuristic(struct search_side* side, struct state* statePtr, const int N){
+	int heuristic_cost;
+
+	//No cache, so just do the full calculation
+	if(side->cache == NULL){
+		return evaluate_target_heuristic(statePtr, side->target_positions, N);
+	}
+
+	//If we've seen this state before, we can skip the heuristic calculation entirely
+	unsigned long long key = hash_state(statePtr, N);
+	if(heuristic_cache_lookup(side->cache, key, &heuristic_cost)){
+		return heuristic_cost;
+	}
+
+	//Otherwise calculate it and remember it for next time
+	heuristic_cost = evaluate_target_heuristic(statePtr, side->target_positions, N);
+	heuristic_cache_store(side->cache, key, heuristic_cost);
+	return heuristic_cost;
+}
+
+
+/**
+ * Set up a search side that begins at root and uses target for its heuristic
+ */
+static void initialize_side(struct search_side* side, const char* name, struct state* root, struct state* target, int cache_bits,
+							const int N){
+	side->name = name;
+	side->heap_max_size = INITIAL_HEAP_SIZE;
+	side->heap = (struct state**)malloc(sizeof(struct state*) * side->heap_max_size);
+	side->heap_size = 0;
+	side->table_size = INITIAL_TABLE_SIZE;
+	side->table = (struct state**)calloc(side->table_size, sizeof(struct state*));
+	side->table_closed = (unsigned char*)calloc(side->table_size, sizeof(unsigned char));
+	side->table_count = 0;
+	side->open_g_max = 64;
+	side->open_g_count = (int*)calloc(side->open_g_max, sizeof(int));
+	side->open_g_min = 0;
+	side->num_open = 0;
+	side->target_positions = create_target_positions(target, N);
+	side->cache = cache_bits > 0 ? create_heuristic_cache(cache_bits) : NULL;
+	side->expansions = 0;
+	side->generated = 0;
+	side->peak_open = 0;
+
+	//The root needs its heuristic evaluated against the opposite endpoint
+	root->current_travel = 0;
+	root->heuristic_cost = side_heuristic(side, root, N);
+	root->total_cost = root->heuristic_cost;
+	root->predecessor = NULL;
+
+	//Put the root into the table and the open list
+	side->table[table_slot(side, root, N)] = root;
+	side->table_count++;
+	heap_insert(side, root);
+	update_open_g(side, 0, 1);
+}
+
+
+/**
+ * Look at the top of the open list of the given side, throwing away any stale entries that we find. Returns NULL if
+ * the open list is empty
+ */
+static struct state* peek_open(struct search_side* side, const int N){
+	while(side->heap_size > 0){
+		struct state* top = side->heap[0];
+		int slot = table_slot(side, top, N);
+
+		//Valid only if this is still the best copy of the state and it has not been expanded
+		if(side->table[slot] == top && !side->table_closed[slot]){
+			return top;
+		}
+
+		//Stale entry, throw it away
+		heap_dequeue(side);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Look up a state in the table of the given side. Returns NULL if the side has never generated it
+ */
+static struct state* table_lookup(struct search_side* side, struct state* statePtr, const int N){
+	return side->table[table_slot(side, statePtr, N)];
+}
+
+
+/**
+ * Expand the best open state on the given side. Every successor is checked against the opposite side to see if the two
+ * searches have met, and if so the best solution cost seen so far(best_cost) and the meeting states are updated
+ */
+static void expand(struct search_side* side, struct search_side* opposite, int* best_cost, struct state** meet_side,
+				   struct state** meet_opposite, const int N){
+	//Take the best state off of the open list, and mark it as closed
+	struct state* curr_state = peek_open(side, N);
+	heap_dequeue(side);
+	side->table_closed[table_slot(side, curr_state, N)] = 1;
+	update_open_g(side, curr_state->current_travel, -1);
+	side->expansions++;
+
+	//0 = left, 1 = right, 2 = down, 3 = up
+	for(int move = 0; move < 4; move++){
+		//Skip moves that are not possible from this state
+		if((move == 0 && curr_state->zero_column == 0) || (move == 1 && curr_state->zero_column == N-1)
+		   || (move == 2 && curr_state->zero_row == N-1) || (move == 3 && curr_state->zero_row == 0)){
+			continue;
+		}
+
+		//Create the successor
+		struct state* successor = (struct state*)malloc(sizeof(struct state));
+		initialize_state(successor, N);
+		copy_state(curr_state, successor, N);
+
+		if(move == 0){
+			move_left(successor, N);
+		} else if(move == 1){
+			move_right(successor, N);
+		} else if(move == 2){
+			move_down(successor, N);
+		} else {
+			move_up(successor, N);
+		}
+
+		//If we've already reached this state at least as cheaply, it's a repeat
+		int slot = table_slot(side, successor, N);
+		struct state* existing = side->table[slot];
+		if(existing != NULL && existing->current_travel <= successor->current_travel){
+			destroy_state(successor);
+			free(successor);
+			continue;
+		}
+
+		//Evaluate the heuristic against the opposite endpoint
+		successor->heuristic_cost = side_heuristic(side, successor, N);
+		successor->total_cost = successor->current_travel + successor->heuristic_cost;
+		side->generated++;
+
+		//We found a cheaper path to a known state, so the old copy becomes stale
+		if(existing != NULL){
+			if(!side->table_closed[slot]){
+				update_open_g(side, existing->current_travel, -1);
+			}
+		} else {
+			side->table_count++;
+		}
+
+		//Store the successor and put it on the open list
+		side->table[slot] = successor;
+		side->table_closed[slot] = 0;
+		heap_insert(side, successor);
+		update_open_g(side, successor->current_travel, 1);
+
+		//Check to see if the two searches have met, and if this gives us a better solution
+		struct state* match = table_lookup(opposite, successor, N);
+		if(match != NULL && successor->current_travel + match->current_travel < *best_cost){
+			*best_cost = successor->current_travel + match->current_travel;
+			*meet_side = successor;
+			*meet_opposite = match;
+		}
+
+		//Keep the table sparse
+		if(side->table_count * 2 > side->table_size){
+			table_grow(side, N);
+		}
+	}
+}
+
+
+/**
+ * Use an MM bidirectional search to solve the N-puzzle problem. If the solve function is successful, it will print the
+ * resulting solution path to the console as well.
+ */
+int solve(int N, struct state* start_state, struct state* goal_state, int cache_bits){
+	//Get the CPU clock start time
+	clock_t begin_CPU = clock();
+
+	//The forward side searches towards the goal, the backward side searches towards the start
+	struct search_side sides[2];
+	initialize_side(&sides[FORWARD], "Forward", start_state, goal_state, cache_bits, N);
+	initialize_side(&sides[BACKWARD], "Backward", goal_state, start_state, cache_bits, N);
+
+	//The best solution cost found so far, and the forward and backward states where the two searches met
+	int best_cost = 1 << 30;
+	//The lowest cost that any solution could still have, as of the last iteration
+	int proven_bound = 0;
+	struct state* meet[2] = {NULL, NULL};
+
+	//Special case: the start state is the goal state
+	if(states_same(start_state, goal_state, N)){
+		best_cost = 0;
+		meet[FORWARD] = start_state;
+		meet[BACKWARD] = goal_state;
+	}
+
+	//Algorithm main loop -- keep expanding until we can prove that the best solution is optimal
+	while(1){
+		struct state* top_forward = peek_open(&sides[FORWARD], N);
+		struct state* top_backward = peek_open(&sides[BACKWARD], N);
+
+		//If either side runs dry, nothing better than best_cost can be found
+		if(top_forward == NULL || top_backward == NULL){
+			break;
+		}
+
+		/**
+		 * MM stopping condition: no solution cheaper than the lower bound can exist. C is the smaller of the two
+		 * minimum priorities, and since every move costs 1, any path through two open states costs at least
+		 * gmin(forward) + gmin(backward) + 1
+		 */
+		int C = priority(top_forward) < priority(top_backward) ? priority(top_forward) : priority(top_backward);
+		int lower_bound = C;
+		int g_bound = open_g_min(&sides[FORWARD]) + open_g_min(&sides[BACKWARD]) + 1;
+		if(g_bound > lower_bound){
+			lower_bound = g_bound;
+		}
+
+		if(best_cost <= lower_bound){
+			break;
+		}
+
+		//Give up with what we have once the deadline or node limit runs out, or if someone cancels the search
+		proven_bound = lower_bound;
+		if(search_stopped(&control) != SEARCH_RUNNING){
+			break;
+		}
+
+		//Expand the side with the smaller priority. On ties, expand the side with the smaller open list
+		int direction;
+		if(priority(top_forward) != priority(top_backward)){
+			direction = priority(top_forward) < priority(top_backward) ? FORWARD : BACKWARD;
+		} else {
+			direction = sides[FORWARD].num_open <= sides[BACKWARD].num_open ? FORWARD : BACKWARD;
+		}
+
+		expand(&sides[direction], &sides[1 - direction], &best_cost, &meet[direction], &meet[1 - direction], N);
+		search_should_stop(&control, 1);
+
+		//For very complex problems, let the progress reporter know how far along we are. Both sides count together
+		publish_progress(&progress, sides[FORWARD].expansions + sides[BACKWARD].expansions, sides[FORWARD].generated + sides[BACKWARD].generated,
+						 lower_bound, sides[FORWARD].num_open + sides[BACKWARD].num_open, sides[FORWARD].table_count + sides[BACKWARD].table_count);
+	}
+
+	int stopped = search_stopped(&control) != SEARCH_RUNNING;
+
+	//If we never met in the middle, there is no solution, or none yet if we stopped early
+	if(meet[FORWARD] == NULL){
+		if(!stopped){
+			printf("No solution.\n");
+			return 0;
+		}
+
+		printf("\nSearch stopped before the two searches met, so there is no path to show\n");
+		printf("------------- Program Running Statistics -------------\n\n");
+		print_search_stopped(&control, proven_bound + 1, sides[FORWARD].expansions + sides[BACKWARD].expansions);
+		printf("Heuristic: %s\n", heuristic_name());
+		printf("Total CPU time spent: %.7f seconds\n\n", (double)(clock() - begin_CPU) / CLOCKS_PER_SEC);
+		printf("------------------------------------------------------\n\n");
+		return SEARCH_STOPPED_EXIT;
+	}
+
+	//Stop the clock once we have proven our solution
+	clock_t end_CPU = clock();
+
+	//Determine the time spent for CPU time
+	double time_spent_CPU = (double)(end_CPU - begin_CPU) / CLOCKS_PER_SEC;
+
+	//Keep track of how long the path is
+	int pathlen = 0;
+	//Keep a linked list for our solution path
+	struct state* solution_path = NULL;
+
+	//The forward half runs from the start to the meeting state, put it in reverse order(insert at the head)
+	struct state* curr_state = meet[FORWARD];
+	while(curr_state != NULL){
+		curr_state->next = solution_path;
+		solution_path = curr_state;
+		curr_state = curr_state->predecessor;
+		pathlen++;
+	}
+
+	//The backward half runs from the goal to the meeting state, so its predecessors are already in solution order.
+	//The meeting state itself is already in the path, so skip it
+	struct state* tail = meet[FORWARD];
+	curr_state = meet[BACKWARD]->predecessor;
+	while(curr_state != NULL){
+		tail->next = curr_state;
+		tail = curr_state;
+		curr_state = curr_state->predecessor;
+		pathlen++;
+	}
+	tail->next = NULL;
+
+	//Print out the solution path first
+	printf("\nSolution found! Now displaying solution path\n");
+	//Display the path length for the user
+	printf("Path Length: %d\n\n", pathlen);
+
+	//Print out the solution path in order
+	while(solution_path != NULL){
+		print_state(solution_path, N, 0);
+		solution_path = solution_path->next;
+	}
+
+	long total_generated = sides[FORWARD].generated + sides[BACKWARD].generated;
+
+	//Print out all running statistics
+	printf("------------- Program Running Statistics -------------\n\n");
+	//Print out the path length. If we stopped early, the searches met but the path isn't proven to be the shortest
+	if(stopped){
+		printf("Solution path length: %d, not proven optimal\n", pathlen);
+		print_search_stopped(&control, proven_bound + 1, sides[FORWARD].expansions + sides[BACKWARD].expansions);
+	} else {
+		printf("Optimal solution path length: %d\n", pathlen);
+	}
+	//Print out the work done by each side, so that we know which direction did the heavy lifting
+	for(int i = 0; i < 2; i++){
+		printf("%s search: %ld expansions, %ld states generated, peak open list size %d, %d moves of the solution\n",
+			   sides[i].name, sides[i].expansions, sides[i].generated, sides[i].peak_open, meet[i]->current_travel);
+	}
+	//Print out the number of unique configurations generated
+	printf("Unique configurations generated by solver: %ld\n", total_generated);
+	//Print out total memory consumption in Megabytes
+	printf("Memory consumed: %.2f MB\n", (sizeof(struct state) + N*N*sizeof(short)) * total_generated / 1048576.0);
+	//Print out which heuristic was used
+	printf("Heuristic: %s\n", heuristic_name());
+	//Print out how well the heuristic caches did
+	for(int i = 0; i < 2; i++){
+		if(sides[i].cache != NULL){
+			printf("%s ", sides[i].name);
+			print_heuristic_cache_stats(sides[i].cache);
+		}
+	}
+	//Print out CPU time(NOT wall time) spent
+	printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);
+	printf("------------------------------------------------------\n\n");
+
+	return stopped ? SEARCH_STOPPED_EXIT : 0;
+}
+
+
+/**
+ * The main function simply makes the needed calls to the initialize and solve function after checking command
+ * line arguments
+ */
+int main(int argc, char** argv){
+	//The size of our N puzzle
+	int N;
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
+
+	//If the user put in a non-integer or nonpositive integer, print an error
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1){
+		printf("Incorrect type of program arguments.\n");
+		printf("Usage: ./solve_bidirectional [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Check if the number of arguments is correct. If not, exit the program and print an error
+	if(argc != N*N + 2){
+		//Give an error message
+		printf("Incorrect number of program arguments.\n");
+		printf("Usage: ./solve_bidirectional [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Important: Move the address of argv up by 1 so that initialize_start_goal can only see the initial config
+	argv += 1;
+
+	//The starting and goal states, must create and reserve space
+	struct state* start_state = (struct state*)malloc(sizeof(struct state));
+	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
+
+	//Initialize the goal and start states
+	if(initialize_start_goal(argv, start_state, goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//This solver always finds the optimal solution
+	if(options.weight != 1.0){
+		printf("ERROR. --weight is not supported by bidirectional search, use solve or solve_anytime.\n\n");
+		return 1;
+	}
+
+	//This search only finds optimal solutions, which a heuristic that overestimates can't promise
+	if(!heuristic_specification_admissible(options.heuristic)){
+		printf("ERROR. Heuristic %s adds overlapping heuristics, which can overestimate, so it is not supported by bidirectional search, use solve.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//Load or build everything the heuristic needs once, up front
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+
+	//The backward search needs a heuristic towards the start state, not the goal
+	if(!heuristic_supports_targets()){
+		printf("ERROR. Heuristic %s only works towards the goal state, so it can't be used for searching backwards.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Progress is reported from its own thread, so the search never waits on the output
+	struct progress_reporter* reporter = start_progress_reporter(&progress, &options);
+
+	//Call the solve() funciton and hand off the rest of the program execution to it
+	int result = solve(N, start_state, goal_state, options.cache_bits);
+	stop_progress_reporter(reporter);
+	return result;
+}
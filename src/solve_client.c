@@ -0,0 +1,110 @@
+/**
+ * Author: Jack Robbins
+ * This program sends one N-puzzle to a running solve_server and prints the solution that comes back. It takes the path
+ * of the server's socket, a number N, and the N*N numbers of the configuration to be solved, just like solve does.
+ *
+ * Note: This is the client for the server version of the solver
+ */
+
+//For the socket
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <string.h>
+#include "solver_protocol.h"
+
+
+/**
+ * Print how this program is meant to be run
+ */
+static void print_usage(){
+	printf("Usage: ./solve_client [--engine <ida|wida>] [--deadline <ms>] <socket path> <N> <n0> . . . <nN>\n");
+	printf("Where <socket path> is where solve_server is listening, <N> is the number of rows/columns, and <n0> . . . <nN>\n");
+	printf("is the configuration to be solved. --engine picks optimal IDA* (the default) or weighted IDA*, and --deadline\n");
+	printf("makes the server give up after that many milliseconds.\n");
+}
+
+
+/**
+ * The main function sends the request and prints the response
+ */
+int main(int argc, char** argv){
+	const char* engine = "ida";
+	long deadline = 0;
+	int argument = 1;
+
+	//Check for optional flags before anything else
+	while(argument + 1 < argc && strncmp(argv[argument], "--", 2) == 0){
+		if(strcmp(argv[argument], "--engine") == 0){
+			engine = argv[argument + 1];
+		} else if(strcmp(argv[argument], "--deadline") != 0 || sscanf(argv[argument + 1], "%ld", &deadline) != 1 || deadline < 0){
+			print_usage();
+			return 1;
+		}
+		argument += 2;
+	}
+
+	int N;
+	if(argc - argument < 2 || sscanf(argv[argument + 1], "%d", &N) != 1 || N < 2 || argc - argument != N * N + 2){
+		printf("Incorrect program arguments.\n");
+		print_usage();
+		return 1;
+	}
+	const char* socket_path = argv[argument];
+
+	//Put the request together, the server checks the configuration itself
+	char* request = (char*)malloc(MAX_FRAME_SIZE);
+	char* response = (char*)malloc(MAX_FRAME_SIZE);
+	int length = snprintf(request, MAX_FRAME_SIZE, "%s %ld %d", engine, deadline, N);
+	for(int i = argument + 2; i < argc && length < MAX_FRAME_SIZE; i++){
+		length += snprintf(request + length, MAX_FRAME_SIZE - length, " %s", argv[i]);
+	}
+	if(length >= MAX_FRAME_SIZE){
+		printf("ERROR. The configuration is too big to send.\n");
+		return 1;
+	}
+
+	//Connect to the server
+	int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+	if(connection < 0 || connect(connection, (struct sockaddr*)&address, sizeof(address)) != 0){
+		printf("ERROR. Could not connect to a server on %s.\n", socket_path);
+		return 1;
+	}
+
+	//A busy server answers and hangs up without reading the request, so a failed write is no reason to stop reading
+	signal(SIGPIPE, SIG_IGN);
+	write_frame(connection, request, length);
+	if(read_frame(connection, response, MAX_FRAME_SIZE) < 0){
+		printf("ERROR. The server hung up.\n");
+		close(connection);
+		return 1;
+	}
+	close(connection);
+
+	if(strcmp(response, "BUSY") == 0){
+		printf("The server is busy, try again later.\n");
+		return 2;
+	}
+
+	int path_length, consumed;
+	long expanded, search_time;
+	if(sscanf(response, "OK %d %ld %ld %n", &path_length, &expanded, &search_time, &consumed) != 3){
+		printf("%s\n", response);
+		return 1;
+	}
+
+	//The moves of the 0 slider, one letter each
+	printf("Moves of the 0 slider: %s\n", response + consumed);
+	printf("Solution path length: %d\n", path_length);
+	printf("States expanded: %ld\n", expanded);
+	printf("Search time: %.6f seconds\n", search_time / 1000000.0);
+
+	free(request);
+	free(response);
+	return 0;
+}
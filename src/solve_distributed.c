@@ -0,0 +1,1151 @@
+/**
+ * Author: Jack Robbins
+ * This program solves the N-puzzle with A* spread over several worker processes, so that the size of the search is no
+ * longer limited by the memory of one process, or of one machine. It takes in the same arguments as solve, and prints
+ * the solution path and statistics the same way.
+ *
+ * Every state has an owner, picked by its Zobrist key, and only the owner keeps it: each worker has its own node store
+ * and open list holding just its part of the state space. When a worker expands a state, the successors that it owns go
+ * straight into its own store, and the rest are packed and batched up per owner, then sent off many to a message. The
+ * owner throws out the ones it already has by a path at least as short, and only evaluates the heuristic for the rest.
+ *
+ * A coordinator keeps the workers in step. Each step, it gives every worker the lowest cost left in any open list as the
+ * bound, and the workers go through it in rounds. Each round, a worker expands up to ROUND_EXPANSIONS of its own states
+ * within the bound, sends its batches, and tells every other worker that it's done, whether it expanded anything, and
+ * the cheapest path to the goal it has. Once a worker has heard that from every other worker, it has everything that
+ * was sent to it. After a round where no worker expanded anything, nothing within the bound is left anywhere, so each
+ * worker reports the lowest cost left in its open list and the cheapest path to the goal it has seen back to the
+ * coordinator. Once the cheapest path to the goal costs no more than anything left open, it is optimal, and the
+ * coordinator walks it back from the goal by asking each state's owner for the move that made it.
+ *
+ * Every worker is given what is left of the deadline and its share of the node limit with each step, so it stops in the
+ * middle of one just like any other solver. A cancel from Ctrl-C or SIGTERM reaches every worker within a round,
+ * whether it was sent to the coordinator or to a worker.
+ *
+ * Workers talk over Unix domain sockets, or TCP. By default the coordinator starts --workers workers on this machine.
+ * With --listen <address>, it waits for them to join from anywhere instead, each started with --join <address>
+ *
+ * Note: This is the distributed version of the solver
+ */
+
+//For timing
+#include <time.h>
+//For the receiving thread
+#include <pthread.h>
+//For the sockets and the worker processes
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "npuzzle.h"
+#include "solver_protocol.h"
+
+
+//The longest socket address that can be given
+#define MAX_ADDRESS_LENGTH 256
+//The most states that a worker expands before it trades successors with the others. The successors that it sends are
+//often the deepest states that the step has, so trading often lets the last layer head for the goal, like it does on
+//one worker, instead of every worker expanding all of its part of the layer first
+#define ROUND_EXPANSIONS 256
+
+
+/*================================= Global variables for convenience =========================== */
+//The size of the puzzle, how many workers there are, and which one this is
+int N, num_workers, worker_id;
+//This worker's part of the search, and the heuristic cache in front of its heuristic
+struct node_store* store = NULL;
+struct heuristic_cache* cache = NULL;
+//The goal, and the states that nodes are loaded into and their successors are generated into
+struct state goal_state, expanded_state, received_state, successor_states[4];
+//The cheapest path to the goal that this worker has seen, -1 if none
+int goal_cost = -1;
+//The cheapest path to the goal that any worker has told this one about, -1 if none
+int shared_goal_cost = -1;
+//Where this worker listens for the others, the connection to every other worker, -1 for this one, and the connection
+//to the coordinator
+char listen_address[MAX_ADDRESS_LENGTH + 32] = "";
+int peers[MAX_WORKERS];
+int coordinator = -1;
+//Successors waiting to be sent to each worker. Each one is a data frame, starting with 'B', being filled in
+unsigned char* outboxes[MAX_WORKERS];
+int outbox_counts[MAX_WORKERS];
+//A successor on the wire is its packed tiles, g in 2 bytes and the move that made it. This many fit in a frame
+int entry_size, entries_per_frame;
+//Successors received from other workers, how many workers have said that they're done with a round and how many of
+//them expanded anything in it, and whether one of them is gone. A worker can get one round ahead of us, but no more,
+//so the counts are kept apart by whether the round is even or odd
+unsigned char* inbox = NULL;
+size_t inbox_size = 0, inbox_capacity = 0;
+int ends_received[2] = {0, 0}, busy_received[2] = {0, 0}, peer_lost = 0;
+//How many rounds this worker has been through
+int round_number = 0;
+pthread_mutex_t inbox_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t step_received = PTHREAD_COND_INITIALIZER;
+//Running statistics for this worker
+long num_expanded = 0, num_generated = 0, states_sent = 0, frames_sent = 0, bytes_sent = 0;
+//The deadline and node limit, and whether the search was cancelled. The coordinator's covers the whole search, and a
+//worker's covers one step, with what is left of the deadline and its share of what is left of the node limit
+struct search_control control;
+//What the search has done so far, for the progress reporter
+struct search_progress progress;
+//The moves, in the order that they are numbered(0 = left, 1 = right, 2 = down, 3 = up)
+void (*const make_move[4])(struct state*, const int) = {move_left, move_right, move_down, move_up};
+/*============================================================================================== */
+
+
+/**
+ * Whether an address is a Unix socket path. Anything else is host:port
+ */
+static int is_unix_address(const char* address){
+	return strchr(address, '/') != NULL || strchr(address, ':') == NULL;
+}
+
+
+/**
+ * Look up the host:port of a TCP address. An empty host means every interface, for listening. Returns 0, or -1 if the
+ * address can't be found
+ */
+static int resolve_address(const char* address, struct sockaddr_in* result){
+	char host[MAX_ADDRESS_LENGTH];
+	const char* colon = strrchr(address, ':');
+	if(colon == NULL || colon - address >= MAX_ADDRESS_LENGTH){
+		return -1;
+	}
+	memcpy(host, address, colon - address);
+	host[colon - address] = '\0';
+
+	struct addrinfo hints;
+	struct addrinfo* found;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+	if(getaddrinfo(host[0] == '\0' ? NULL : host, colon + 1, &hints, &found) != 0){
+		return -1;
+	}
+
+	memcpy(result, found->ai_addr, sizeof(struct sockaddr_in));
+	freeaddrinfo(found);
+	return 0;
+}
+
+
+/**
+ * Listen on an address. Returns the listening socket, or -1 on failure
+ */
+static int listen_on(const char* address){
+	int listener;
+
+	if(is_unix_address(address)){
+		struct sockaddr_un unix_address;
+		memset(&unix_address, 0, sizeof(unix_address));
+		unix_address.sun_family = AF_UNIX;
+		strncpy(unix_address.sun_path, address, sizeof(unix_address.sun_path) - 1);
+		unlink(address);
+
+		listener = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(listener < 0 || bind(listener, (struct sockaddr*)&unix_address, sizeof(unix_address)) != 0){
+			return -1;
+		}
+	} else {
+		struct sockaddr_in tcp_address;
+		int reuse = 1;
+
+		listener = socket(AF_INET, SOCK_STREAM, 0);
+		if(listener < 0 || resolve_address(address, &tcp_address) != 0){
+			return -1;
+		}
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		if(bind(listener, (struct sockaddr*)&tcp_address, sizeof(tcp_address)) != 0){
+			return -1;
+		}
+	}
+
+	return listen(listener, 128) == 0 ? listener : -1;
+}
+
+
+/**
+ * Connect to an address. Returns the connected socket, or -1 on failure
+ */
+static int connect_to(const char* address){
+	int connection;
+
+	if(is_unix_address(address)){
+		struct sockaddr_un unix_address;
+		memset(&unix_address, 0, sizeof(unix_address));
+		unix_address.sun_family = AF_UNIX;
+		strncpy(unix_address.sun_path, address, sizeof(unix_address.sun_path) - 1);
+
+		connection = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(connection < 0 || connect(connection, (struct sockaddr*)&unix_address, sizeof(unix_address)) != 0){
+			return -1;
+		}
+	} else {
+		struct sockaddr_in tcp_address;
+		int no_delay = 1;
+
+		connection = socket(AF_INET, SOCK_STREAM, 0);
+		if(connection < 0 || resolve_address(address, &tcp_address) != 0
+		   || connect(connection, (struct sockaddr*)&tcp_address, sizeof(tcp_address)) != 0){
+			return -1;
+		}
+		//Frames go out as two writes, which Nagle's algorithm would hold back waiting for an acknowledgement
+		setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+	}
+
+	return connection;
+}
+
+
+/**
+ * Accept a connection on a listening socket. Returns the connection, or -1 on failure
+ */
+static int accept_from(int listener){
+	int no_delay = 1;
+	int connection = accept(listener, NULL, NULL);
+
+	//Frames go out as two writes, which Nagle's algorithm would hold back waiting for an acknowledgement. Unix sockets
+	//don't have the option, and ignore it
+	if(connection >= 0){
+		setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+	}
+
+	return connection;
+}
+
+
+/**
+ * Send a line of text as one frame. Returns 0, or -1 if the other side is gone
+ */
+static int send_text(int connection, const char* text){
+	return write_frame(connection, text, strlen(text));
+}
+
+
+/**
+ * Which worker owns a state. Zobrist keys are the same in every process, so every worker agrees
+ */
+static int owner(struct state* statePtr){
+	return hash_state(statePtr, N) % num_workers;
+}
+
+
+/**
+ * Fill in a state from its tiles, given as text
+ */
+static void read_tiles(char* text, struct state* statePtr){
+	char* token = strtok(text, " ");
+
+	for(int i = 0; i < N * N && token != NULL; i++, token = strtok(NULL, " ")){
+		statePtr->tiles[i] = atoi(token);
+		if(statePtr->tiles[i] == 0){
+			statePtr->zero_row = i / N;
+			statePtr->zero_column = i % N;
+		}
+	}
+
+	statePtr->zobrist_key = compute_zobrist_key(statePtr->tiles, N);
+	statePtr->current_travel = 0;
+	statePtr->heuristic_cost = 0;
+	statePtr->total_cost = 0;
+	statePtr->predecessor = NULL;
+	statePtr->next = NULL;
+}
+
+
+/**
+ * Write a state's tiles as text, after whatever is already in the buffer
+ */
+static void write_tiles(char* text, struct state* statePtr){
+	for(int i = 0; i < N * N; i++){
+		sprintf(text + strlen(text), " %d", statePtr->tiles[i]);
+	}
+}
+
+
+/**
+ * Send everything waiting for a worker
+ */
+static void flush_outbox(int destination){
+	if(outbox_counts[destination] == 0){
+		return;
+	}
+
+	int length = 1 + outbox_counts[destination] * entry_size;
+	write_frame(peers[destination], (char*)outboxes[destination], length);
+
+	states_sent += outbox_counts[destination];
+	frames_sent++;
+	bytes_sent += length;
+	outbox_counts[destination] = 0;
+}
+
+
+/**
+ * Pack a successor up for the worker that owns it, sending the batch once it's full
+ */
+static void send_successor(int destination, struct state* statePtr, int move){
+	unsigned char* entry = outboxes[destination] + 1 + outbox_counts[destination] * entry_size;
+	int packed_size = entry_size - 3;
+
+	pack_state(statePtr, entry, N);
+	//g goes out low byte first, so that every machine reads it the same way
+	entry[packed_size] = statePtr->current_travel & 0xFF;
+	entry[packed_size + 1] = (statePtr->current_travel >> 8) & 0xFF;
+	entry[packed_size + 2] = move;
+
+	if(++outbox_counts[destination] == entries_per_frame){
+		flush_outbox(destination);
+	}
+}
+
+
+/**
+ * Put a state that this worker owns into its store, if it is new or reached by a shorter path than before. The goal is
+ * kept in the store, so that the path can be walked back, but it never goes into the open list
+ */
+static void add_state(struct state* statePtr, int move){
+	int is_new;
+
+	if(states_same(statePtr, &goal_state, N)){
+		if(goal_cost == -1 || statePtr->current_travel < goal_cost){
+			goal_cost = statePtr->current_travel;
+		}
+		statePtr->heuristic_cost = 0;
+		statePtr->total_cost = statePtr->current_travel;
+		node_store_add(store, statePtr, NO_NODE, move, &is_new);
+		num_generated += is_new;
+		return;
+	}
+
+	//Only states that are new, or reached by a shorter path than before, are worth evaluating
+	unsigned int found = node_store_find(store, statePtr);
+	if(found != NO_NODE && store->g[found] <= statePtr->current_travel){
+		return;
+	}
+
+	update_heuristic(statePtr, N, cache);
+	unsigned int id = node_store_add(store, statePtr, NO_NODE, move, &is_new);
+	open_list_push(store, statePtr->total_cost, id);
+	num_generated += is_new;
+}
+
+
+/**
+ * Expand one node, keeping the successors that this worker owns and sending off the rest. The parent of a node is never
+ * kept, since it may be on another worker. The move that made it is enough to walk back to it
+ */
+static void expand(struct open_entry entry){
+	node_store_load(store, entry.id, &expanded_state);
+	expanded_state.total_cost = entry.f;
+
+	//Incremental heuristics need the per-state information that the node store doesn't keep
+	if(heuristic_is_incremental()){
+		evaluate_heuristic(&expanded_state, N);
+	}
+
+	int last_move = store->flags[entry.id] & MOVE_MASK;
+	int possible[4] = {expanded_state.zero_column > 0, expanded_state.zero_column < N - 1, expanded_state.zero_row < N - 1, expanded_state.zero_row > 0};
+
+	for(int move = 0; move < 4; move++){
+		//Skip the move that would undo the last one
+		if(!possible[move] || (last_move != NO_MOVE && move == (last_move ^ 1))){
+			continue;
+		}
+
+		copy_state(&expanded_state, &successor_states[move], N);
+		make_move[move](&successor_states[move], N);
+
+		int destination = owner(&successor_states[move]);
+		if(destination == worker_id){
+			add_state(&successor_states[move], move);
+		} else {
+			send_successor(destination, &successor_states[move], move);
+		}
+	}
+
+	num_expanded++;
+}
+
+
+/**
+ * The receiving thread. Reads every other worker's batches into the inbox as they come, so that no worker ever waits to
+ * send because another is busy sending too, and counts the end of step messages
+ */
+static void* receiver_thread(void* argument){
+	(void)argument;
+	struct pollfd connections[MAX_WORKERS];
+	int count = 0;
+	char* frame = (char*)malloc(MAX_FRAME_SIZE);
+
+	for(int i = 0; i < num_workers; i++){
+		if(i != worker_id){
+			connections[count].fd = peers[i];
+			connections[count].events = POLLIN;
+			count++;
+		}
+	}
+
+	int open_connections = count;
+	while(open_connections > 0){
+		if(poll(connections, count, -1) < 0){
+			continue;
+		}
+
+		for(int i = 0; i < count; i++){
+			if(connections[i].fd < 0 || connections[i].revents == 0){
+				continue;
+			}
+
+			int length = read_frame(connections[i].fd, frame, MAX_FRAME_SIZE);
+
+			pthread_mutex_lock(&inbox_lock);
+			if(length <= 0){
+				//poll skips negative descriptors
+				connections[i].fd = -1;
+				open_connections--;
+				peer_lost = 1;
+				pthread_cond_signal(&step_received);
+			} else if(frame[0] == 'B'){
+				if(inbox_size + length - 1 > inbox_capacity){
+					inbox_capacity = (inbox_size + length - 1) * 2;
+					inbox = (unsigned char*)realloc(inbox, inbox_capacity);
+				}
+				memcpy(inbox + inbox_size, frame + 1, length - 1);
+				inbox_size += length - 1;
+			} else if(frame[0] == 'E'){
+				//"E <round parity> <whether it expanded anything> <its cheapest path to the goal> <whether it was cancelled>"
+				int parity, busy, goal, cancelled;
+				if(sscanf(frame, "E %d %d %d %d", &parity, &busy, &goal, &cancelled) == 4){
+					ends_received[parity & 1]++;
+					busy_received[parity & 1] += busy;
+					if(goal != -1 && (shared_goal_cost == -1 || goal < shared_goal_cost)){
+						shared_goal_cost = goal;
+					}
+					//A worker that was sent Ctrl-C or SIGTERM on its own takes every other worker with it
+					if(cancelled){
+						cancel_search(&control);
+					}
+				}
+				pthread_cond_signal(&step_received);
+			}
+			pthread_mutex_unlock(&inbox_lock);
+		}
+	}
+
+	free(frame);
+	return NULL;
+}
+
+
+/**
+ * The cheapest path to the goal that this worker knows of, its own or one that another worker told it about, -1 if none
+ */
+static int best_goal_cost(){
+	pthread_mutex_lock(&inbox_lock);
+	int best = shared_goal_cost;
+	pthread_mutex_unlock(&inbox_lock);
+
+	return goal_cost != -1 && (best == -1 || goal_cost < best) ? goal_cost : best;
+}
+
+
+/**
+ * See whether the coordinator has cancelled the step. It sends nothing else while a step is running, so anything that
+ * comes in now is a cancel, and so is the coordinator going away
+ */
+static void check_for_cancel(){
+	struct pollfd connection = {coordinator, POLLIN, 0};
+
+	if(poll(&connection, 1, 0) > 0){
+		char frame[16];
+		read_frame(coordinator, frame, sizeof(frame));
+		cancel_search(&control);
+	}
+}
+
+
+/**
+ * One round of a step: expand up to ROUND_EXPANSIONS of our own states within the bound, send the successors that belong
+ * elsewhere, and take in everything that the other workers sent us. Returns how many workers, this one included,
+ * expanded anything, or -1 if another worker is gone
+ */
+static int run_round(int bound){
+	int busy = 0;
+	int parity = round_number++ & 1;
+
+	check_for_cancel();
+
+	//Nodes made along the way that are still within the bound are expanded in this round too. Once any worker has
+	//reached the goal within the bound, nothing left open can beat it, so the rest of the layer can wait
+	while(busy < ROUND_EXPANSIONS && search_stopped(&control) == SEARCH_RUNNING && !open_list_empty(store)
+		  && open_list_head(store).f <= bound){
+		int best_goal = best_goal_cost();
+		if(best_goal != -1 && best_goal <= bound){
+			break;
+		}
+
+		struct open_entry entry = open_list_pop(store);
+
+		//Stale entries, for nodes already expanded through a cheaper one, are skipped
+		if(store->flags[entry.id] & EXPANDED_FLAG){
+			continue;
+		}
+		store->flags[entry.id] |= EXPANDED_FLAG;
+
+		expand(entry);
+		busy++;
+
+		//The deadline and node limit are checked as often as in any other solver
+		search_should_stop(&control, 1);
+	}
+
+	//Send whatever is left, and then tell everyone that's all for this round, whether we did anything, the cheapest path
+	//to the goal that we have, and whether we were cancelled
+	char end_message[64];
+	sprintf(end_message, "E %d %d %d %d", parity, busy > 0, goal_cost, search_stopped(&control) == SEARCH_CANCELLED);
+	for(int i = 0; i < num_workers; i++){
+		if(i != worker_id){
+			flush_outbox(i);
+			send_text(peers[i], end_message);
+		}
+	}
+
+	//Wait until every other worker has said the same, at which point everything they sent has arrived
+	pthread_mutex_lock(&inbox_lock);
+	while(ends_received[parity] < num_workers - 1 && !peer_lost){
+		pthread_cond_wait(&step_received, &inbox_lock);
+	}
+	if(peer_lost){
+		pthread_mutex_unlock(&inbox_lock);
+		return -1;
+	}
+	unsigned char* received = inbox;
+	size_t received_size = inbox_size;
+	inbox = NULL;
+	inbox_size = inbox_capacity = 0;
+	busy = (busy > 0) + busy_received[parity];
+	ends_received[parity] = busy_received[parity] = 0;
+	pthread_mutex_unlock(&inbox_lock);
+
+	//Now take in every successor that was sent to us
+	int packed_size = entry_size - 3;
+	for(size_t offset = 0; offset + entry_size <= received_size; offset += entry_size){
+		unpack_state(received + offset, &received_state, N);
+		received_state.current_travel = received[offset + packed_size] | (received[offset + packed_size + 1] << 8);
+		received_state.predecessor = NULL;
+		add_state(&received_state, received[offset + packed_size + 2]);
+	}
+	free(received);
+
+	//Stale entries at the head would only make the bound lower than it has to be
+	while(!open_list_empty(store) && (store->flags[open_list_head(store).id] & EXPANDED_FLAG)){
+		open_list_pop(store);
+	}
+
+	return busy;
+}
+
+
+/**
+ * One step of the search, which runs rounds until a round where no worker expanded anything. Then nothing within the
+ * bound is left open anywhere, or every worker has stopped, and nothing is still on its way, so the lowest cost left in
+ * the open list is all that the coordinator needs. Returns 0, or -1 if another worker is gone
+ */
+static int run_step(int bound){
+	int busy;
+
+	do {
+		busy = run_round(bound);
+	} while(busy > 0);
+
+	return busy;
+}
+
+
+/**
+ * Answer the coordinator's question about one state: the move that made it and its g, or -1 -1 if it isn't here
+ */
+static void answer_path_query(char* tiles){
+	char answer[64];
+	read_tiles(tiles, &received_state);
+
+	unsigned int id = node_store_find(store, &received_state);
+	if(id == NO_NODE){
+		sprintf(answer, "P -1 -1");
+	} else {
+		sprintf(answer, "P %d %d", store->flags[id] & MOVE_MASK, store->g[id]);
+	}
+
+	send_text(coordinator, answer);
+}
+
+
+/**
+ * Run as a worker for the coordinator at an address, until it says to quit. Returns 0, or 1 if the worker couldn't
+ * get started or lost the coordinator or another worker
+ */
+static int run_worker(const char* coordinator_address){
+	char* message = (char*)malloc(MAX_FRAME_SIZE);
+
+	//Ctrl-C or SIGTERM cancels the step that is running, and the coordinator then stops the whole search
+	cancel_on_interrupt(&control);
+
+	//Listen for the other workers in the same way that the coordinator listens for us
+	if(is_unix_address(coordinator_address)){
+		snprintf(listen_address, sizeof(listen_address), "%s.%d", coordinator_address, (int)getpid());
+	} else {
+		sprintf(listen_address, ":0");
+	}
+	int listener = listen_on(listen_address);
+	coordinator = connect_to(coordinator_address);
+	if(listener < 0 || coordinator < 0){
+		printf("ERROR. Worker could not reach the coordinator at %s.\n", coordinator_address);
+		return 1;
+	}
+
+	//Over TCP, the other workers reach us at the address that the coordinator sees, on the port we got
+	if(!is_unix_address(coordinator_address)){
+		struct sockaddr_in local;
+		socklen_t length = sizeof(local);
+		char host[INET_ADDRSTRLEN];
+		getsockname(coordinator, (struct sockaddr*)&local, &length);
+		inet_ntop(AF_INET, &local.sin_addr, host, sizeof(host));
+		length = sizeof(local);
+		getsockname(listener, (struct sockaddr*)&local, &length);
+		sprintf(listen_address, "%s:%d", host, ntohs(local.sin_port));
+	}
+
+	sprintf(message, "H %s", listen_address);
+	send_text(coordinator, message);
+
+	//The setup is "S <id> <workers> <N> <heuristic> <pattern database or -> <cache bits> <weight> <tiles> <goal tiles>
+	//<addresses>"
+	char heuristic[MAX_ADDRESS_LENGTH], pattern_database[MAX_ADDRESS_LENGTH];
+	int cache_bits, consumed;
+	double weight;
+	if(read_frame(coordinator, message, MAX_FRAME_SIZE) < 0
+	   || sscanf(message, "S %d %d %d %255s %255s %d %lf%n", &worker_id, &num_workers, &N, heuristic, pattern_database, &cache_bits, &weight, &consumed) != 7){
+		return 1;
+	}
+
+	//The tiles come next, then the goal's, then one address per worker
+	char* rest = message + consumed;
+	char* addresses[MAX_WORKERS];
+	char* token = strtok(rest, " ");
+	char tiles[N * N * 4 + 1], goal_tiles[N * N * 4 + 1];
+	tiles[0] = goal_tiles[0] = '\0';
+	for(int i = 0; i < N * N && token != NULL; i++, token = strtok(NULL, " ")){
+		sprintf(tiles + strlen(tiles), "%s ", token);
+	}
+	for(int i = 0; i < N * N && token != NULL; i++, token = strtok(NULL, " ")){
+		sprintf(goal_tiles + strlen(goal_tiles), "%s ", token);
+	}
+	for(int i = 0; i < num_workers && token != NULL; i++, token = strtok(NULL, " ")){
+		//The message buffer is used again for connecting, so the addresses need copies of their own
+		addresses[i] = strdup(token);
+	}
+
+	//Load the heuristic just as the coordinator was told to
+	struct solver_options options;
+	default_solver_options(&options, heuristic);
+	options.pattern_database = strcmp(pattern_database, "-") == 0 ? NULL : pattern_database;
+	options.cache_bits = cache_bits;
+	options.weight = weight;
+
+	initialize_zobrist(N);
+	initialize_state(&goal_state, N);
+	initialize_state(&expanded_state, N);
+	initialize_state(&received_state, N);
+	for(int i = 0; i < 4; i++){
+		initialize_state(&successor_states[i], N);
+	}
+	//The goal is the coordinator's, which is already relabeled, or measured against as it is if it couldn't be
+	read_tiles(goal_tiles, &goal_state);
+	set_goal_target(&goal_state, N);
+
+	//The pattern database prints when it loads, and every worker loading it would say so over and over
+	int console = dup(STDOUT_FILENO);
+	fflush(stdout);
+	freopen("/dev/null", "w", stdout);
+	int initialized = initialize_heuristic(&options, N);
+	fflush(stdout);
+	dup2(console, STDOUT_FILENO);
+	close(console);
+	if(initialized != 0){
+		send_text(coordinator, "ERROR could not load the heuristic");
+		return 1;
+	}
+	cache = create_heuristic_cache_for(&options);
+
+	//Connect to every worker after us, and take the connections of every worker before us, which tell us who they are
+	for(int i = 0; i < num_workers; i++){
+		peers[i] = -1;
+		outbox_counts[i] = 0;
+	}
+	for(int i = worker_id + 1; i < num_workers; i++){
+		peers[i] = connect_to(addresses[i]);
+		sprintf(message, "I %d", worker_id);
+		if(peers[i] < 0 || send_text(peers[i], message) != 0){
+			send_text(coordinator, "ERROR could not connect to another worker");
+			return 1;
+		}
+	}
+	for(int i = 0; i < worker_id; i++){
+		int peer, connection = accept_from(listener);
+		if(connection < 0 || read_frame(connection, message, MAX_FRAME_SIZE) < 0 || sscanf(message, "I %d", &peer) != 1
+		   || peer < 0 || peer >= worker_id){
+			send_text(coordinator, "ERROR another worker did not connect");
+			return 1;
+		}
+		peers[peer] = connection;
+	}
+	close(listener);
+
+	//Set up our part of the search, starting with the start state if it's ours
+	store = create_node_store(DEFAULT_NODE_STORE_BITS, N);
+	entry_size = packed_state_size(N) + 3;
+	entries_per_frame = (MAX_FRAME_SIZE - 2) / entry_size;
+	for(int i = 0; i < num_workers; i++){
+		outboxes[i] = (unsigned char*)malloc(1 + entries_per_frame * entry_size);
+		outboxes[i][0] = 'B';
+	}
+
+	struct state start_state;
+	initialize_state(&start_state, N);
+	read_tiles(tiles, &start_state);
+	if(owner(&start_state) == worker_id){
+		add_state(&start_state, NO_MOVE);
+	}
+
+	pthread_t receiver;
+	pthread_create(&receiver, NULL, receiver_thread, NULL);
+	send_text(coordinator, "READY");
+
+	//Do as the coordinator says until it's done with us
+	while(read_frame(coordinator, message, MAX_FRAME_SIZE) >= 0){
+		int bound;
+		long milliseconds_left, node_share;
+
+		//"X <bound> <milliseconds left, 0 for no deadline> <our share of the node limit, 0 for none>"
+		if(sscanf(message, "X %d %ld %ld", &bound, &milliseconds_left, &node_share) == 3){
+			//A cancel from Ctrl-C or SIGTERM between steps still counts for this one
+			int cancelled = search_stopped(&control) == SEARCH_CANCELLED;
+			options.deadline = milliseconds_left;
+			options.node_limit = node_share;
+			start_search_control(&control, &options);
+			if(cancelled){
+				cancel_search(&control);
+			}
+
+			if(run_step(bound) != 0){
+				return 1;
+			}
+
+			sprintf(message, "R %d %d %ld %ld %u %u %ld %ld %ld %d", open_list_empty(store) ? -1 : open_list_head(store).f,
+					goal_cost, num_expanded, num_generated, store->open_count, store->count, states_sent, frames_sent, bytes_sent,
+					search_stopped(&control));
+			send_text(coordinator, message);
+		} else if(message[0] == 'C'){
+			//A cancel that came in after the step was already over, the coordinator stops the search without us
+			continue;
+		} else if(message[0] == 'P'){
+			answer_path_query(message + 1);
+		} else {
+			//Q, we're done
+			return 0;
+		}
+	}
+
+	//The coordinator is gone
+	return 1;
+}
+
+
+/**
+ * Run as a worker, and clean up the socket that it listened on, however it ends
+ */
+static int worker_main(const char* coordinator_address){
+	int result = run_worker(coordinator_address);
+
+	if(is_unix_address(listen_address)){
+		unlink(listen_address);
+	}
+
+	return result;
+}
+
+
+/**
+ * Walk the path back from the goal, asking each state's owner for the move that made it and taking it back, until the
+ * start state is reached. Returns the number of moves, which are put into moves in order from the start, or -1 if the
+ * path is broken
+ */
+static int walk_back_path(int* workers, struct state* start_state, char* moves, int max_moves){
+	char* message = (char*)malloc(MAX_FRAME_SIZE);
+	struct state cursor;
+	initialize_state(&cursor, N);
+	copy_state(&goal_state, &cursor, N);
+
+	int length = 0;
+	while(length <= max_moves){
+		int move, g;
+
+		sprintf(message, "P");
+		write_tiles(message, &cursor);
+		if(send_text(workers[owner(&cursor)], message) != 0 || read_frame(workers[owner(&cursor)], message, MAX_FRAME_SIZE) < 0
+		   || sscanf(message, "P %d %d", &move, &g) != 2 || g < 0){
+			length = -1;
+			break;
+		}
+
+		//Only the start state has no move
+		if(move == NO_MOVE){
+			break;
+		}
+
+		moves[length++] = move;
+		make_move[move ^ 1](&cursor, N);
+	}
+
+	if(length != -1 && !states_same(&cursor, start_state, N)){
+		length = -1;
+	}
+
+	//The moves were found from the goal back, so put them in order
+	for(int i = 0; length > 0 && i < length / 2; i++){
+		char swap = moves[i];
+		moves[i] = moves[length - 1 - i];
+		moves[length - 1 - i] = swap;
+	}
+
+	destroy_state(&cursor);
+	free(message);
+	return length;
+}
+
+
+/**
+ * Tell every worker to quit, and wait for the ones that we started
+ */
+static void stop_workers(int* workers, pid_t* children, int num_children){
+	for(int i = 0; i < num_workers; i++){
+		send_text(workers[i], "Q");
+		close(workers[i]);
+	}
+
+	for(int i = 0; i < num_children; i++){
+		waitpid(children[i], NULL, 0);
+	}
+}
+
+
+/**
+ * Read a worker's report on a step. While waiting, a cancel from Ctrl-C or SIGTERM is passed on to every worker, once,
+ * so that none of them has to finish its step first. Returns the length of the report, or -1 if the worker is gone
+ */
+static int read_report(int* workers, int worker, char* message, int* cancel_sent){
+	struct pollfd connection = {workers[worker], POLLIN, 0};
+
+	while(poll(&connection, 1, 100) <= 0){
+		if(!*cancel_sent && search_stopped(&control) == SEARCH_CANCELLED){
+			for(int i = 0; i < num_workers; i++){
+				send_text(workers[i], "C");
+			}
+			*cancel_sent = 1;
+		}
+	}
+
+	return read_frame(workers[worker], message, MAX_FRAME_SIZE);
+}
+
+
+/**
+ * Run the search as the coordinator, with the workers already connected and set up. Returns what the solver exits with
+ */
+static int coordinate(int* workers, struct state* start_state, const struct solver_options* options){
+	char* message = (char*)malloc(MAX_FRAME_SIZE);
+	int bound = -1, steps = 0;
+	long expanded = 0, generated = 0, sent = 0, frames = 0, bytes = 0, nodes = 0;
+	long most_expanded = 0, least_expanded = 0, most_nodes = 0;
+	int lowest_open = -1, goal = -1;
+	//The coordinator never loads the heuristic, but whether it can overestimate only depends on how it's put together
+	int admissible = heuristic_specification_admissible(options->heuristic);
+
+	int cancel_sent = 0;
+
+	while(1){
+		//The first step has a bound below everything, so it only finds out where the search starts. Every worker gets
+		//what is left of the deadline, and an even share of what is left of the node limit, so that it can stop in the
+		//middle of the step. If one runs through its share, the next step splits up whatever is left again
+		long milliseconds_left = search_time_left(&control);
+		long node_share = options->node_limit > 0 ? (options->node_limit - expanded + num_workers - 1) / num_workers : 0;
+		sprintf(message, "X %d %ld %ld", bound, milliseconds_left == -1 ? 0 : (milliseconds_left < 1 ? 1 : milliseconds_left), node_share);
+		for(int i = 0; i < num_workers; i++){
+			send_text(workers[i], message);
+		}
+
+		expanded = generated = sent = frames = bytes = nodes = most_nodes = 0;
+		lowest_open = goal = -1;
+		for(int i = 0; i < num_workers; i++){
+			int worker_open, worker_goal, worker_stopped;
+			unsigned int open_count, node_count;
+			long worker_expanded, worker_generated, worker_sent, worker_frames, worker_bytes;
+
+			if(read_report(workers, i, message, &cancel_sent) < 0
+			   || sscanf(message, "R %d %d %ld %ld %u %u %ld %ld %ld %d", &worker_open, &worker_goal, &worker_expanded, &worker_generated,
+						 &open_count, &node_count, &worker_sent, &worker_frames, &worker_bytes, &worker_stopped) != 10){
+				printf("ERROR. Worker %d is gone.\n", i);
+				return 1;
+			}
+
+			//A worker that was sent Ctrl-C or SIGTERM on its own cancels the whole search
+			if(worker_stopped == SEARCH_CANCELLED){
+				cancel_search(&control);
+			}
+
+			if(worker_open != -1 && (lowest_open == -1 || worker_open < lowest_open)){
+				lowest_open = worker_open;
+			}
+			if(worker_goal != -1 && (goal == -1 || worker_goal < goal)){
+				goal = worker_goal;
+			}
+			if(i == 0 || worker_expanded > most_expanded){
+				most_expanded = worker_expanded;
+			}
+			if(i == 0 || worker_expanded < least_expanded){
+				least_expanded = worker_expanded;
+			}
+			if(node_count > most_nodes){
+				most_nodes = node_count;
+			}
+			expanded += worker_expanded;
+			generated += worker_generated;
+			sent += worker_sent;
+			frames += worker_frames;
+			bytes += worker_bytes;
+			nodes += node_count;
+		}
+		steps++;
+
+		publish_progress(&progress, expanded, generated, bound, nodes - expanded, expanded);
+
+		//The workers only ever had part of the limits, so they are checked here against the whole search
+		if(options->node_limit > 0 && expanded >= options->node_limit){
+			stop_search(&control, SEARCH_NODE_LIMIT);
+		}
+		if(search_time_left(&control) == 0){
+			stop_search(&control, SEARCH_DEADLINE);
+		}
+
+		//Every open state costs at least lowest_open, so no path through one of them beats the goal
+		if(goal != -1 && (lowest_open == -1 || goal <= lowest_open)){
+			break;
+		}
+
+		if(lowest_open == -1){
+			printf("No solution.\n");
+			return 0;
+		}
+
+		if(search_stopped(&control) != SEARCH_RUNNING){
+			printf("------------- Program Running Statistics -------------\n\n");
+			//Everything cheaper than the lowest open cost has been expanded, which only bounds a search that never overestimates
+			print_search_stopped(&control, options->weight == 1.0 && admissible ? lowest_open + 1 : -1, expanded);
+			printf("Workers: %d, %d steps\n", num_workers, steps);
+			printf("------------------------------------------------------\n\n");
+			return SEARCH_STOPPED_EXIT;
+		}
+
+		bound = lowest_open;
+	}
+
+	double seconds = search_seconds(&control);
+
+	//Walk the path back, then replay it from the start to print it
+	char* moves = (char*)malloc(goal + 1);
+	int length = walk_back_path(workers, start_state, moves, goal);
+	if(length < 0){
+		printf("ERROR. The path to the goal could not be walked back.\n");
+		return 1;
+	}
+
+	printf("\nSolution found! Now displaying solution path\n");
+	printf("Path Length: %d\n\n", length + 1);
+	struct state cursor;
+	initialize_state(&cursor, N);
+	copy_state(start_state, &cursor, N);
+	print_state(&cursor, N, 0);
+	for(int i = 0; i < length; i++){
+		make_move[(int)moves[i]](&cursor, N);
+		print_state(&cursor, N, 0);
+	}
+
+	printf("------------- Program Running Statistics -------------\n\n");
+	//Weighted A* only guarantees a path within a factor of the weight
+	if(!admissible){
+		printf("Solution path length: %d, not proven optimal, since the heuristic adds overlapping estimates\n", length + 1);
+	} else if(options->weight == 1.0){
+		printf("Optimal solution path length: %d\n", length + 1);
+	} else {
+		printf("Solution path length: %d, at most %.2f times optimal\n", length + 1, options->weight);
+	}
+	printf("Workers: %d, %d steps\n", num_workers, steps);
+	printf("Unique configurations generated by solver: %ld\n", generated);
+	printf("States expanded: %ld, from %ld to %ld by one worker\n", expanded, least_expanded, most_expanded);
+	printf("States sent between workers: %ld in %ld messages(%.2f MB, %d bytes per state)\n", sent, frames, bytes / 1048576.0, entry_size);
+	printf("States stored: %ld, at most %ld by one worker\n", nodes, most_nodes);
+	printf("Heuristic: %s\n", options->heuristic);
+	printf("Total wall time spent: %.7f seconds\n\n", seconds);
+	printf("------------------------------------------------------\n\n");
+
+	destroy_state(&cursor);
+	free(moves);
+	free(message);
+	return 0;
+}
+
+
+/**
+ * The main function either runs a worker, with --join, or checks the arguments, gets the workers going, and coordinates
+ * the search
+ */
+int main(int argc, char** argv){
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//A worker that is joining gets everything else from the coordinator
+	if(options.join != NULL){
+		signal(SIGPIPE, SIG_IGN);
+		return worker_main(options.join);
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
+
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 2 || argc != N * N + 2){
+		printf("Incorrect program arguments.\n");
+		printf("Usage: ./solve_distributed [options] <N> <n0. . .nN>\n");
+		printf("       ./solve_distributed [options] --join <address>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order. --workers sets how\n");
+		printf("many worker processes search, and --listen makes the coordinator wait for them to --join it.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Important: Move the address of argv up by 1 so that initialize_start_goal can only see the initial config
+	argv += 1;
+	struct state* start_state = (struct state*)malloc(sizeof(struct state));
+	if(initialize_start_goal(argv, start_state, &goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//The workers are told which heuristic to load, so they fall back the same way that initialize_heuristic would
+	options.heuristic = heuristic_for_goal(options.heuristic);
+
+	//One worker per core unless told otherwise
+	num_workers = options.workers;
+	if(num_workers == 0){
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		num_workers = cores < 1 ? 1 : (cores > MAX_WORKERS ? MAX_WORKERS : (int)cores);
+	}
+	entry_size = packed_state_size(N) + 3;
+
+	//Workers started here join over a Unix socket that only this run uses
+	char address[MAX_ADDRESS_LENGTH];
+	if(options.listen != NULL){
+		snprintf(address, sizeof(address), "%s", options.listen);
+	} else {
+		snprintf(address, sizeof(address), "/tmp/solve_distributed.%d.sock", (int)getpid());
+	}
+
+	int listener = listen_on(address);
+	if(listener < 0){
+		printf("ERROR. Could not listen on %s.\n", address);
+		return 1;
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	//Start the workers, unless they're joining from elsewhere. Flush first, or every worker prints what we printed
+	pid_t children[MAX_WORKERS];
+	int num_children = 0;
+	fflush(stdout);
+	if(options.listen == NULL){
+		for(int i = 0; i < num_workers; i++){
+			children[num_children] = fork();
+			if(children[num_children] == 0){
+				close(listener);
+				_exit(worker_main(address));
+			}
+			num_children++;
+		}
+	} else {
+		printf("Waiting for %d workers to join at %s\n", num_workers, address);
+		fflush(stdout);
+	}
+
+	//Every worker says where it listens for the others, and then gets the whole setup, including where they all are
+	int workers[MAX_WORKERS];
+	char worker_addresses[MAX_WORKERS][MAX_ADDRESS_LENGTH];
+	char* message = (char*)malloc(MAX_FRAME_SIZE);
+	for(int i = 0; i < num_workers; i++){
+		workers[i] = accept_from(listener);
+		if(workers[i] < 0 || read_frame(workers[i], message, MAX_FRAME_SIZE) < 0 || sscanf(message, "H %255s", worker_addresses[i]) != 1){
+			printf("ERROR. A worker could not join.\n");
+			return 1;
+		}
+	}
+	close(listener);
+	if(is_unix_address(address)){
+		unlink(address);
+	}
+
+	for(int i = 0; i < num_workers; i++){
+		sprintf(message, "S %d %d %d %s %s %d %f", i, num_workers, N, options.heuristic,
+				options.pattern_database == NULL ? "-" : options.pattern_database, options.cache_bits, options.weight);
+		write_tiles(message, start_state);
+		write_tiles(message, &goal_state);
+		for(int j = 0; j < num_workers; j++){
+			sprintf(message + strlen(message), " %s", worker_addresses[j]);
+		}
+		send_text(workers[i], message);
+	}
+
+	//Every worker has to have its heuristic loaded and be connected to every other worker before the search starts
+	for(int i = 0; i < num_workers; i++){
+		if(read_frame(workers[i], message, MAX_FRAME_SIZE) < 0 || strcmp(message, "READY") != 0){
+			printf("ERROR. Worker %d could not start: %s\n", i, message);
+			stop_workers(workers, children, num_children);
+			return 1;
+		}
+	}
+	free(message);
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Progress is reported from its own thread, so the search never waits on the output
+	struct progress_reporter* reporter = start_progress_reporter(&progress, &options);
+
+	int result = coordinate(workers, start_state, &options);
+	stop_progress_reporter(reporter);
+	stop_workers(workers, children, num_children);
+	return result;
+}
@@ -0,0 +1,657 @@
+/**
+ * Author: Jack Robbins
+ * This program implements an external memory search to find the shortest solve path for the N-puzzle problem. It takes
+ * in an N-puzzle problem starting configuration in row-major order as a command line argument, following a number N for
+ * the NxN size of the puzzle, and prints out the length of the shortest solution, if such a solution exists.
+ *
+ * The other solvers keep every state in memory, which limits them to problems whose search fits in RAM. This solver keeps
+ * almost nothing in memory. The search goes breadth first, one layer(all states at the same depth) at a time, and every
+ * layer lives on disk as a sorted file of packed states. While a layer is being expanded, its successors are collected in
+ * a memory buffer, and every time the buffer fills up it is sorted and written out as a run. Once the layer is done, the
+ * runs are merged together, and since duplicates end up right next to each other after sorting, they are thrown away
+ * during the merge(delayed duplicate detection). All disk access is sequential, in large blocks.
+ *
+ * Each state on disk also carries a mask of the moves that lead back into the previous layer. Duplicates from different
+ * parents have their masks combined during the merge, so no successor ever goes back to the previous layer, and only two
+ * layers ever need to be on disk at once. States whose f = g + h goes over the current bound are not written at all, and
+ * if a bound is too small the search starts over with the next smallest f that was cut off(breadth first iterative
+ * deepening), so the solution found is still optimal.
+ *
+ * Note: This is the external memory version of the solver. It reports the solution length, but not the path itself,
+ * since the states along the path are not kept
+ */
+
+//For timing
+#include <time.h>
+//For getpid
+#include <unistd.h>
+#include "npuzzle.h"
+
+
+//Files are read and written in blocks of this many bytes
+#define BLOCK_SIZE (1 << 20)
+//Never merge more than this many runs at once, to stay well below the open file limit
+#define MAX_FANOUT 256
+//What bounded_search returns when it was stopped before it was done
+#define SEARCH_STOPPED -2
+
+
+/*================================= Global variables for convenience =========================== */
+//The heuristic cache that sits in front of the heuristic, NULL if turned off
+struct heuristic_cache* cache = NULL;
+//Every record on disk is a packed state followed by one byte with the mask of moves back to the previous layer
+int packed_size;
+int record_size;
+//Successors are collected here and sorted before being written out as a run
+unsigned char* run_buffer;
+long run_buffer_capacity;
+long run_buffer_count = 0;
+//The runs of the layer that is being made, by id
+int* run_ids;
+int num_runs = 0;
+int max_runs = 64;
+int next_run_id = 0;
+//How many runs can be merged in one pass with the memory we have
+int fanout;
+//Where our files go, and a prefix unique to this process so that several solvers can share a directory
+const char* work_directory;
+int file_prefix;
+//I/O statistics for the current layer and for the whole search
+long long layer_bytes_read = 0, layer_bytes_written = 0;
+long long total_bytes_read = 0, total_bytes_written = 0;
+//The deadline and node limit, and whether the search was cancelled
+struct search_control control;
+/*============================================================================================== */
+
+
+/**
+ * The path of the run with the given id
+ */
+static void run_path(char* path, int run_id){
+	sprintf(path, "%s/npuzzle_%d_run_%d", work_directory, file_prefix, run_id);
+}
+
+
+/**
+ * The path of a layer file. Only two layers are ever needed at once, so they alternate between two files
+ */
+static void layer_path(char* path, int depth){
+	sprintf(path, "%s/npuzzle_%d_layer_%d", work_directory, file_prefix, depth % 2);
+}
+
+
+/**
+ * Open a file with a large buffer, so that every read or write goes to disk in big sequential blocks
+ */
+static FILE* open_file(const char* path, const char* mode){
+	FILE* file = fopen(path, mode);
+
+	if(file == NULL){
+		printf("ERROR. Could not open %s.\n", path);
+		exit(1);
+	}
+
+	setvbuf(file, NULL, _IOFBF, BLOCK_SIZE);
+	return file;
+}
+
+
+/**
+ * Write one record, keeping track of how much we've written
+ */
+static void write_record(FILE* file, const unsigned char* record){
+	if(fwrite(record, record_size, 1, file) != 1){
+		printf("ERROR. Write failed, the disk may be full.\n");
+		exit(1);
+	}
+
+	layer_bytes_written += record_size;
+}
+
+
+/**
+ * Read one record, keeping track of how much we've read. Returns 0 at the end of the file
+ */
+static int read_record(FILE* file, unsigned char* record){
+	if(fread(record, record_size, 1, file) != 1){
+		return 0;
+	}
+
+	layer_bytes_read += record_size;
+	return 1;
+}
+
+
+/**
+ * Records are ordered by their packed state only, the mask doesn't matter
+ */
+static int compare_records(const void* a, const void* b){
+	return memcmp(a, b, packed_size);
+}
+
+
+/**
+ * Sort the run buffer, combine the duplicates in it, and write it out as a new run
+ */
+static void flush_run_buffer(){
+	char path[4096];
+
+	if(run_buffer_count == 0){
+		return;
+	}
+
+	qsort(run_buffer, run_buffer_count, record_size, compare_records);
+
+	//Keep track of the run
+	if(num_runs == max_runs){
+		max_runs *= 2;
+		run_ids = (int*)realloc(run_ids, sizeof(int) * max_runs);
+	}
+	run_ids[num_runs++] = next_run_id;
+	run_path(path, next_run_id++);
+
+	FILE* run = open_file(path, "wb");
+
+	//Duplicates are next to each other now, so fold each one into the first copy before writing it
+	unsigned char* pending = run_buffer;
+	for(long i = 1; i < run_buffer_count; i++){
+		unsigned char* record = run_buffer + i * record_size;
+
+		if(compare_records(pending, record) == 0){
+			pending[packed_size] |= record[packed_size];
+		} else {
+			write_record(run, pending);
+			pending = record;
+		}
+	}
+	write_record(run, pending);
+
+	fclose(run);
+	run_buffer_count = 0;
+}
+
+
+/**
+ * Add a successor to the run buffer, flushing it to disk first if it is full
+ */
+static void add_to_run(struct state* statePtr, unsigned char mask, const int N){
+	if(run_buffer_count == run_buffer_capacity){
+		flush_run_buffer();
+	}
+
+	unsigned char* record = run_buffer + run_buffer_count * record_size;
+	pack_state(statePtr, record, N);
+	record[packed_size] = mask;
+	run_buffer_count++;
+}
+
+
+/**
+ * One input of a merge, with the record it is currently on
+ */
+struct merge_input{
+	FILE* file;
+	unsigned char* record;
+};
+
+
+/**
+ * Restore the heap property of the merge heap from the given index down. The heap holds the indices of the inputs,
+ * ordered by their current records
+ */
+static void merge_heapify(int* heap, int heap_size, struct merge_input* inputs, int index){
+	while(1){
+		int smallest = index;
+		int left = 2 * index + 1;
+		int right = 2 * index + 2;
+
+		if(left < heap_size && compare_records(inputs[heap[left]].record, inputs[heap[smallest]].record) < 0){
+			smallest = left;
+		}
+		if(right < heap_size && compare_records(inputs[heap[right]].record, inputs[heap[smallest]].record) < 0){
+			smallest = right;
+		}
+
+		if(smallest == index){
+			return;
+		}
+
+		int temp = heap[index];
+		heap[index] = heap[smallest];
+		heap[smallest] = temp;
+		index = smallest;
+	}
+}
+
+
+/**
+ * Merge the given runs into one sorted file with no duplicates, deleting the runs as we go. Returns the number of
+ * records written
+ */
+static long long merge_runs(const int* ids, int count, const char* output_path){
+	char path[4096];
+	struct merge_input inputs[count];
+	int heap[count];
+	int heap_size = 0;
+
+	//Open every run and grab its first record
+	for(int i = 0; i < count; i++){
+		run_path(path, ids[i]);
+		inputs[i].file = open_file(path, "rb");
+		inputs[i].record = (unsigned char*)malloc(record_size);
+
+		if(read_record(inputs[i].file, inputs[i].record)){
+			heap[heap_size++] = i;
+		}
+	}
+
+	for(int i = heap_size / 2 - 1; i >= 0; i--){
+		merge_heapify(heap, heap_size, inputs, i);
+	}
+
+	FILE* output = open_file(output_path, "wb");
+	unsigned char* pending = (unsigned char*)malloc(record_size);
+	int have_pending = 0;
+	long long written = 0;
+
+	//Always take the smallest record of any input
+	while(heap_size > 0){
+		struct merge_input* smallest = &inputs[heap[0]];
+
+		//Duplicates come out one after another, so combine their masks
+		if(have_pending && compare_records(pending, smallest->record) == 0){
+			pending[packed_size] |= smallest->record[packed_size];
+		} else {
+			if(have_pending){
+				write_record(output, pending);
+				written++;
+			}
+			memcpy(pending, smallest->record, record_size);
+			have_pending = 1;
+		}
+
+		//Move the input along, dropping it from the heap once it runs out
+		if(!read_record(smallest->file, smallest->record)){
+			heap[0] = heap[--heap_size];
+		}
+		merge_heapify(heap, heap_size, inputs, 0);
+	}
+
+	if(have_pending){
+		write_record(output, pending);
+		written++;
+	}
+
+	fclose(output);
+	free(pending);
+
+	//The runs aren't needed anymore
+	for(int i = 0; i < count; i++){
+		fclose(inputs[i].file);
+		free(inputs[i].record);
+		run_path(path, ids[i]);
+		remove(path);
+	}
+
+	return written;
+}
+
+
+/**
+ * Merge every run of the layer into the layer file. If there are more runs than we can merge at once, they are merged
+ * in groups first, which takes more passes but never more memory. Returns the number of states in the layer
+ */
+static long long merge_layer(const char* output_path){
+	char path[4096];
+
+	//A layer with no states still needs an empty file
+	if(num_runs == 0){
+		fclose(open_file(output_path, "wb"));
+		return 0;
+	}
+
+	//Merge groups of runs into bigger runs until one pass is enough
+	while(num_runs > fanout){
+		int new_num_runs = 0;
+
+		for(int first = 0; first < num_runs; first += fanout){
+			int count = num_runs - first < fanout ? num_runs - first : fanout;
+			int merged_id = next_run_id++;
+
+			run_path(path, merged_id);
+			merge_runs(run_ids + first, count, path);
+			run_ids[new_num_runs++] = merged_id;
+		}
+
+		num_runs = new_num_runs;
+	}
+
+	long long layer_size = merge_runs(run_ids, num_runs, output_path);
+	num_runs = 0;
+	return layer_size;
+}
+
+
+/**
+ * Run one breadth first search with every state whose f goes over bound cut off. Returns the depth of the goal if it
+ * was found, -1 if not, or SEARCH_STOPPED if the search had to stop first. The smallest f that was cut off is stored
+ * in next_bound, or -1 if nothing was cut off
+ */
+static int bounded_search(const int N, struct state* start_state, struct state* goal_state, int bound, int* next_bound,
+						  long long* expansions, long long* generated){
+	char current_path[4096], next_path[4096];
+	unsigned char* record = (unsigned char*)malloc(record_size);
+
+	//The states we expand and make, allocated once
+	struct state* parent = (struct state*)malloc(sizeof(struct state));
+	struct state* child = (struct state*)malloc(sizeof(struct state));
+	initialize_state(parent, N);
+	initialize_state(child, N);
+
+	*next_bound = -1;
+
+	//The first layer is just the start state, with nowhere to go back to
+	layer_path(current_path, 0);
+	FILE* layer = open_file(current_path, "wb");
+	pack_state(start_state, record, N);
+	record[packed_size] = 0;
+	write_record(layer, record);
+	fclose(layer);
+
+	int found_depth = -1;
+
+	for(int depth = 0; found_depth == -1; depth++){
+		layer_path(current_path, depth);
+		layer_path(next_path, depth + 1);
+		layer = open_file(current_path, "rb");
+
+		//Expand every state in the layer
+		while(read_record(layer, record)){
+			unpack_state(record, parent, N);
+			parent->current_travel = depth;
+			parent->predecessor = NULL;
+			(*expansions)++;
+
+			//Give up once the deadline or node limit runs out, or if someone cancels the search
+			if(search_should_stop(&control, 1) != SEARCH_RUNNING){
+				found_depth = SEARCH_STOPPED;
+				break;
+			}
+
+			//Incremental heuristics build on the parent's evaluation
+			if(heuristic_is_incremental()){
+				update_heuristic(parent, N, cache);
+			}
+
+			//0 = left, 1 = right, 2 = down, 3 = up. Each move is undone by the move with its lowest bit flipped
+			for(int move = 0; move < 4; move++){
+				//Skip moves that go back to the previous layer, or off of the board
+				if((record[packed_size] >> move) & 1){
+					continue;
+				}
+				if((move == 0 && parent->zero_column == 0) || (move == 1 && parent->zero_column == N - 1)
+				   || (move == 2 && parent->zero_row == N - 1) || (move == 3 && parent->zero_row == 0)){
+					continue;
+				}
+
+				copy_state(parent, child, N);
+				if(move == 0){
+					move_left(child, N);
+				} else if(move == 1){
+					move_right(child, N);
+				} else if(move == 2){
+					move_down(child, N);
+				} else {
+					move_up(child, N);
+				}
+				(*generated)++;
+
+				//Breadth first, so the first time we see the goal is the shortest way to it
+				if(states_same(child, goal_state, N)){
+					found_depth = depth + 1;
+					break;
+				}
+
+				//Cut off anything that goes over the bound, remembering the smallest f that did
+				update_heuristic(child, N, cache);
+				if(child->total_cost > bound){
+					if(*next_bound == -1 || child->total_cost < *next_bound){
+						*next_bound = child->total_cost;
+					}
+					continue;
+				}
+
+				add_to_run(child, 1 << (move ^ 1), N);
+			}
+
+			if(found_depth != -1){
+				break;
+			}
+		}
+
+		fclose(layer);
+		remove(current_path);
+
+		if(found_depth != -1){
+			//Throw away the partial next layer, whether we found the goal or stopped
+			run_buffer_count = 0;
+			for(int i = 0; i < num_runs; i++){
+				run_path(next_path, run_ids[i]);
+				remove(next_path);
+			}
+			num_runs = 0;
+		} else {
+			//Write out whatever is left, then merge everything into the next layer
+			flush_run_buffer();
+			long long layer_size = merge_layer(next_path);
+
+			printf("Bound %3d, layer %3d: %12lld states, %10.2f MB written, %10.2f MB read\n", bound, depth + 1, layer_size,
+				   layer_bytes_written / 1048576.0, layer_bytes_read / 1048576.0);
+
+			//Nothing left within this bound
+			if(layer_size == 0){
+				remove(next_path);
+				break;
+			}
+		}
+
+		total_bytes_read += layer_bytes_read;
+		total_bytes_written += layer_bytes_written;
+		layer_bytes_read = layer_bytes_written = 0;
+	}
+
+	total_bytes_read += layer_bytes_read;
+	total_bytes_written += layer_bytes_written;
+	layer_bytes_read = layer_bytes_written = 0;
+
+	destroy_state(parent);
+	destroy_state(child);
+	free(parent);
+	free(child);
+	free(record);
+
+	return found_depth;
+}
+
+
+/**
+ * Use a breadth first iterative deepening search with delayed duplicate detection to solve the N-puzzle problem. If
+ * the solve function is successful, it will print the length of the solution to the console.
+ */
+int solve(int N, struct state* start_state, struct state* goal_state, struct solver_options* options){
+	//Get the CPU clock start time
+	clock_t begin_CPU = clock();
+
+	//Set up our records and the buffer that runs are sorted in
+	packed_size = packed_state_size(N);
+	record_size = packed_size + 1;
+	run_buffer_capacity = options->memory_limit * 1048576 / record_size;
+	run_buffer = (unsigned char*)malloc(run_buffer_capacity * record_size);
+	run_ids = (int*)malloc(sizeof(int) * max_runs);
+	work_directory = options->work_directory;
+	file_prefix = getpid();
+
+	//Each run being merged needs one block of buffering
+	fanout = options->memory_limit * 1048576 / BLOCK_SIZE;
+	if(fanout < 2){
+		fanout = 2;
+	} else if(fanout > MAX_FANOUT){
+		fanout = MAX_FANOUT;
+	}
+
+	long long expansions = 0, generated = 0;
+	int depth = -1, bound = 0;
+
+	//We may already be done
+	if(states_same(start_state, goal_state, N)){
+		depth = 0;
+	} else {
+		//The first bound is the heuristic of the start state, after that it is the smallest f that was cut off
+		update_heuristic(start_state, N, cache);
+		bound = start_state->total_cost;
+
+		while(bound != -1){
+			int next_bound;
+			depth = bounded_search(N, start_state, goal_state, bound, &next_bound, &expansions, &generated);
+
+			if(depth != -1){
+				break;
+			}
+
+			bound = next_bound;
+		}
+	}
+
+	//Stop the clock
+	clock_t end_CPU = clock();
+	double time_spent_CPU = (double)(end_CPU - begin_CPU) / CLOCKS_PER_SEC;
+
+	free(run_buffer);
+	free(run_ids);
+
+	//If nothing was ever cut off and we still didn't find the goal, there is no solution
+	if(depth == -1){
+		printf("No solution.\n");
+		return 0;
+	}
+
+	//Every bound before this one was searched in full without finding the goal, so the solution is at least this long.
+	//A weighted search cuts off states that the optimal path may go through, so all that it proves is the start's heuristic
+	if(depth == SEARCH_STOPPED){
+		printf("\nSearch stopped before a solution was found. The external search keeps no paths, so there is none to show\n");
+		printf("------------- Program Running Statistics -------------\n\n");
+		//Plus one since path lengths count the start state
+		print_search_stopped(&control, (heuristic_weight() == 1.0 ? bound : start_state->heuristic_cost) + 1, expansions);
+		printf("Total disk traffic: %.2f MB written, %.2f MB read\n", total_bytes_written / 1048576.0, total_bytes_read / 1048576.0);
+		printf("Heuristic: %s\n", heuristic_name());
+		printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);
+		printf("------------------------------------------------------\n\n");
+		return SEARCH_STOPPED_EXIT;
+	}
+
+	printf("\nSolution found!\n\n");
+
+	//Print out all running statistics
+	printf("------------- Program Running Statistics -------------\n\n");
+	//Print out the path length, counting the start state like the other solvers
+	printf("Optimal solution path length: %d\n", depth + 1);
+	//Print out the work done
+	printf("Expansions: %lld, states generated: %lld\n", expansions, generated);
+	//Print out the disk traffic
+	printf("Total disk traffic: %.2f MB written, %.2f MB read\n", total_bytes_written / 1048576.0, total_bytes_read / 1048576.0);
+	//Print out the memory used for sorting
+	printf("Sort buffer: %.2f MB, merge fanout %d\n", run_buffer_capacity * record_size / 1048576.0, fanout);
+	//Print out which heuristic was used
+	printf("Heuristic: %s\n", heuristic_name());
+	//Print out how well the heuristic cache did
+	if(cache != NULL){
+		print_heuristic_cache_stats(cache);
+	}
+	//Print out CPU time(NOT wall time) spent
+	printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);
+	printf("------------------------------------------------------\n\n");
+
+	return 0;
+}
+
+
+/**
+ * The main function simply makes the needed calls to the initialize and solve function after checking command
+ * line arguments
+ */
+int main(int argc, char** argv){
+	//The size of our N puzzle
+	int N;
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
+
+	//If the user put in a non-integer or nonpositive integer, print an error
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1){
+		printf("Incorrect type of program arguments.\n");
+		printf("Usage: ./solve_external [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Check if the number of arguments is correct. If not, exit the program and print an error
+	if(argc != N*N + 2){
+		//Give an error message
+		printf("Incorrect number of program arguments.\n");
+		printf("Usage: ./solve_external [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Important: Move the address of argv up by 1 so that initialize_start_goal can only see the initial config
+	argv += 1;
+
+	//The starting and goal states, must create and reserve space
+	struct state* start_state = (struct state*)malloc(sizeof(struct state));
+	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
+
+	//Initialize the goal and start states
+	if(initialize_start_goal(argv, start_state, goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//This solver always finds the optimal solution
+	if(options.weight != 1.0){
+		printf("ERROR. --weight is not supported by external memory search, use solve or solve_anytime.\n\n");
+		return 1;
+	}
+
+	//This search only finds optimal solutions, which a heuristic that overestimates can't promise
+	if(!heuristic_specification_admissible(options.heuristic)){
+		printf("ERROR. Heuristic %s adds overlapping heuristics, which can overestimate, so it is not supported by external memory search, use solve.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//Load or build everything the heuristic needs once, up front
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+
+	//Create the heuristic cache, unless the user turned it off
+	cache = create_heuristic_cache_for(&options);
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Call the solve() funciton and hand off the rest of the program execution to it
+	return solve(N, start_state, goal_state, &options);
+}
@@ -0,0 +1,679 @@
+/**
+ * Author: Jack Robbins
+ * This program implements a frontier A* search to find the shortest solve path for the N-puzzle problem. It takes in an
+ * N-puzzle problem starting configuration in row-major order as a command line argument, following a number N for the
+ * NxN size of the puzzle, and prints out the full solution path to the problem, step by step, if such a solution exists.
+ *
+ * The regular solver keeps every expanded state in closed forever, both to reject duplicates and to keep the predecessor
+ * chain alive for printing the solution. Frontier search keeps only the open states. Every open state remembers which of
+ * its moves lead to a neighbor that has already been expanded(its used operators), and those moves are never made, so an
+ * expanded state is never generated again and can be thrown away right after it is expanded. Peak memory is then the size
+ * of the largest frontier, not of everything the search has ever seen.
+ *
+ * Since there are no predecessors, the solution path is rebuilt by divide and conquer. Every open state carries a copy of
+ * the state roughly halfway along its path from the start(its midpoint). Once the target is found, its midpoint splits the
+ * problem in two, and each half is solved the same way until the halves are a single move long.
+ *
+ * Note: This is the frontier search version of the solver. Every half has its own target, so only heuristics that
+ * support arbitrary targets(md and lc) can be used
+ */
+
+//For timing
+#include <time.h>
+#include "npuzzle.h"
+
+
+//Define an initial starting size for the open heap and the open table
+#define INITIAL_HEAP_SIZE 5000
+#define INITIAL_TABLE_SIZE 8192
+//What frontier_search returns when it was stopped before it found the target
+#define SEARCH_STOPPED -2
+
+
+/**
+ * A midpoint state, shared by every open state that descends from it
+ */
+struct midpoint{
+	struct state* state;
+	int references;
+};
+
+
+/**
+ * An open state with everything frontier search needs to know about it
+ */
+struct frontier_node{
+	struct state* state;
+	//Bit i is set if move i leads to a state that has already been expanded. 0 = left, 1 = right, 2 = down, 3 = up
+	unsigned char used_operators;
+	//The state about halfway along the path to this state, NULL until there is one
+	struct midpoint* midpoint;
+	//Where this node is in the open heap, so that its priority can be lowered
+	int heap_index;
+	//The next node in the same bucket of the open table
+	struct frontier_node* next_in_bucket;
+};
+
+
+/*================================= Global variables for convenience =========================== */
+//The open list, maintained as a minHeap ordered by f, with ties going to the larger g
+struct frontier_node** heap;
+int heap_size = 0, heap_max_size = INITIAL_HEAP_SIZE;
+//A chained hash table of every open node, so that duplicates can be found
+struct frontier_node** table;
+int table_size = INITIAL_TABLE_SIZE;
+//When the length of a path is already known, its midpoint is the state at exactly this depth. 0 means unknown
+int midpoint_depth = 0;
+//Running statistics across every search, including the searches that rebuild the path
+long expansions = 0, generated = 0;
+int peak_open = 0;
+//The deadline and node limit, and whether the search was cancelled. Only the first search can be stopped, rebuilding
+//the path once its length is known always finishes
+struct search_control control;
+int stoppable = 1;
+//The lowest cost on the open list when the search was stopped
+int stopped_cost = 0;
+//The heuristic cache that sits in front of the heuristic, NULL if turned off. Shared by every search, so the target is
+//part of each key
+struct heuristic_cache* cache = NULL;
+/*============================================================================================== */
+
+
+/**
+ * Take away one reference to a midpoint, freeing it when nobody uses it anymore
+ */
+static void release_midpoint(struct midpoint* midpoint){
+	if(midpoint != NULL && --midpoint->references == 0){
+		destroy_state(midpoint->state);
+		free(midpoint->state);
+		free(midpoint);
+	}
+}
+
+
+/**
+ * Whether node a should come out of the heap before node b
+ */
+static int comes_before(struct frontier_node* a, struct frontier_node* b){
+	if(a->state->total_cost != b->state->total_cost){
+		return a->state->total_cost < b->state->total_cost;
+	}
+
+	//The deeper state is closer to the target
+	return a->state->current_travel > b->state->current_travel;
+}
+
+
+/**
+ * Put a node at an index in the heap, keeping its heap_index up to date
+ */
+static void heap_place(struct frontier_node* node, int index){
+	heap[index] = node;
+	node->heap_index = index;
+}
+
+
+/**
+ * Move the node at index up the heap until its parent comes before it
+ */
+static void sift_up(int index){
+	struct frontier_node* node = heap[index];
+
+	while(index > 0 && comes_before(node, heap[(index - 1) / 2])){
+		heap_place(heap[(index - 1) / 2], index);
+		index = (index - 1) / 2;
+	}
+
+	heap_place(node, index);
+}
+
+
+/**
+ * Move the node at index down the heap until it comes before both of its children
+ */
+static void sift_down(int index){
+	struct frontier_node* node = heap[index];
+
+	while(1){
+		int child = index * 2 + 1;
+
+		if(child >= heap_size){
+			break;
+		}
+		if(child + 1 < heap_size && comes_before(heap[child + 1], heap[child])){
+			child++;
+		}
+		if(!comes_before(heap[child], node)){
+			break;
+		}
+
+		heap_place(heap[child], index);
+		index = child;
+	}
+
+	heap_place(node, index);
+}
+
+
+/**
+ * Find the bucket of the open table that a state belongs in
+ */
+static int table_bucket(struct state* statePtr, const int N){
+	return hash_state(statePtr, N) & (table_size - 1);
+}
+
+
+/**
+ * Find the open node holding the same tiles as statePtr, or NULL if there isn't one
+ */
+static struct frontier_node* table_lookup(struct state* statePtr, const int N){
+	struct frontier_node* cursor = table[table_bucket(statePtr, N)];
+
+	while(cursor != NULL && !states_same(cursor->state, statePtr, N)){
+		cursor = cursor->next_in_bucket;
+	}
+
+	return cursor;
+}
+
+
+/**
+ * Double the open table when it gets as many nodes as it has buckets
+ */
+static void table_grow(const int N){
+	struct frontier_node** old_table = table;
+	int old_size = table_size;
+
+	table_size *= 2;
+	table = (struct frontier_node**)calloc(table_size, sizeof(struct frontier_node*));
+
+	//Move every node over to its new bucket
+	for(int i = 0; i < old_size; i++){
+		struct frontier_node* cursor = old_table[i];
+		while(cursor != NULL){
+			struct frontier_node* next = cursor->next_in_bucket;
+			int bucket = table_bucket(cursor->state, N);
+			cursor->next_in_bucket = table[bucket];
+			table[bucket] = cursor;
+			cursor = next;
+		}
+	}
+
+	free(old_table);
+}
+
+
+/**
+ * Add a new node to the open heap and the open table
+ */
+static void open_insert(struct frontier_node* node, const int N){
+	if(heap_size == heap_max_size){
+		heap_max_size *= 2;
+		heap = (struct frontier_node**)realloc(heap, sizeof(struct frontier_node*) * heap_max_size);
+	}
+	if(heap_size == table_size){
+		table_grow(N);
+	}
+
+	heap[heap_size] = node;
+	sift_up(heap_size++);
+
+	int bucket = table_bucket(node->state, N);
+	node->next_in_bucket = table[bucket];
+	table[bucket] = node;
+
+	if(heap_size > peak_open){
+		peak_open = heap_size;
+	}
+}
+
+
+/**
+ * Take the best node off of the open heap and out of the open table
+ */
+static struct frontier_node* open_dequeue(const int N){
+	struct frontier_node* node = heap[0];
+
+	heap_size--;
+	if(heap_size > 0){
+		heap_place(heap[heap_size], 0);
+		sift_down(0);
+	}
+
+	//Unlink it from its bucket
+	struct frontier_node** link = &table[table_bucket(node->state, N)];
+	while(*link != node){
+		link = &(*link)->next_in_bucket;
+	}
+	*link = node->next_in_bucket;
+
+	return node;
+}
+
+
+/**
+ * Free a node along with its state
+ */
+static void destroy_node(struct frontier_node* node){
+	release_midpoint(node->midpoint);
+	destroy_state(node->state);
+	free(node->state);
+	free(node);
+}
+
+
+/**
+ * Give child the midpoint it should have when reached through parent. A path gets its midpoint at midpoint_depth if
+ * we know it, or else at the first state that is at least halfway to its estimated total cost, and every state after
+ * that inherits it
+ */
+static void set_midpoint(struct frontier_node* child, struct frontier_node* parent, const int N){
+	release_midpoint(child->midpoint);
+
+	if(parent->midpoint != NULL){
+		child->midpoint = parent->midpoint;
+		child->midpoint->references++;
+	} else if(midpoint_depth > 0 ? child->state->current_travel == midpoint_depth
+			  : 2 * child->state->current_travel >= child->state->total_cost){
+		child->midpoint = (struct midpoint*)malloc(sizeof(struct midpoint));
+		child->midpoint->state = (struct state*)malloc(sizeof(struct state));
+		initialize_state(child->midpoint->state, N);
+		copy_state(child->state, child->midpoint->state, N);
+		child->midpoint->state->current_travel = child->state->current_travel;
+		child->midpoint->state->predecessor = NULL;
+		child->midpoint->references = 1;
+	} else {
+		child->midpoint = NULL;
+	}
+}
+
+
+/**
+ * The heuristic of a state towards the target, going through the heuristic cache if there is one. Every half of the path
+ * has its own target, so the target's key, multiplied so that swapping the state and the target gives another key, is
+ * mixed into the state's
+ */
+static int frontier_heuristic(struct state* statePtr, const short* target_positions, unsigned long long target_key, const int N){
+	int heuristic_cost;
+
+	//No cache, so just do the full calculation
+	if(cache == NULL){
+		return evaluate_target_heuristic(statePtr, target_positions, N);
+	}
+
+	//If we've seen this state before on the way to this target, we can skip the heuristic calculation entirely
+	unsigned long long key = hash_state(statePtr, N) ^ (target_key * 0x9E3779B97F4A7C15ULL);
+	if(heuristic_cache_lookup(cache, key, &heuristic_cost)){
+		return heuristic_cost;
+	}
+
+	//Otherwise calculate it and remember it for next time
+	heuristic_cost = evaluate_target_heuristic(statePtr, target_positions, N);
+	heuristic_cache_store(cache, key, heuristic_cost);
+	return heuristic_cost;
+}
+
+
+/**
+ * Run one frontier A* search from source to target. Returns the length of the shortest path, and stores a copy of the
+ * midpoint of that path in midpoint(NULL if the path is a single move or less). Returns -1 if there is no path, or
+ * SEARCH_STOPPED if the search had to stop first
+ */
+static int frontier_search(struct state* source, struct state* target, struct state** midpoint, const int N){
+	short* target_positions = create_target_positions(target, N);
+	unsigned long long target_key = compute_zobrist_key(target->tiles, N);
+	int path_length = -1;
+	*midpoint = NULL;
+
+	//Start from an empty open list
+	heap_size = 0;
+	memset(table, 0, sizeof(struct frontier_node*) * table_size);
+
+	//The root has no used operators and no midpoint
+	struct frontier_node* root = (struct frontier_node*)malloc(sizeof(struct frontier_node));
+	root->state = (struct state*)malloc(sizeof(struct state));
+	initialize_state(root->state, N);
+	copy_state(source, root->state, N);
+	root->state->current_travel = 0;
+	root->state->predecessor = NULL;
+	root->state->heuristic_cost = frontier_heuristic(root->state, target_positions, target_key, N);
+	root->state->total_cost = root->state->heuristic_cost;
+	root->used_operators = 0;
+	root->midpoint = NULL;
+	open_insert(root, N);
+
+	//Used to make successors, only kept when it turns out to be new
+	struct state* successor = (struct state*)malloc(sizeof(struct state));
+	initialize_state(successor, N);
+
+	while(heap_size > 0){
+		struct frontier_node* current = open_dequeue(N);
+		expansions++;
+
+		//Give up once the deadline or node limit runs out, or if someone cancels the search. Nothing cheaper than
+		//the state just dequeued is left, so its cost is a lower bound
+		if(stoppable && search_should_stop(&control, 1) != SEARCH_RUNNING){
+			stopped_cost = current->state->total_cost;
+			path_length = SEARCH_STOPPED;
+			destroy_node(current);
+			break;
+		}
+
+		//Found it. Hand back the midpoint before everything is freed
+		if(states_same(current->state, target, N)){
+			path_length = current->state->current_travel;
+			if(current->midpoint != NULL && current->midpoint->state->current_travel < path_length){
+				*midpoint = (struct state*)malloc(sizeof(struct state));
+				initialize_state(*midpoint, N);
+				copy_state(current->midpoint->state, *midpoint, N);
+				(*midpoint)->current_travel = current->midpoint->state->current_travel;
+				(*midpoint)->predecessor = NULL;
+			}
+			destroy_node(current);
+			break;
+		}
+
+		//Try every move that doesn't lead back to an expanded state
+		for(int move = 0; move < 4; move++){
+			if((current->used_operators >> move) & 1){
+				continue;
+			}
+			if((move == 0 && current->state->zero_column == 0) || (move == 1 && current->state->zero_column == N - 1)
+			   || (move == 2 && current->state->zero_row == N - 1) || (move == 3 && current->state->zero_row == 0)){
+				continue;
+			}
+
+			copy_state(current->state, successor, N);
+			successor->predecessor = NULL;
+			if(move == 0){
+				move_left(successor, N);
+			} else if(move == 1){
+				move_right(successor, N);
+			} else if(move == 2){
+				move_down(successor, N);
+			} else {
+				move_up(successor, N);
+			}
+			generated++;
+
+			//The move back to current is now used, whether or not the successor is new. Each move is undone by the
+			//move with its lowest bit flipped
+			struct frontier_node* existing = table_lookup(successor, N);
+			if(existing != NULL){
+				existing->used_operators |= 1 << (move ^ 1);
+
+				//We found a shorter way to an open state
+				if(successor->current_travel < existing->state->current_travel){
+					existing->state->current_travel = successor->current_travel;
+					existing->state->total_cost = successor->current_travel + existing->state->heuristic_cost;
+					set_midpoint(existing, current, N);
+					sift_up(existing->heap_index);
+				}
+				continue;
+			}
+
+			//A brand new state, which takes over the successor's memory
+			struct frontier_node* child = (struct frontier_node*)malloc(sizeof(struct frontier_node));
+			child->state = successor;
+			child->state->heuristic_cost = frontier_heuristic(successor, target_positions, target_key, N);
+			child->state->total_cost = successor->current_travel + successor->heuristic_cost;
+			child->used_operators = 1 << (move ^ 1);
+			child->midpoint = NULL;
+			set_midpoint(child, current, N);
+			open_insert(child, N);
+
+			successor = (struct state*)malloc(sizeof(struct state));
+			initialize_state(successor, N);
+		}
+
+		//Expanded states are never needed again
+		destroy_node(current);
+	}
+
+	//Clean out whatever is still open
+	for(int i = 0; i < heap_size; i++){
+		destroy_node(heap[i]);
+	}
+	heap_size = 0;
+
+	destroy_state(successor);
+	free(successor);
+	free(target_positions);
+
+	return path_length;
+}
+
+
+/**
+ * Make a copy of a state that can be put into a solution path
+ */
+static struct state* path_state(struct state* statePtr, const int N){
+	struct state* copy = (struct state*)malloc(sizeof(struct state));
+	initialize_state(copy, N);
+	copy_state(statePtr, copy, N);
+	copy->predecessor = NULL;
+	copy->next = NULL;
+	return copy;
+}
+
+
+/**
+ * Build the path from source to target, not including source itself, by splitting it at its midpoint and solving both
+ * halves. length is how long the path is expected to be. The states are appended after tail, and the new tail is returned
+ */
+static struct state* reconstruct_path(struct state* source, struct state* target, int length, struct state* tail, const int N){
+	//A single move, so the target comes right after the source
+	if(length <= 1){
+		if(length == 1){
+			tail->next = path_state(target, N);
+			tail = tail->next;
+		}
+		return tail;
+	}
+
+	//We know how long the path is, so we can ask for its exact middle
+	struct state* midpoint;
+	midpoint_depth = length / 2;
+	int path_length = frontier_search(source, target, &midpoint, N);
+	midpoint_depth = 0;
+
+	//Only possible if the heuristic overestimated, so search again now that we know the real length
+	if(midpoint == NULL){
+		return reconstruct_path(source, target, path_length, tail, N);
+	}
+
+	//Solve each half
+	int midpoint_travel = midpoint->current_travel;
+	tail = reconstruct_path(source, midpoint, midpoint_travel, tail, N);
+	tail = reconstruct_path(midpoint, target, path_length - midpoint_travel, tail, N);
+
+	destroy_state(midpoint);
+	free(midpoint);
+	return tail;
+}
+
+
+/**
+ * Use a frontier A* search to solve the N-puzzle problem. If the solve function is successful, it will print the
+ * resulting solution path to the console as well.
+ */
+int solve(int N, struct state* start_state, struct state* goal_state){
+	//Get the CPU clock start time
+	clock_t begin_CPU = clock();
+
+	heap = (struct frontier_node**)malloc(sizeof(struct frontier_node*) * heap_max_size);
+	table = (struct frontier_node**)calloc(table_size, sizeof(struct frontier_node*));
+
+	//The first search finds the length of the solution and its midpoint
+	struct state* midpoint;
+	int path_length = frontier_search(start_state, goal_state, &midpoint, N);
+
+	//Keep track of how much work the first search did, the rest is rebuilding the path
+	long search_expansions = expansions;
+	int search_peak_open = peak_open;
+	stoppable = 0;
+
+	if(path_length == -1){
+		printf("No solution.\n");
+		return 0;
+	}
+
+	//Frontier search keeps no predecessors, so there is no partial path to show, only the bound
+	if(path_length == SEARCH_STOPPED){
+		printf("\nSearch stopped before a solution was found. Frontier search keeps no paths, so there is none to show\n");
+		printf("------------- Program Running Statistics -------------\n\n");
+		//Plus one since path lengths count the start state
+		print_search_stopped(&control, stopped_cost + 1, search_expansions);
+		printf("Peak frontier size: %d states\n", search_peak_open);
+		printf("Heuristic: %s\n", heuristic_name());
+		printf("Total CPU time spent: %.7f seconds\n\n", (double)(clock() - begin_CPU) / CLOCKS_PER_SEC);
+		printf("------------------------------------------------------\n\n");
+		return SEARCH_STOPPED_EXIT;
+	}
+
+	//The solution path starts with the start state, and each half is filled in after it
+	struct state* solution_path = path_state(start_state, N);
+	struct state* tail = solution_path;
+	if(midpoint == NULL){
+		reconstruct_path(start_state, goal_state, path_length, tail, N);
+	} else {
+		tail = reconstruct_path(start_state, midpoint, midpoint->current_travel, tail, N);
+		reconstruct_path(midpoint, goal_state, path_length - midpoint->current_travel, tail, N);
+		destroy_state(midpoint);
+		free(midpoint);
+	}
+
+	//Stop the clock
+	clock_t end_CPU = clock();
+	double time_spent_CPU = (double)(end_CPU - begin_CPU) / CLOCKS_PER_SEC;
+
+	//Print out the solution path first
+	printf("\nSolution found! Now displaying solution path\n");
+	//Display the path length for the user, counting the start state like the other solvers
+	printf("Path Length: %d\n\n", path_length + 1);
+
+	//Print out the solution path in order
+	for(struct state* cursor = solution_path; cursor != NULL; cursor = cursor->next){
+		print_state(cursor, N, 0);
+	}
+
+	//Print out all running statistics
+	printf("------------- Program Running Statistics -------------\n\n");
+	//Print out the path length
+	printf("Optimal solution path length: %d\n", path_length + 1);
+	//Print out the work done by the main search and by rebuilding the path
+	printf("Expansions: %ld in the search, %ld rebuilding the path, %ld states generated\n", search_expansions,
+		   expansions - search_expansions, generated);
+	//The peak frontier is all we ever held, closed would have held every expansion
+	printf("Peak frontier size: %d states(%.2f MB), a closed list would have held %ld states\n", search_peak_open,
+		   search_peak_open * (sizeof(struct frontier_node) + sizeof(struct state) + N*N*sizeof(short)) / 1048576.0, search_expansions);
+	//Print out which heuristic was used
+	printf("Heuristic: %s\n", heuristic_name());
+	//Print out how well the heuristic cache did
+	if(cache != NULL){
+		print_heuristic_cache_stats(cache);
+	}
+	//Print out CPU time(NOT wall time) spent
+	printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);
+	printf("------------------------------------------------------\n\n");
+
+	//Clean up the path
+	while(solution_path != NULL){
+		struct state* next = solution_path->next;
+		destroy_state(solution_path);
+		free(solution_path);
+		solution_path = next;
+	}
+	free(heap);
+	free(table);
+
+	return 0;
+}
+
+
+/**
+ * The main function simply makes the needed calls to the initialize and solve function after checking command
+ * line arguments
+ */
+int main(int argc, char** argv){
+	//The size of our N puzzle
+	int N;
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
+
+	//If the user put in a non-integer or nonpositive integer, print an error
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1){
+		printf("Incorrect type of program arguments.\n");
+		printf("Usage: ./solve_frontier [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Check if the number of arguments is correct. If not, exit the program and print an error
+	if(argc != N*N + 2){
+		//Give an error message
+		printf("Incorrect number of program arguments.\n");
+		printf("Usage: ./solve_frontier [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Important: Move the address of argv up by 1 so that initialize_start_goal can only see the initial config
+	argv += 1;
+
+	//The starting and goal states, must create and reserve space
+	struct state* start_state = (struct state*)malloc(sizeof(struct state));
+	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
+
+	//Initialize the goal and start states
+	if(initialize_start_goal(argv, start_state, goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//This solver always finds the optimal solution
+	if(options.weight != 1.0){
+		printf("ERROR. --weight is not supported by frontier search, use solve or solve_anytime.\n\n");
+		return 1;
+	}
+
+	//This search only finds optimal solutions, which a heuristic that overestimates can't promise
+	if(!heuristic_specification_admissible(options.heuristic)){
+		printf("ERROR. Heuristic %s adds overlapping heuristics, which can overestimate, so it is not supported by frontier search, use solve.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//Load or build everything the heuristic needs once, up front
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+
+	//Rebuilding the path searches towards midpoints, not just the goal
+	if(!heuristic_supports_targets()){
+		printf("ERROR. Heuristic %s only works towards the goal state, so it can't be used to rebuild the path.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//Create the heuristic cache, unless the user turned it off
+	cache = create_heuristic_cache_for(&options);
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Call the solve() funciton and hand off the rest of the program execution to it
+	return solve(N, start_state, goal_state);
+}
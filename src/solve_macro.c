@@ -0,0 +1,874 @@
+/**
+ * Author: Jack Robbins
+ * This program solves very large N-puzzle problems(10x10 up to 180x180) in polynomial time, at the cost of optimality.
+ * It takes in an N-puzzle problem starting configuration in row-major order as a command line argument following a number N
+ * for the NxN size of the puzzle, or reads the configuration from stdin if only N is given. It prints the solution as a
+ * stream of blank moves, L, R, U and D, as it is found.
+ *
+ * Rather than searching, the puzzle is reduced one line at a time. Whichever of the top row and the left column of the
+ * unsolved part is longer gets solved, by moving its tiles into place one at a time, and is then locked in place, which
+ * leaves a smaller puzzle. All but the last two tiles of a line are moved straight to their goal. The last two are placed
+ * with the well known end of line macro: the last tile is put in the corner with the one before it just below(or beside)
+ * it, and two blank moves rotate both of them into place. Once only a 3x3 block is left, it is solved optimally with a
+ * breadth first search over its 181440 configurations.
+ *
+ * A tile is moved by stepping it one cell at a time towards its goal, bringing the blank around in front of it for every
+ * step. The blank is routed greedily, and with a small breadth first search around the tile when the greedy route is
+ * blocked, so every step costs constant time and the whole puzzle takes O(N^3) moves and time.
+ *
+ * The optional optimizer first cancels every move that is immediately undone, then the window pass replays the moves and
+ * cuts out any longer stretch of at most OPTIMIZER_WINDOW moves that leaves the board exactly as it was.
+ *
+ * A goal given with --goal is relabeled onto the standard one just like the search solvers do, and every move is flipped
+ * back as it is printed. A goal whose blank isn't in a corner can't be relabeled, so both the start and the goal are
+ * solved to the standard goal instead, and the goal's moves are played backwards to finish.
+ *
+ * Note: This is the constructive(non optimal) version of the solver
+ */
+
+//For timing
+#include <time.h>
+#include "npuzzle.h"
+
+
+//The final block is solved by breadth first search, and is at most this wide
+#define FINAL_BLOCK_SIZE 3
+//9! entries is enough to mark every arrangement of the final block
+#define FINAL_BLOCK_PERMUTATIONS 362880
+//Tiles are stored as shorts, so the biggest puzzle we can hold is 181x181
+#define MAX_N 181
+//Moves are printed this many to a line
+#define MOVES_PER_LINE 100
+//The window optimizer only looks this many moves back for a repeated board
+#define OPTIMIZER_WINDOW 1024
+//The window optimizer's table of recently seen boards, must be a power of 2
+#define OPTIMIZER_TABLE_SIZE 16384
+
+
+/*================================= Global variables for convenience =========================== */
+//The size of the puzzle
+int N;
+//The board that we are solving, along with the position of every tile so we never have to search for one
+struct state* board;
+int* position;
+//Cells that hold a solved tile and may no longer be moved
+char* locked;
+//When set, rows are treated as columns and columns as rows, so that one set of functions solves both
+int transposed = 0;
+//Every move made so far. While streaming, moves are printed as soon as they are made
+char* moves;
+long move_count = 0, move_capacity = 1 << 16;
+int streaming = 1;
+long printed_moves = 0;
+//Scratch space for routing the blank with breadth first search
+int* bfs_queue;
+int* bfs_parent;
+int* bfs_seen;
+int bfs_generation = 0;
+/*============================================================================================== */
+
+
+/**
+ * The actual cell that a row and column refer to, taking transposition into account
+ */
+static int cell(int row, int column){
+	return transposed ? column * N + row : row * N + column;
+}
+
+
+/**
+ * The row of an actual cell, taking transposition into account
+ */
+static int cell_row(int index){
+	return transposed ? index % N : index / N;
+}
+
+
+/**
+ * The column of an actual cell, taking transposition into account
+ */
+static int cell_column(int index){
+	return transposed ? index / N : index % N;
+}
+
+
+/**
+ * The move that the user sees for a move made on the relabeled board, see user_move
+ */
+static char user_letter(char move){
+	const char* letters = "LRDU";
+	return letters[user_move(strchr(letters, move) - letters)];
+}
+
+
+/**
+ * The move that undoes a move
+ */
+static char inverse_move(char move){
+	return move == 'L' ? 'R' : move == 'R' ? 'L' : move == 'U' ? 'D' : 'U';
+}
+
+
+/**
+ * Print a move the way that the user sees it, keeping to MOVES_PER_LINE moves per line
+ */
+static void print_move(char move){
+	putchar(user_letter(move));
+	if(++printed_moves % MOVES_PER_LINE == 0){
+		putchar('\n');
+	}
+}
+
+
+/**
+ * Move the blank in the actual direction given by L, R, U or D, keeping track of the tile that moved and recording
+ * the move. The move must be legal, this is not checked
+ */
+static void make_move(char move){
+	int old_blank = board->zero_row * N + board->zero_column;
+
+	if(move == 'L'){
+		move_left(board, N);
+	} else if(move == 'R'){
+		move_right(board, N);
+	} else if(move == 'U'){
+		move_up(board, N);
+	} else {
+		move_down(board, N);
+	}
+
+	//The tile that used to be where the blank went is now where the blank was
+	position[board->tiles[old_blank]] = old_blank;
+	position[0] = board->zero_row * N + board->zero_column;
+
+	//Record the move, growing the list as needed
+	if(move_count == move_capacity){
+		move_capacity *= 2;
+		moves = (char*)realloc(moves, move_capacity);
+	}
+	moves[move_count++] = move;
+
+	if(streaming){
+		print_move(move);
+	}
+}
+
+
+/**
+ * The actual move that takes the blank from one cell to a neighbouring cell
+ */
+static char move_between(int from, int to){
+	if(to == from - 1){
+		return 'L';
+	} else if(to == from + 1){
+		return 'R';
+	} else if(to == from - N){
+		return 'U';
+	}
+
+	return 'D';
+}
+
+
+/**
+ * Route the blank to the target cell without passing through any locked cell, only searching cells within the box
+ * of rows and columns given. Returns 1 if the blank got there, or 0 if the box had no route and nothing was moved
+ */
+static int route_blank_in_box(int target, int top, int bottom, int left, int right){
+	int start = position[0];
+	int head = 0, tail = 0;
+
+	//A new generation means every cell is unseen, without clearing anything
+	bfs_generation++;
+	bfs_seen[start] = bfs_generation;
+	bfs_queue[tail++] = start;
+
+	while(head < tail && bfs_seen[target] != bfs_generation){
+		int current = bfs_queue[head++];
+		int row = current / N, column = current % N;
+		int neighbours[4] = {-1, -1, -1, -1};
+
+		if(row > top){
+			neighbours[0] = current - N;
+		}
+		if(row < bottom){
+			neighbours[1] = current + N;
+		}
+		if(column > left){
+			neighbours[2] = current - 1;
+		}
+		if(column < right){
+			neighbours[3] = current + 1;
+		}
+
+		for(int i = 0; i < 4; i++){
+			int next = neighbours[i];
+			if(next == -1 || locked[next] || bfs_seen[next] == bfs_generation){
+				continue;
+			}
+
+			bfs_seen[next] = bfs_generation;
+			bfs_parent[next] = current;
+			bfs_queue[tail++] = next;
+		}
+	}
+
+	if(bfs_seen[target] != bfs_generation){
+		return 0;
+	}
+
+	//Walk the parents back from the target to get the route in reverse, then make the moves in order
+	int length = 0;
+	for(int current = target; current != start; current = bfs_parent[current]){
+		bfs_queue[length++] = current;
+	}
+	for(int i = length - 1; i >= 0; i--){
+		make_move(move_between(position[0], bfs_queue[i]));
+	}
+
+	return 1;
+}
+
+
+/**
+ * Route the blank to the target cell without passing through any locked cell. The blank heads straight for the target
+ * while it can, and the last stretch is found by breadth first search in a small box around the blank and the target,
+ * falling back to the whole board if the box has no route. Returns 0 if the target can't be reached at all
+ */
+static int route_blank(int target){
+	int target_row = target / N, target_column = target % N;
+
+	//Head straight for the target while we are far away and nothing is in the way
+	while(1){
+		int row = board->zero_row, column = board->zero_column;
+		int distance = abs(row - target_row) + abs(column - target_column);
+
+		if(distance <= 2){
+			break;
+		}
+
+		if(row < target_row && !locked[position[0] + N]){
+			make_move('D');
+		} else if(row > target_row && !locked[position[0] - N]){
+			make_move('U');
+		} else if(column < target_column && !locked[position[0] + 1]){
+			make_move('R');
+		} else if(column > target_column && !locked[position[0] - 1]){
+			make_move('L');
+		} else {
+			break;
+		}
+	}
+
+	//The box around the blank and the target, with a margin of 1 to get around whatever blocked us
+	int top = board->zero_row < target_row ? board->zero_row : target_row;
+	int bottom = board->zero_row > target_row ? board->zero_row : target_row;
+	int left = board->zero_column < target_column ? board->zero_column : target_column;
+	int right = board->zero_column > target_column ? board->zero_column : target_column;
+	top = top > 0 ? top - 1 : 0;
+	left = left > 0 ? left - 1 : 0;
+	bottom = bottom < N - 1 ? bottom + 1 : N - 1;
+	right = right < N - 1 ? right + 1 : N - 1;
+
+	if(route_blank_in_box(target, top, bottom, left, right)){
+		return 1;
+	}
+
+	return route_blank_in_box(target, 0, N - 1, 0, N - 1);
+}
+
+
+/**
+ * Move a tile to the target row and column. The tile first moves down if it is above the target row, then across to
+ * the target column, then up to the target row. Every step brings the blank in front of the tile without disturbing it,
+ * then moves the blank into the tile
+ */
+static void move_tile(int tile, int target_row, int target_column){
+	while(position[tile] != cell(target_row, target_column)){
+		int row = cell_row(position[tile]), column = cell_column(position[tile]);
+
+		//Pick the next cell for the tile
+		if(row < target_row){
+			row++;
+		} else if(column < target_column){
+			column++;
+		} else if(column > target_column){
+			column--;
+		} else {
+			row--;
+		}
+
+		//Bring the blank in front of the tile, then swap them
+		int tile_cell = position[tile];
+		locked[tile_cell] = 1;
+		if(!route_blank(cell(row, column))){
+			printf("\nERROR. The blank could not reach tile %d, this is a bug.\n", tile);
+			exit(1);
+		}
+		locked[tile_cell] = 0;
+		make_move(move_between(position[0], tile_cell));
+	}
+}
+
+
+/**
+ * Solve one line, from the given column to the end. The line is a row, or a column when transposed
+ */
+static void solve_line(int line, int start){
+	//Every tile but the last two goes straight to its goal, and is then locked
+	for(int column = start; column < N - 2; column++){
+		int goal_cell = cell(line, column);
+		move_tile(goal_cell + 1, line, column);
+		locked[goal_cell] = 1;
+	}
+
+	//The last two tiles, first and second
+	int first_cell = cell(line, N - 2), second_cell = cell(line, N - 1);
+	int first = first_cell + 1, second = second_cell + 1;
+
+	//If they are already in place we are done
+	if(position[first] == first_cell && position[second] == second_cell){
+		locked[first_cell] = locked[second_cell] = 1;
+		return;
+	}
+
+	//Put the first tile in the corner and lock it, then put the second tile just past it, and lock that too
+	move_tile(first, line, N - 1);
+
+	//The first tile may have left the blank where it goes, the only way out of which is down
+	if(position[0] == first_cell){
+		make_move(transposed ? 'R' : 'D');
+	}
+
+	//If the second tile is stuck between the first and the solved tiles, taking it out would trap the blank there.
+	//Take it two lines out of the way while the corner is still free, and hold it there while the first goes back
+	if(position[second] == first_cell){
+		int out_of_the_way = cell(line + 2, N - 2);
+		move_tile(second, line + 2, N - 2);
+		locked[out_of_the_way] = 1;
+		move_tile(first, line, N - 1);
+		locked[out_of_the_way] = 0;
+	}
+
+	locked[second_cell] = 1;
+	move_tile(second, line + 1, N - 1);
+	int below_cell = cell(line + 1, N - 1);
+	locked[below_cell] = 1;
+
+	//Bring the blank to where the first tile goes, then rotate both tiles into place
+	if(!route_blank(first_cell)){
+		printf("\nERROR. The blank could not reach the end of line %d, this is a bug.\n", line);
+		exit(1);
+	}
+	locked[below_cell] = 0;
+	make_move(transposed ? 'D' : 'R');
+	make_move(transposed ? 'R' : 'D');
+	locked[first_cell] = 1;
+}
+
+
+/**
+ * The rank of an arrangement of the final block among all arrangements of its cells. Every cell holds a 4 bit label
+ */
+static int rank_block(unsigned long long block, int cells){
+	int rank = 0;
+
+	for(int i = 0; i < cells; i++){
+		int label = (block >> (4 * i)) & 0xF, smaller = 0;
+
+		//Count the labels after this one that are smaller
+		for(int j = i + 1; j < cells; j++){
+			if((int)((block >> (4 * j)) & 0xF) < label){
+				smaller++;
+			}
+		}
+
+		rank = rank * (cells - i) + smaller;
+	}
+
+	return rank;
+}
+
+
+/**
+ * The index of the blank(label 0) in an arrangement of the final block
+ */
+static int block_blank(unsigned long long block){
+	int index = 0;
+
+	while((block >> (4 * index)) & 0xF){
+		index++;
+	}
+
+	return index;
+}
+
+
+/**
+ * Swap the blank in an arrangement of the final block with the label at another index
+ */
+static unsigned long long block_swap(unsigned long long block, int blank, int other){
+	unsigned long long label = (block >> (4 * other)) & 0xF;
+	block &= ~(0xFULL << (4 * other));
+	return block | (label << (4 * blank));
+}
+
+
+/**
+ * Solve the size x size block in the bottom right corner optimally, with breadth first search from its current
+ * arrangement. Returns 0 if the block can't be solved, which only happens if the puzzle was unsolvable
+ */
+static int solve_final_block(int size){
+	int corner = N - size, cells = size * size;
+	unsigned long long start = 0, goal = 0;
+
+	//Label the tiles by where they go within the block, so the block's goal is 1, 2, ..., 0
+	for(int i = 0; i < cells; i++){
+		int tile = board->tiles[(corner + i / size) * N + corner + i % size];
+		int label = 0;
+
+		if(tile != 0){
+			label = ((tile - 1) / N - corner) * size + (tile - 1) % N - corner + 1;
+		}
+
+		start |= (unsigned long long)label << (4 * i);
+		goal |= (unsigned long long)((i + 1) % cells) << (4 * i);
+	}
+
+	//For every arrangement we reach, the move(as an index offset) that first got us there, or 0 if not reached
+	char* reached_by = (char*)calloc(FINAL_BLOCK_PERMUTATIONS, 1);
+	unsigned long long* queue = (unsigned long long*)malloc(sizeof(unsigned long long) * FINAL_BLOCK_PERMUTATIONS / 2);
+	int head = 0, tail = 0;
+	//0 is taken to mean unreached, so the start is marked with a move that is never made
+	reached_by[rank_block(start, cells)] = 'S';
+	queue[tail++] = start;
+	int found = start == goal;
+
+	while(head < tail && !found){
+		unsigned long long current = queue[head++];
+		int blank = block_blank(current);
+		int row = blank / size, column = blank % size;
+
+		for(int move = 0; move < 4; move++){
+			int other;
+			char name;
+
+			if(move == 0 && column > 0){
+				other = blank - 1, name = 'L';
+			} else if(move == 1 && column < size - 1){
+				other = blank + 1, name = 'R';
+			} else if(move == 2 && row > 0){
+				other = blank - size, name = 'U';
+			} else if(move == 3 && row < size - 1){
+				other = blank + size, name = 'D';
+			} else {
+				continue;
+			}
+
+			unsigned long long next = block_swap(current, blank, other);
+			int rank = rank_block(next, cells);
+			if(reached_by[rank]){
+				continue;
+			}
+
+			reached_by[rank] = name;
+			queue[tail++] = next;
+			if(next == goal){
+				found = 1;
+				break;
+			}
+		}
+	}
+
+	if(!found){
+		free(reached_by);
+		free(queue);
+		return 0;
+	}
+
+	//Walk back from the goal by undoing each move, which gives the moves in reverse
+	int length = 0;
+	char path[64];
+	for(unsigned long long current = goal; current != start; ){
+		char name = reached_by[rank_block(current, cells)];
+		int blank = block_blank(current);
+		int back = name == 'L' ? blank + 1 : name == 'R' ? blank - 1 : name == 'U' ? blank + size : blank - size;
+
+		path[length++] = name;
+		current = block_swap(current, blank, back);
+	}
+
+	for(int i = length - 1; i >= 0; i--){
+		make_move(path[i]);
+	}
+
+	free(reached_by);
+	free(queue);
+	return 1;
+}
+
+
+/**
+ * A 64 bit mix of a tile sitting on a cell, XORed over the board to fingerprint it
+ */
+static unsigned long long tile_fingerprint(int index, int tile){
+	unsigned long long x = ((unsigned long long)index << 16 | tile) + 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+
+/**
+ * Cancel every move that is immediately undone. The kept moves are a stack, so when a pair cancels, the moves on either
+ * side of it meet, and cancel too if they undo each other. Returns how many moves were removed
+ */
+static long cancel_reversals(){
+	long kept = 0;
+
+	for(long i = 0; i < move_count; i++){
+		if(kept > 0 && moves[kept - 1] == inverse_move(moves[i])){
+			kept--;
+		} else {
+			moves[kept++] = moves[i];
+		}
+	}
+
+	long removed = move_count - kept;
+	move_count = kept;
+	return removed;
+}
+
+
+/**
+ * The window optimizer. Replay the moves from the start, and whenever the board comes back to how it was at most
+ * OPTIMIZER_WINDOW moves ago, drop every move in between. Boards are told apart by their fingerprints
+ */
+static void optimize_moves(struct state* start_state){
+	copy_state(start_state, board, N);
+	//The fingerprint of the board after each kept move, relative to the start
+	unsigned long long* fingerprints = (unsigned long long*)malloc(sizeof(unsigned long long) * (move_count + 1));
+	int* recent = (int*)malloc(sizeof(int) * OPTIMIZER_TABLE_SIZE);
+	memset(recent, -1, sizeof(int) * OPTIMIZER_TABLE_SIZE);
+	long kept = 0;
+
+	fingerprints[0] = 0;
+	recent[0] = 0;
+
+	for(long i = 0; i < move_count; i++){
+		int old_blank = board->zero_row * N + board->zero_column;
+		char move = moves[i];
+
+		if(move == 'L'){
+			move_left(board, N);
+		} else if(move == 'R'){
+			move_right(board, N);
+		} else if(move == 'U'){
+			move_up(board, N);
+		} else {
+			move_down(board, N);
+		}
+
+		//The tile moved from where the blank is now to where the blank was
+		int new_blank = board->zero_row * N + board->zero_column;
+		int tile = board->tiles[old_blank];
+		unsigned long long fingerprint = fingerprints[kept] ^ tile_fingerprint(old_blank, tile) ^ tile_fingerprint(new_blank, tile)
+										 ^ tile_fingerprint(old_blank, 0) ^ tile_fingerprint(new_blank, 0);
+
+		moves[kept++] = move;
+		fingerprints[kept] = fingerprint;
+
+		//If we have seen this board recently, everything since then did nothing
+		int slot = fingerprint & (OPTIMIZER_TABLE_SIZE - 1);
+		int seen = recent[slot];
+		if(seen >= 0 && seen < kept && fingerprints[seen] == fingerprint && kept - seen <= OPTIMIZER_WINDOW){
+			kept = seen;
+		} else {
+			recent[slot] = kept;
+		}
+	}
+
+	move_count = kept;
+	free(fingerprints);
+	free(recent);
+}
+
+
+/**
+ * Replay the moves from the start and check that they solve the puzzle
+ */
+static int verify_moves(struct state* start_state, struct state* goal_state){
+	copy_state(start_state, board, N);
+
+	for(long i = 0; i < move_count; i++){
+		char move = moves[i];
+
+		//Every move must stay on the board
+		if((move == 'L' && board->zero_column == 0) || (move == 'R' && board->zero_column == N - 1)
+		   || (move == 'U' && board->zero_row == 0) || (move == 'D' && board->zero_row == N - 1)){
+			return 0;
+		}
+
+		if(move == 'L'){
+			move_left(board, N);
+		} else if(move == 'R'){
+			move_right(board, N);
+		} else if(move == 'U'){
+			move_up(board, N);
+		} else {
+			move_down(board, N);
+		}
+	}
+
+	return states_same(board, goal_state, N);
+}
+
+
+/**
+ * Swap the labels of tiles 1 and 2, which flips which goals a state can reach without changing how it moves
+ */
+static void swap_labels(struct state* statePtr){
+	for(int i = 0; i < N * N; i++){
+		if(statePtr->tiles[i] == 1 || statePtr->tiles[i] == 2){
+			statePtr->tiles[i] = 3 - statePtr->tiles[i];
+		}
+	}
+}
+
+
+/**
+ * Make the moves that take a solvable state to the standard goal, after whatever moves were already made, by reducing it
+ * one line at a time and then solving the final block. Returns 0 if the final block can't be solved, which is a bug
+ */
+static int solve_to_standard(struct state* statePtr){
+	//Work on a copy, so that the state is still there for the optimizer and for verification
+	copy_state(statePtr, board, N);
+	memset(locked, 0, N * N);
+	for(int i = 0; i < N * N; i++){
+		position[board->tiles[i]] = i;
+	}
+
+	//Solve the longer of the top row and the left column until only the final block is left
+	int top = 0, left = 0;
+	int final_size = N < FINAL_BLOCK_SIZE ? N : FINAL_BLOCK_SIZE;
+	while(N - top > final_size || N - left > final_size){
+		if(N - top >= N - left){
+			transposed = 0;
+			solve_line(top, left);
+			top++;
+		} else {
+			transposed = 1;
+			solve_line(left, top);
+			left++;
+		}
+	}
+	transposed = 0;
+
+	return solve_final_block(final_size);
+}
+
+
+/**
+ * Solve the puzzle. The standard goal is solved for directly. Any other goal is met at the standard one, by solving the
+ * start and then the goal to it, and playing the goal's moves backwards
+ */
+int solve(struct state* start_state, struct state* goal_state, int optimize, int verify, int quiet){
+	//Get the CPU clock start time
+	clock_t begin_CPU = clock();
+
+	board = (struct state*)malloc(sizeof(struct state));
+	initialize_state(board, N);
+
+	//Copies of both ends to solve from, since their labels may have to change
+	struct state from, to;
+	initialize_state(&from, N);
+	initialize_state(&to, N);
+	copy_state(start_state, &from, N);
+	copy_state(goal_state, &to, N);
+
+	int meet = 0;
+	for(int i = 0; i < N * N; i++){
+		meet |= goal_state->tiles[i] != (i + 1) % (N * N);
+	}
+
+	//If neither end reaches the standard goal, swapping two labels in both makes them
+	if(!solvable(&from, &to, N)){
+		printf("This configuration can't be solved.\n");
+		return 1;
+	}
+	if(meet && !reaches_standard_goal(&from, N)){
+		swap_labels(&from);
+		swap_labels(&to);
+	}
+
+	position = (int*)malloc(sizeof(int) * N * N);
+	locked = (char*)malloc(N * N);
+	moves = (char*)malloc(move_capacity);
+	bfs_queue = (int*)malloc(sizeof(int) * N * N);
+	bfs_parent = (int*)malloc(sizeof(int) * N * N);
+	bfs_seen = (int*)calloc(N * N, sizeof(int));
+
+	//Only stream if nothing is going to change the moves after they are made
+	streaming = !optimize && !quiet && !meet;
+	if(streaming){
+		printf("Solution moves(of the blank):\n");
+	}
+
+	if(!solve_to_standard(&from)){
+		printf("\nERROR. The final block could not be solved, this is a bug.\n");
+		return 1;
+	}
+
+	//The goal's way to the standard goal, backwards, is the way from the standard goal to the goal
+	if(meet){
+		long first_leg = move_count;
+		if(!solve_to_standard(&to)){
+			printf("\nERROR. The final block could not be solved, this is a bug.\n");
+			return 1;
+		}
+
+		for(long i = first_leg, j = move_count - 1; i <= j; i++, j--){
+			char move = inverse_move(moves[i]);
+			moves[i] = inverse_move(moves[j]);
+			moves[j] = move;
+		}
+	}
+	long unoptimized_count = move_count, reversals = 0;
+
+	if(optimize){
+		reversals = cancel_reversals();
+		optimize_moves(start_state);
+	}
+
+	//Stop the clock
+	clock_t end_CPU = clock();
+	double time_spent_CPU = (double)(end_CPU - begin_CPU) / CLOCKS_PER_SEC;
+
+	//Print the moves now if we couldn't stream them
+	if(!streaming && !quiet){
+		printf("Solution moves(of the blank):\n");
+		for(long i = 0; i < move_count; i++){
+			print_move(moves[i]);
+		}
+	}
+	if(!quiet && printed_moves % MOVES_PER_LINE != 0){
+		printf("\n");
+	}
+
+	//Print out all running statistics
+	printf("\n------------- Program Running Statistics -------------\n\n");
+	//Print out the number of moves
+	printf("Solution path length: %ld\n", move_count + 1);
+	if(optimize){
+		printf("Moves before the optimizer: %ld, after: %ld(%ld undone right away, %ld in longer loops)\n", unoptimized_count,
+			   move_count, reversals, unoptimized_count - reversals - move_count);
+	}
+	if(verify){
+		printf("Verified: %s\n", verify_moves(start_state, goal_state) ? "the moves solve the puzzle" : "FAILED");
+	}
+	//Print out CPU time(NOT wall time) spent
+	printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);
+	printf("------------------------------------------------------\n\n");
+
+	return 0;
+}
+
+
+/**
+ * The main function reads the configuration and the options, then hands off to solve()
+ */
+int main(int argc, char** argv){
+	int optimize = 0, verify = 0, quiet = 0;
+	char* goal_configuration = NULL;
+
+	//Check for the optional flags before anything else
+	while(argc > 1 && strncmp(argv[1], "--", 2) == 0){
+		if(strcmp(argv[1], "--optimize") == 0){
+			optimize = 1;
+		} else if(strcmp(argv[1], "--verify") == 0){
+			verify = 1;
+		} else if(strcmp(argv[1], "--quiet") == 0){
+			quiet = 1;
+		} else if(strcmp(argv[1], "--goal") == 0 && argc > 2){
+			goal_configuration = argv[2];
+			argc--;
+			argv++;
+		} else {
+			printf("Unknown option %s.\n", argv[1]);
+			argc = 0;
+			break;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	//If the user put in a non-integer or a size we can't hold, print an error
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1 || N > MAX_N || (argc != 2 && argc != N*N + 2)){
+		printf("Incorrect program arguments.\n");
+		printf("Usage: ./solve_macro [--optimize] [--verify] [--quiet] [--goal <t0,t1,...>] <N> [<n0. . .nN>]\n");
+		printf("Where <N> is the number of rows/columns, at most %d, followed by the matrix in row-major order.\n", MAX_N);
+		printf("If the matrix is left out it is read from stdin.\n");
+		printf("  --optimize  Cancel moves that undo each other before printing them\n");
+		printf("  --verify    Replay the moves and check that they solve the puzzle\n");
+		printf("  --quiet     Only print the statistics, not the moves\n");
+		printf("  --goal      Solve for this goal, in row-major order split by commas, instead of 1, 2, ..., 0\n\n");
+		return 1;
+	}
+
+	//The start state, straight from the arguments or from stdin
+	struct state* start_state = (struct state*)malloc(sizeof(struct state));
+	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
+	initialize_state(start_state, N);
+	initialize_state(goal_state, N);
+
+	//Check that every tile shows up exactly once
+	char* present = (char*)calloc(N * N, 1);
+	for(int i = 0; i < N * N; i++){
+		int tile;
+
+		if((argc == 2 && scanf("%d", &tile) != 1) || (argc != 2 && sscanf(argv[i + 2], "%d", &tile) != 1)
+		   || tile < 0 || tile >= N * N || present[tile]){
+			printf("The configuration must hold every number from 0 to %d exactly once.\n", N * N - 1);
+			return 1;
+		}
+
+		present[tile] = 1;
+		start_state->tiles[i] = tile;
+		if(tile == 0){
+			start_state->zero_row = i / N;
+			start_state->zero_column = i % N;
+		}
+
+		//The goal is 1, 2, ..., 0
+		goal_state->tiles[i] = (i + 1) % (N * N);
+	}
+	free(present);
+	goal_state->zero_row = goal_state->zero_column = N - 1;
+	start_state->zobrist_key = compute_zobrist_key(start_state->tiles, N);
+
+	//The user's own goal is relabeled onto the standard one along with the start, unless its blank isn't in a corner, in
+	//which case solve() meets it at the standard goal as it is
+	if(goal_configuration != NULL){
+		short user_goal[N * N];
+		int relabeled = relabel_goal(goal_configuration, user_goal, N);
+
+		if(relabeled == -1){
+			return 1;
+		} else if(relabeled == 0){
+			relabel_state(start_state, N);
+		} else {
+			for(int i = 0; i < N * N; i++){
+				goal_state->tiles[i] = user_goal[i];
+				if(user_goal[i] == 0){
+					goal_state->zero_row = i / N;
+					goal_state->zero_column = i % N;
+				}
+			}
+		}
+	}
+	goal_state->zobrist_key = compute_zobrist_key(goal_state->tiles, N);
+
+	//Hand off the rest of the program execution to solve()
+	return solve(start_state, goal_state, optimize, verify, quiet);
+}
@@ -12,7 +12,19 @@
 #include <time.h>
 //For multi-threading functionality
 #include <pthread.h>
-#include "puzzle.h"
+#include "npuzzle.h"
+
+
+//The heuristic cache that sits in front of the heuristic, NULL if turned off
+struct heuristic_cache* cache = NULL;
+//Every state that has ever been generated, which is everything in fringe and closed. Shared by every worker thread
+struct concurrent_set* seen = NULL;
+//The deadline and node limit, and whether the search was cancelled
+struct search_control control;
+//The expanded state closest to the goal by its heuristic, the end of the best partial path if the search is stopped
+struct state* closest_state = NULL;
+//What the search has done so far, for the progress reporter
+struct search_progress progress;
 
 
 /**
@@ -95,14 +107,22 @@ void* generator_worker(void* thread_params){
 
 	//Only perform the checks if moved is not null
 	if(moved != NULL){
-		//Now we must check for repeating
-		//Important -- we need to modify the state in successors, not the local copy "moved"
-		check_repeating_closed(&(parameters->successors[option]), N);
-		check_repeating_fringe(&(parameters->successors[option]), N);
-		//Update prediction function
-		update_prediction_function(parameters->successors[option], N);
+		//Now we must check for repeating. The set tells us atomically whether we were first, so the other workers can
+		//insert at the same time
+		if(!concurrent_set_insert(seen, moved)){
+			//Important -- we need to modify the state in successors, not the local copy "moved"
+			destroy_state(moved);
+			free(moved);
+			parameters->successors[option] = NULL;
+		} else {
+			//Update prediction function
+			update_heuristic(moved, N, cache);
+		}
 	}
 
+	//The thread is about to finish, so its cache counts have to be added in now
+	flush_heuristic_cache_counts();
+
 	//Threadwork done, no return value will be used
 	return NULL;
 }
@@ -144,6 +164,33 @@ void generate_successors(struct state* predecessor, struct state** successors, i
 }
 
 
+/**
+ * Report on a search that was stopped before it found the goal: the best partial path, and a proven lower bound. With a
+ * consistent heuristic, the head of the fringe has the lowest cost of any path not yet looked at. A weighted search can
+ * close states early, so all that it proves is the start state's heuristic, and an overlapping one proves nothing
+ */
+static void print_stopped_search(struct state* start_state, int num_expansions, int num_unique_configs, clock_t begin_CPU, const int N){
+	//Plus one since path lengths count the start state. A heuristic that overestimates proves nothing at all
+	int lower_bound = heuristic_is_admissible() ? start_state->heuristic_cost + 1 : -1;
+	if(!fringe_empty() && heuristic_proves_optimality() && fringe_head()->total_cost + 1 > lower_bound){
+		lower_bound = fringe_head()->total_cost + 1;
+	}
+
+	int pathlen = print_partial_path(closest_state, N);
+
+	printf("------------- Program Running Statistics -------------\n\n");
+	print_search_stopped(&control, lower_bound, num_expansions);
+	if(closest_state != NULL){
+		printf("Best partial path length: %d, ending %d moves or more from the goal\n", pathlen, closest_state->heuristic_cost);
+	}
+	printf("Unique configurations generated by solver: %d\n", num_unique_configs);
+	printf("Memory consumed: %.2f MB\n", (sizeof(struct state) + N*N*sizeof(short)) * num_unique_configs / 1048576.0);
+	printf("Heuristic: %s\n", heuristic_name());
+	printf("Total CPU time spent: %.7f seconds\n\n", (double)(clock() - begin_CPU) / CLOCKS_PER_SEC);
+	printf("------------------------------------------------------\n\n");
+}
+
+
 /**
  * Use an A* search algorithm to solve the 15-puzzle problem by implementing the A* main loop. If the solve function 
  * is successful, it will print the resulting solution path to the console as well.  
@@ -152,16 +199,20 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 	//We will keep track of the time taken to execute
 	clock_t begin_CPU = clock();
 
-	//We will keep track of the number of iterations as a sanity check for large problems
+	//We will keep track of the number of iterations, which is the number of states expanded
 	int iteration = 0;
 	//We will also keep track of the number of unique configurations
 	int num_unique_configs = 0;
 	//Define an array for holding successor states. We can generate at most 4 each time
 	struct state* successors[4];
 
-	//Initialize the closed and fringe lists
-	initialize_closed();
+	//Initialize the fringe, and the set that takes the place of searching closed and fringe for repeats
 	initialize_fringe();
+	seen = create_concurrent_set(DEFAULT_SET_BITS, N);
+	concurrent_set_insert(seen, start_state);
+
+	//Incremental heuristics build on the predecessor's evaluation, so the start state must be evaluated first
+	update_heuristic(start_state, N, cache);
 
 	//Put the start_state into fringe to begin the search
 	priority_queue_insert(start_state);
@@ -171,6 +222,12 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 
 	//Algorithm main loop -- while there are still states to be expanded, keep iterating until we find a solution
 	while (!fringe_empty()){
+		//Give up with what we have once the deadline or node limit runs out, or if someone cancels the search
+		if(search_stopped(&control) != SEARCH_RUNNING){
+			print_stopped_search(start_state, iteration, num_unique_configs, begin_CPU, N);
+			return SEARCH_STOPPED_EXIT;
+		}
+
 		//Remove or "pop" the head of the fringe linked list -- because fringe is a priority queue, this is the most
 		//promising state to explore next
 		curr_state = dequeue();
@@ -211,12 +268,20 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 
 			//Print out all running statistics
 			printf("------------- Program Running Statistics -------------\n\n");
-			//Print out the path length
-			printf("Optimal solution path length: %d\n", pathlen);
+			//Print out the path length. Weighted and overlapping heuristics can't promise that it's optimal
+			print_solution_path_length(pathlen);
 			//Print out the number of unique configurations generated
 			printf("Unique configurations generated by solver: %d\n", num_unique_configs);
 			//Print out total memory consumption in Megabytes
 			printf("Memory consumed: %.2f MB\n", (sizeof(struct state) + N*N*sizeof(short)) * num_unique_configs / 1048576.0);
+			//Print out which heuristic was used
+			printf("Heuristic: %s\n", heuristic_name());
+			//Print out how well the heuristic cache did
+			if(cache != NULL){
+				print_heuristic_cache_stats(cache);
+			}
+			//Print out whether the tables got the huge pages and NUMA placement that were asked for
+			print_table_memory_stats();
 			//Print out CPU time(NOT wall time) spent
 			printf("Total CPU time spent: %.7f seconds\n\n", time_spent_CPU);	
 			printf("------------------------------------------------------\n\n");
@@ -238,17 +303,13 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 		//Add all necessary states to fringe now that we have checked for repeats and updated predictions 
 		//Additionally, we need to update the num_unique_configs, this will be done in merge_to_fringe
 		num_unique_configs += merge_to_fringe(successors); 
-	
-		//Add to closed
-		merge_to_closed(curr_state);	
+		closest_state = closer_to_goal(closest_state, curr_state);
+		search_should_stop(&control, 1);
 
-		//For very complex problems, print the iteration count to the console for a sanity check
-		if(iteration > 1 && iteration % 1000 == 0) {
-			printf("Iteration: %6d, %6d total unique states generated\n", iteration, num_unique_configs);
-		}
-		
-		//End of one full iteration
+		//End of one full iteration. For very complex problems, let the progress reporter know how far along we are.
+		//Every state ever generated is either open or expanded, there is no closed list
 		iteration++;
+		publish_progress(&progress, iteration, num_unique_configs, curr_state->total_cost, fringe_size(), iteration);
 	}
 	
 	//If we end up here, fringe became NULL with no goal configuration found, so there is no solution
@@ -264,12 +325,27 @@ int solve(int N, struct state* start_state, struct state* goal_state){
 int main(int argc, char** argv){
 	//The size of our N puzzle
 	int N;
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
 
 	//If the user put in a non-integer or a nonpositive integer, print an error
-	if(sscanf(argv[1], "%d", &N) != 1 || N < 1){
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1){
 		printf("Incorrect type of program arguments.\n");
-		printf("Usage: ./solve_multi_threaded <N> <n0. . .nN>\n");
+		printf("Usage: ./solve_multi_threaded [options] <N> <n0. . .nN>\n");
 		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
 		return 1;
 	}
 
@@ -277,8 +353,9 @@ int main(int argc, char** argv){
 	if(argc != N*N + 2){
 		//Give an error message
 		printf("Incorrect number of program arguments.\n");
-		printf("Usage: ./solve_multi_threaded <N> <n0. . .nN>\n");
+		printf("Usage: ./solve_multi_threaded [options] <N> <n0. . .nN>\n");
 		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
 		return 1;
 	}
 
@@ -290,8 +367,27 @@ int main(int argc, char** argv){
 	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
 
 	//Initialize the goal and start states 
-	initialize_start_goal(argv, start_state, goal_state, N);
+	if(initialize_start_goal(argv, start_state, goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//Load or build everything the heuristic needs once, up front
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+
+	//Create the heuristic cache, unless the user turned it off
+	cache = create_heuristic_cache_for(&options);
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Progress is reported from its own thread, so the search never waits on the output
+	struct progress_reporter* reporter = start_progress_reporter(&progress, &options);
 
 	//Call the solve() funciton and hand off the rest of the program execution to it
-	return solve(N, start_state, goal_state);
+	int result = solve(N, start_state, goal_state);
+	stop_progress_reporter(reporter);
+	return result;
 }
@@ -0,0 +1,721 @@
+/**
+ * Author: Jack Robbins
+ * This program implements a parallel iterative deepening A* search(IDA*) for the N-puzzle problem. It takes in an N-puzzle
+ * problem starting configuration in row-major order as a command line argument, following a number N for the NxN size of
+ * the puzzle, and prints out the full solution path to the problem, step by step, if such a solution exists.
+ *
+ * IDA* keeps no fringe or closed at all. It does a depth first search that cuts off every state whose total cost is over
+ * a bound, and if that finds nothing, the bound is raised to the smallest total cost that was cut off and the search starts
+ * over. Memory use is only the current path, so IDA* can solve problems that A* runs out of memory on.
+ *
+ * One depth first search only uses one core, so the tree is split. The first few levels are expanded breadth first into a
+ * pool of subtree roots, and every worker thread gets an even share of them in its own Chase-Lev work stealing deque. A
+ * worker searches the roots at the bottom of its own deque, and once it runs out, steals roots from the top of the other
+ * workers' deques, so no core sits idle while another still has subtrees left. Every iteration ends at a barrier before
+ * the bound is raised, so every path shorter than the bound has been searched before any longer one, and the first
+ * solution found is optimal.
+ *
+ * Note: This is the parallel IDA* version of the solver
+ */
+
+//For timing
+#include <time.h>
+//For multi-threading functionality
+#include <pthread.h>
+#include <stdatomic.h>
+//For the number of cores
+#include <unistd.h>
+#include "npuzzle.h"
+
+
+//Keep expanding the top of the tree until there are this many subtree roots for each worker
+#define ROOTS_PER_WORKER 64
+//The deepest the top of the tree is expanded, and the deepest a worker may search below a root
+#define MAX_ROOT_DEPTH 32
+#define MAX_SEARCH_DEPTH 256
+//Returned by deque_take and deque_steal when there is nothing to give
+#define DEQUE_EMPTY -1
+//Returned by deque_steal when another thread got there first
+#define DEQUE_ABORT -2
+
+
+/**
+ * A Chase-Lev work stealing deque of subtree root indices. Only the owner pushes and takes at the bottom, any thread may
+ * steal from the top. The capacity never has to grow, since every root is pushed before the workers start
+ */
+struct work_deque {
+	//The next index to steal from, and one past the last index pushed
+	atomic_long top, bottom;
+	//The root indices, capacity is a power of 2
+	atomic_int* items;
+	long capacity;
+};
+
+
+/**
+ * One subtree root from the top of the tree
+ */
+struct subtree_root {
+	//The tiles of the root, their key and where its blank is
+	short* tiles;
+	unsigned long long zobrist_key;
+	short zero_row, zero_column;
+	//How deep the root is, and the moves that lead to it from the start
+	int depth;
+	char moves[MAX_ROOT_DEPTH];
+};
+
+
+/**
+ * Everything that a worker thread owns
+ */
+struct worker {
+	//The worker's index, which is also the index of its deque
+	int index;
+	//The states along the current path, so that no state is ever allocated during the search
+	struct state path[MAX_SEARCH_DEPTH + 1];
+	//The moves along the current path, below the root
+	char moves[MAX_SEARCH_DEPTH];
+	//The smallest total cost cut off by the bound in this iteration
+	int next_bound;
+	//Running statistics
+	long expanded, steals;
+	//Random state for picking steal victims
+	unsigned int seed;
+};
+
+
+/*================================= Global variables for convenience =========================== */
+//The heuristic cache that sits in front of the heuristic, NULL if turned off
+struct heuristic_cache* cache = NULL;
+//The size of the puzzle, and the goal that every worker compares against
+int N;
+struct state* goal_state;
+//The subtree roots, and every worker with its deque
+struct subtree_root* roots;
+int num_roots = 0;
+struct worker* workers;
+struct work_deque* deques;
+int num_workers;
+//The bound of the current iteration, and whether the workers should stop for good
+int bound;
+int finished = 0;
+//How many roots are not done yet in this iteration, and whether a solution has been found
+atomic_int remaining_roots;
+atomic_int solution_found;
+//The solution, written only by the worker that set solution_found
+int solution_root, solution_length;
+char solution_moves[MAX_SEARCH_DEPTH];
+//Every iteration starts and ends with all workers and the main thread at these barriers
+pthread_barrier_t start_barrier, end_barrier;
+//The deadline and node limit, shared by every worker, and whether the search was cancelled
+struct search_control control;
+/*============================================================================================== */
+
+
+/**
+ * Reset a deque to empty. Only safe while no worker is running
+ */
+static void deque_reset(struct work_deque* deque){
+	atomic_store_explicit(&deque->top, 0, memory_order_relaxed);
+	atomic_store_explicit(&deque->bottom, 0, memory_order_relaxed);
+}
+
+
+/**
+ * Push a root onto the bottom of a deque. Only the owner(or the main thread, while no worker is running) may push
+ */
+static void deque_push(struct work_deque* deque, int item){
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+
+	atomic_store_explicit(&deque->items[bottom & (deque->capacity - 1)], item, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+
+/**
+ * Take a root from the bottom of a deque. Only the owner may take. Returns DEQUE_EMPTY if there is none
+ */
+static int deque_take(struct work_deque* deque){
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+	//The deque was already empty
+	if(top > bottom){
+		atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+		return DEQUE_EMPTY;
+	}
+
+	int item = atomic_load_explicit(&deque->items[bottom & (deque->capacity - 1)], memory_order_relaxed);
+
+	//The last item, which a thief may be after too. Whoever moves top first gets it
+	if(top == bottom){
+		if(!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)){
+			item = DEQUE_EMPTY;
+		}
+		atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+	}
+
+	return item;
+}
+
+
+/**
+ * Steal a root from the top of a deque. Returns DEQUE_EMPTY if there is none, or DEQUE_ABORT if another thread took it
+ * first
+ */
+static int deque_steal(struct work_deque* deque){
+	long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+	if(top >= bottom){
+		return DEQUE_EMPTY;
+	}
+
+	int item = atomic_load_explicit(&deque->items[top & (deque->capacity - 1)], memory_order_relaxed);
+	if(!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)){
+		return DEQUE_ABORT;
+	}
+
+	return item;
+}
+
+
+/**
+ * Make a move on a state. 0 = left, 1 = right, 2 = down, 3 = up, the same convention as everywhere else
+ */
+static void make_move(struct state* statePtr, int move){
+	if(move == 0){
+		move_left(statePtr, N);
+	} else if(move == 1){
+		move_right(statePtr, N);
+	} else if(move == 2){
+		move_down(statePtr, N);
+	} else {
+		move_up(statePtr, N);
+	}
+}
+
+
+/**
+ * Whether a move is possible from a state
+ */
+static int move_possible(struct state* statePtr, int move){
+	return (move == 0 && statePtr->zero_column > 0) || (move == 1 && statePtr->zero_column < N - 1)
+		   || (move == 2 && statePtr->zero_row < N - 1) || (move == 3 && statePtr->zero_row > 0);
+}
+
+
+/**
+ * The depth first search below a root, with the state at the given depth of the worker's path already evaluated.
+ * Moves that undo the last move are never made. Returns 1 if this worker found the solution
+ */
+static int bounded_search(struct worker* worker, int depth, int last_move){
+	struct state* current = &worker->path[depth];
+
+	//Cut off anything over the bound, but remember the smallest such cost for the next iteration
+	if(current->total_cost > bound){
+		if(current->total_cost < worker->next_bound){
+			worker->next_bound = current->total_cost;
+		}
+		return 0;
+	}
+
+	//Only the goal has a heuristic of 0, so that is a cheap filter
+	if(current->heuristic_cost == 0 && states_same(current, goal_state, N)){
+		//Several workers may reach a goal in the same iteration, only the first one records its path
+		int expected = 0;
+		if(!atomic_compare_exchange_strong(&solution_found, &expected, 1)){
+			return 0;
+		}
+
+		solution_length = depth;
+		memcpy(solution_moves, worker->moves, depth);
+		return 1;
+	}
+
+	//Another worker already found the solution, so there is no point going on
+	if(atomic_load_explicit(&solution_found, memory_order_relaxed)){
+		return 0;
+	}
+
+	if(depth == MAX_SEARCH_DEPTH){
+		printf("ERROR. The search went deeper than %d moves below a subtree root.\n", MAX_SEARCH_DEPTH);
+		exit(1);
+	}
+
+	worker->expanded++;
+
+	//Give up once the deadline or node limit runs out, or if someone cancels the search
+	if(search_should_stop(&control, 1) != SEARCH_RUNNING){
+		return 0;
+	}
+
+	for(int move = 0; move < 4; move++){
+		//Skip impossible moves and the move that would undo the last one
+		if(!move_possible(current, move) || (last_move != -1 && move == (last_move ^ 1))){
+			continue;
+		}
+
+		struct state* successor = &worker->path[depth + 1];
+		copy_state(current, successor, N);
+		make_move(successor, move);
+		update_heuristic(successor, N, cache);
+		worker->moves[depth] = move;
+
+		if(bounded_search(worker, depth + 1, move)){
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * Search the subtree under one root for the current bound
+ */
+static void search_root(struct worker* worker, int root_index){
+	struct subtree_root* root = &roots[root_index];
+	struct state* start = &worker->path[0];
+
+	//Set up the root as the bottom of the path. It has no predecessor, so incremental heuristics start from scratch
+	memcpy(start->tiles, root->tiles, sizeof(short) * N * N);
+	start->zero_row = root->zero_row;
+	start->zero_column = root->zero_column;
+	start->zobrist_key = root->zobrist_key;
+	start->current_travel = root->depth;
+	start->predecessor = NULL;
+	update_heuristic(start, N, cache);
+
+	int last_move = root->depth > 0 ? root->moves[root->depth - 1] : -1;
+	if(bounded_search(worker, 0, last_move)){
+		//We won the race to set solution_found, so the moves below the root are already recorded
+		solution_root = root_index;
+	}
+}
+
+
+/**
+ * The worker thread function. Every iteration, take roots from our own deque until it's empty, then steal from the
+ * others until every root is done
+ */
+static void* worker_thread(void* argument){
+	struct worker* worker = (struct worker*)argument;
+
+	//With --numa on, stay on one node and use its copy of the heuristic's tables
+	place_worker_thread(worker->index);
+
+	while(1){
+		//Wait for the main thread to set up the iteration
+		pthread_barrier_wait(&start_barrier);
+		if(finished){
+			return NULL;
+		}
+
+		worker->next_bound = __INT_MAX__;
+
+		while(atomic_load_explicit(&remaining_roots, memory_order_acquire) > 0 && !atomic_load_explicit(&solution_found, memory_order_relaxed)
+			  && search_stopped(&control) == SEARCH_RUNNING){
+			int root = deque_take(&deques[worker->index]);
+
+			//Out of our own work, so try a random victim
+			if(root == DEQUE_EMPTY && num_workers > 1){
+				int victim = rand_r(&worker->seed) % (num_workers - 1);
+				if(victim >= worker->index){
+					victim++;
+				}
+
+				root = deque_steal(&deques[victim]);
+				if(root >= 0){
+					worker->steals++;
+				}
+			}
+
+			if(root < 0){
+				continue;
+			}
+
+			search_root(worker, root);
+			atomic_fetch_sub_explicit(&remaining_roots, 1, memory_order_release);
+		}
+
+		//Add in our heuristic cache counts, so that they are all there once the search is done
+		flush_heuristic_cache_counts();
+
+		//Wait for everyone to finish the iteration
+		pthread_barrier_wait(&end_barrier);
+	}
+}
+
+
+/**
+ * Add a root to the pool, growing it if needed
+ */
+static void add_root(struct state* statePtr, const char* moves, int depth, int* capacity){
+	if(num_roots == *capacity){
+		*capacity *= 2;
+		roots = (struct subtree_root*)realloc(roots, sizeof(struct subtree_root) * *capacity);
+	}
+
+	struct subtree_root* root = &roots[num_roots];
+	root->tiles = (short*)malloc(sizeof(short) * N * N);
+	memcpy(root->tiles, statePtr->tiles, sizeof(short) * N * N);
+	root->zero_row = statePtr->zero_row;
+	root->zero_column = statePtr->zero_column;
+	root->zobrist_key = statePtr->zobrist_key;
+	root->depth = depth;
+	memcpy(root->moves, moves, depth);
+	num_roots++;
+}
+
+
+/**
+ * Expand the top of the tree breadth first until there are at least target roots, never undoing the last move. Since
+ * every level is complete, a goal found here is at the shallowest possible depth, so it is the optimal solution and its
+ * index is returned. Otherwise -1 is returned and the last level is the root pool
+ */
+static int build_root_pool(struct state* start_state, int target){
+	int capacity = 64;
+	roots = (struct subtree_root*)malloc(sizeof(struct subtree_root) * capacity);
+	add_root(start_state, "", 0, &capacity);
+
+	struct state scratch;
+	initialize_state(&scratch, N);
+
+	for(int depth = 0; num_roots < target && depth < MAX_ROOT_DEPTH; depth++){
+		//Check this level for the goal before it's replaced
+		for(int i = 0; i < num_roots; i++){
+			if(memcmp(roots[i].tiles, goal_state->tiles, sizeof(short) * N * N) == 0){
+				destroy_state(&scratch);
+				return i;
+			}
+		}
+
+		//Replace the level with all of its children
+		struct subtree_root* level = roots;
+		int level_size = num_roots;
+		capacity = level_size * 4;
+		roots = (struct subtree_root*)malloc(sizeof(struct subtree_root) * capacity);
+		num_roots = 0;
+
+		for(int i = 0; i < level_size; i++){
+			int last_move = level[i].depth > 0 ? level[i].moves[level[i].depth - 1] : -1;
+
+			for(int move = 0; move < 4; move++){
+				memcpy(scratch.tiles, level[i].tiles, sizeof(short) * N * N);
+				scratch.zero_row = level[i].zero_row;
+				scratch.zero_column = level[i].zero_column;
+				scratch.zobrist_key = level[i].zobrist_key;
+
+				if(!move_possible(&scratch, move) || (last_move != -1 && move == (last_move ^ 1))){
+					continue;
+				}
+
+				make_move(&scratch, move);
+				level[i].moves[level[i].depth] = move;
+				add_root(&scratch, level[i].moves, level[i].depth + 1, &capacity);
+			}
+
+			free(level[i].tiles);
+		}
+
+		free(level);
+	}
+
+	destroy_state(&scratch);
+	return -1;
+}
+
+
+/**
+ * Print the solution by replaying the moves from the start state
+ */
+static void print_solution_path(struct state* start_state, const char* moves, int length){
+	struct state cursor;
+	initialize_state(&cursor, N);
+	copy_state(start_state, &cursor, N);
+
+	print_state(&cursor, N, 0);
+	for(int i = 0; i < length; i++){
+		make_move(&cursor, moves[i]);
+		print_state(&cursor, N, 0);
+	}
+
+	destroy_state(&cursor);
+}
+
+
+/**
+ * The solve function runs the iterations of parallel IDA*. The workers are started once and kept for every iteration,
+ * the main thread only deals out the roots and raises the bound
+ */
+int solve(int N_size, struct state* start_state, struct state* goal, int threads){
+	//Get the wall clock start time, CPU time would add up every worker's time
+	struct timespec begin, iteration_begin, now;
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+
+	N = N_size;
+	goal_state = goal;
+	num_workers = threads;
+
+	//The whole path is a root's moves followed by the moves below it
+	char path_moves[MAX_ROOT_DEPTH + MAX_SEARCH_DEPTH];
+	int path_length;
+	int iterations = 0;
+	long total_expanded = 0, total_steals = 0;
+
+	int found = build_root_pool(start_state, num_workers * ROOTS_PER_WORKER);
+	if(found != -1){
+		//The goal is within the top of the tree, so there is nothing left to search
+		path_length = roots[found].depth;
+		memcpy(path_moves, roots[found].moves, path_length);
+	} else {
+		//Every worker's deque must be able to hold every root, since they could all end up in one
+		long capacity = 1;
+		while(capacity < num_roots){
+			capacity *= 2;
+		}
+
+		workers = (struct worker*)calloc(num_workers, sizeof(struct worker));
+		deques = (struct work_deque*)calloc(num_workers, sizeof(struct work_deque));
+		pthread_t* thread_ids = (pthread_t*)malloc(sizeof(pthread_t) * num_workers);
+		pthread_barrier_init(&start_barrier, NULL, num_workers + 1);
+		pthread_barrier_init(&end_barrier, NULL, num_workers + 1);
+
+		for(int i = 0; i < num_workers; i++){
+			workers[i].index = i;
+			workers[i].seed = 0x9E3779B9u * (i + 1);
+			for(int depth = 0; depth <= MAX_SEARCH_DEPTH; depth++){
+				initialize_state(&workers[i].path[depth], N);
+			}
+
+			deques[i].items = (atomic_int*)malloc(sizeof(atomic_int) * capacity);
+			deques[i].capacity = capacity;
+			pthread_create(&thread_ids[i], NULL, worker_thread, &workers[i]);
+		}
+
+		//The first bound is the heuristic of the start state, which never overestimates
+		update_heuristic(start_state, N, cache);
+		bound = start_state->total_cost;
+
+		while(1){
+			clock_gettime(CLOCK_MONOTONIC, &iteration_begin);
+			long expanded_before = total_expanded;
+
+			//Deal out the roots round-robin, so that every worker starts with a share from every part of the tree
+			for(int i = 0; i < num_workers; i++){
+				deque_reset(&deques[i]);
+			}
+			for(int i = 0; i < num_roots; i++){
+				deque_push(&deques[i % num_workers], i);
+			}
+			atomic_store(&remaining_roots, num_roots);
+
+			//Let the workers go, and wait for them to finish the iteration
+			pthread_barrier_wait(&start_barrier);
+			pthread_barrier_wait(&end_barrier);
+			iterations++;
+
+			//The next bound is the smallest total cost that any worker cut off
+			int next_bound = __INT_MAX__;
+			total_expanded = 0;
+			total_steals = 0;
+			for(int i = 0; i < num_workers; i++){
+				if(workers[i].next_bound < next_bound){
+					next_bound = workers[i].next_bound;
+				}
+				total_expanded += workers[i].expanded;
+				total_steals += workers[i].steals;
+			}
+
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			double seconds = (now.tv_sec - iteration_begin.tv_sec) + (now.tv_nsec - iteration_begin.tv_nsec) / 1e9;
+			printf("Bound %3d: %12ld states expanded, %8.2f million states per second\n", bound, total_expanded - expanded_before,
+				   seconds > 0 ? (total_expanded - expanded_before) / seconds / 1e6 : 0.0);
+
+			//Every path within the bound has been searched, so this solution is optimal
+			if(atomic_load(&solution_found) || next_bound == __INT_MAX__ || search_stopped(&control) != SEARCH_RUNNING){
+				break;
+			}
+
+			bound = next_bound;
+		}
+
+		//Release the workers for good
+		finished = 1;
+		pthread_barrier_wait(&start_barrier);
+		for(int i = 0; i < num_workers; i++){
+			pthread_join(thread_ids[i], NULL);
+			for(int depth = 0; depth <= MAX_SEARCH_DEPTH; depth++){
+				destroy_state(&workers[i].path[depth]);
+			}
+			free(deques[i].items);
+		}
+		pthread_barrier_destroy(&start_barrier);
+		pthread_barrier_destroy(&end_barrier);
+		free(thread_ids);
+
+		//Every bound before this one was searched in full without finding the goal, so the solution is at least this
+		//long. A weighted search cuts off states that the optimal path may go through, so all that it proves is the
+		//start state's heuristic
+		if(!atomic_load(&solution_found) && search_stopped(&control) != SEARCH_RUNNING){
+			printf("\nSearch stopped before a solution was found. IDA* keeps no paths, so there is none to show\n");
+			printf("------------- Program Running Statistics -------------\n\n");
+			//Plus one since path lengths count the start state
+			print_search_stopped(&control, (heuristic_weight() == 1.0 ? bound : start_state->heuristic_cost) + 1, total_expanded);
+			printf("Worker threads: %d, %d subtree roots, %ld roots stolen\n", num_workers, num_roots, total_steals);
+			printf("Heuristic: %s\n", heuristic_name());
+			printf("------------------------------------------------------\n\n");
+			return SEARCH_STOPPED_EXIT;
+		}
+
+		//The search space ran out without finding the goal
+		if(!atomic_load(&solution_found)){
+			printf("No solution.\n");
+			return 0;
+		}
+
+		path_length = roots[solution_root].depth + solution_length;
+		memcpy(path_moves, roots[solution_root].moves, roots[solution_root].depth);
+		memcpy(path_moves + roots[solution_root].depth, solution_moves, solution_length);
+	}
+
+	//Stop the clock
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	double time_spent = (now.tv_sec - begin.tv_sec) + (now.tv_nsec - begin.tv_nsec) / 1e9;
+
+	//Print out the solution path first
+	printf("\nSolution found! Now displaying solution path\n");
+	//Display the path length for the user, counting the start state like the other solvers
+	printf("Path Length: %d\n\n", path_length + 1);
+	print_solution_path(start_state, path_moves, path_length);
+
+	//Print out all running statistics
+	printf("------------- Program Running Statistics -------------\n\n");
+	//Print out the path length
+	printf("Optimal solution path length: %d\n", path_length + 1);
+	//Print out how the work was split up
+	printf("Worker threads: %d, %d subtree roots, %ld roots stolen\n", num_workers, num_roots, total_steals);
+	printf("Iterations: %d, %ld states expanded\n", iterations, total_expanded);
+	//Print out which heuristic was used
+	printf("Heuristic: %s\n", heuristic_name());
+	//Print out how well the heuristic cache did
+	if(cache != NULL){
+		print_heuristic_cache_stats(cache);
+	}
+	//Print out whether the tables got the huge pages and NUMA placement that were asked for
+	print_table_memory_stats();
+	//Print out wall time, since CPU time would count every worker
+	printf("Total wall time spent: %.7f seconds\n\n", time_spent);
+	printf("------------------------------------------------------\n\n");
+
+	//Clean up the roots
+	for(int i = 0; i < num_roots; i++){
+		free(roots[i].tiles);
+	}
+	free(roots);
+	free(workers);
+	free(deques);
+
+	return 0;
+}
+
+
+/**
+ * The main function simply makes the needed calls to the initialize and solve function after checking command
+ * line arguments
+ */
+int main(int argc, char** argv){
+	//The size of our N puzzle
+	int N;
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
+
+	//If the user put in a non-integer or nonpositive integer, print an error
+	if(argc < 2 || sscanf(argv[1], "%d", &N) != 1 || N < 1){
+		printf("Incorrect type of program arguments.\n");
+		printf("Usage: ./solve_parallel_ida [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Check if the number of arguments is correct. If not, exit the program and print an error
+	if(argc != N*N + 2){
+		//Give an error message
+		printf("Incorrect number of program arguments.\n");
+		printf("Usage: ./solve_parallel_ida [options] <N> <n0. . .nN>\n");
+		printf("Where <N> is the number of rows/columns, followed by the matrix in row-major order.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Important: Move the address of argv up by 1 so that initialize_start_goal can only see the initial config
+	argv += 1;
+
+	//The starting and goal states, must create and reserve space
+	struct state* start_state = (struct state*)malloc(sizeof(struct state));
+	struct state* goal_state = (struct state*)malloc(sizeof(struct state));
+
+	//Initialize the goal and start states
+	if(initialize_start_goal(argv, start_state, goal_state, options.goal, N) != 0){
+		return 1;
+	}
+
+	//This solver always finds the optimal solution
+	if(options.weight != 1.0){
+		printf("ERROR. --weight is not supported by parallel IDA*, use solve or solve_anytime.\n\n");
+		return 1;
+	}
+
+	//This search only finds optimal solutions, which a heuristic that overestimates can't promise
+	if(!heuristic_specification_admissible(options.heuristic)){
+		printf("ERROR. Heuristic %s adds overlapping heuristics, which can overestimate, so it is not supported by parallel IDA*, use solve.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//IDA* would raise its bound forever looking for a goal that can't be reached, so check that first
+	if(!solvable(start_state, goal_state, N)){
+		printf("No solution.\n");
+		return 0;
+	}
+
+	//One worker per core unless told otherwise
+	int threads = options.threads;
+	if(threads == 0){
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cores < 1 ? 1 : (cores > MAX_THREADS ? MAX_THREADS : (int)cores);
+	}
+
+	//Load or build everything the heuristic needs once, up front
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+
+	//Every worker shares the same cache, its entries can be read and written without locks
+	cache = create_heuristic_cache_for(&options);
+
+	//The clock starts now, and Ctrl-C stops the search without losing what it found
+	start_search_control(&control, &options);
+	cancel_on_interrupt(&control);
+
+	//Call the solve() funciton and hand off the rest of the program execution to it
+	return solve(N, start_state, goal_state, threads);
+}
@@ -0,0 +1,508 @@
+/**
+ * Author: Jack Robbins
+ * This program is a long running solver for the N-puzzle problem. It takes a number N for the NxN size of the puzzles
+ * and the path of a Unix domain socket, loads the heuristic once, and then answers solve requests on the socket until
+ * it is stopped. See solver_protocol.c for what the requests and responses look like, and solve_client.c for a client.
+ *
+ * Starting a solver process costs far more than solving most puzzles: the arguments have to be parsed, the heuristic
+ * tables built, and pattern databases read in from disk. The server pays for all of that once. A pool of worker threads
+ * is started up front, each with its own search path already allocated, so a request only pays for its search.
+ * Connections wait in a bounded queue for a free worker, and once the queue is full, new connections are told that the
+ * server is busy right away instead of piling up.
+ *
+ * Two engines are offered. "ida" is iterative deepening A*, which always finds an optimal solution. "wida" is weighted
+ * IDA*, ordering states by g + w*h, which is much faster and finds a solution at most w times longer than optimal.
+ * Every request can have a deadline, after which its search gives up
+ *
+ * Note: This is the server version of the solver
+ */
+
+//For timing
+#include <time.h>
+//For multi-threading functionality
+#include <pthread.h>
+//For the socket
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "npuzzle.h"
+#include "solver_protocol.h"
+
+
+//The deepest that a search may go. Anything deeper is cut off
+#define MAX_SEARCH_DEPTH 1024
+//How many connections may wait for a worker for each worker, before the server says that it's busy
+#define QUEUE_PER_WORKER 4
+//How many states are expanded between looks at the clock
+#define DEADLINE_CHECK_INTERVAL 4096
+//What a search can end with
+#define SEARCH_FOUND 1
+#define SEARCH_EXHAUSTED 0
+#define SEARCH_TIMED_OUT -1
+#define SEARCH_TOO_DEEP -2
+
+
+/**
+ * Everything that one worker thread needs to search, allocated once when the server starts
+ */
+struct search_context {
+	//Which worker this is
+	int index;
+	//The states along the current path, so that no state is ever allocated during a search
+	struct state path[MAX_SEARCH_DEPTH + 1];
+	//The moves along the current path
+	char moves[MAX_SEARCH_DEPTH];
+	//The weight on the heuristic, 1 for an optimal search
+	double weight;
+	//The bound of the current iteration, and the smallest cost over it that was seen
+	int bound, next_bound;
+	//When the search has to give up, and whether it has
+	struct timespec deadline;
+	int has_deadline, timed_out;
+	//How deep the goal was found
+	int solution_length;
+	//How many states were expanded for the current request, and how long its search took in microseconds
+	long expanded, search_time;
+};
+
+
+/*================================= Global variables for convenience =========================== */
+//The heuristic cache that sits in front of the heuristic, shared by every worker, NULL if turned off
+struct heuristic_cache* cache = NULL;
+//The size of the puzzles that this server solves, and the goal
+int N;
+struct state* goal_state;
+//The weight that the wida engine uses
+double wida_weight;
+//Connections waiting for a worker, as a ring buffer
+int* queue;
+int queue_capacity, queue_head = 0, queue_count = 0;
+pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t queue_not_empty = PTHREAD_COND_INITIALIZER;
+//Every request gets a number, for the server's log
+long next_request = 0;
+pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+//The socket path, so that it can be removed when the server stops
+const char* socket_path;
+/*============================================================================================== */
+
+
+/**
+ * Make a move on a state. 0 = left, 1 = right, 2 = down, 3 = up, the same convention as everywhere else
+ */
+static void make_move(struct state* statePtr, int move){
+	if(move == 0){
+		move_left(statePtr, N);
+	} else if(move == 1){
+		move_right(statePtr, N);
+	} else if(move == 2){
+		move_down(statePtr, N);
+	} else {
+		move_up(statePtr, N);
+	}
+}
+
+
+/**
+ * Whether a move is possible from a state
+ */
+static int move_possible(struct state* statePtr, int move){
+	return (move == 0 && statePtr->zero_column > 0) || (move == 1 && statePtr->zero_column < N - 1)
+		   || (move == 2 && statePtr->zero_row < N - 1) || (move == 3 && statePtr->zero_row > 0);
+}
+
+
+/**
+ * Microseconds from one time to another
+ */
+static long microseconds_between(struct timespec* from, struct timespec* to){
+	return (to->tv_sec - from->tv_sec) * 1000000L + (to->tv_nsec - from->tv_nsec) / 1000;
+}
+
+
+/**
+ * The depth first search of one IDA* iteration, with the state at the given depth already evaluated. Moves that undo
+ * the last move are never made
+ */
+static int bounded_search(struct search_context* context, int depth, int last_move){
+	struct state* current = &context->path[depth];
+	int cost = current->current_travel + (int)(context->weight * current->heuristic_cost);
+
+	//Cut off anything over the bound, but remember the smallest such cost for the next iteration
+	if(cost > context->bound){
+		if(cost < context->next_bound){
+			context->next_bound = cost;
+		}
+		return SEARCH_EXHAUSTED;
+	}
+
+	//Only the goal has a heuristic of 0, so that is a cheap filter
+	if(current->heuristic_cost == 0 && states_same(current, goal_state, N)){
+		context->solution_length = depth;
+		return SEARCH_FOUND;
+	}
+
+	//Too deep to go on, treat it like a cut off
+	if(depth == MAX_SEARCH_DEPTH){
+		return SEARCH_EXHAUSTED;
+	}
+
+	//Look at the clock every so often
+	context->expanded++;
+	if(context->has_deadline && context->expanded % DEADLINE_CHECK_INTERVAL == 0){
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		if(microseconds_between(&context->deadline, &now) >= 0){
+			context->timed_out = 1;
+		}
+	}
+	if(context->timed_out){
+		return SEARCH_TIMED_OUT;
+	}
+
+	for(int move = 0; move < 4; move++){
+		//Skip impossible moves and the move that would undo the last one
+		if(!move_possible(current, move) || (last_move != -1 && move == (last_move ^ 1))){
+			continue;
+		}
+
+		struct state* successor = &context->path[depth + 1];
+		copy_state(current, successor, N);
+		make_move(successor, move);
+		update_heuristic(successor, N, cache);
+		context->moves[depth] = move;
+
+		int result = bounded_search(context, depth + 1, move);
+		if(result != SEARCH_EXHAUSTED){
+			return result;
+		}
+	}
+
+	return SEARCH_EXHAUSTED;
+}
+
+
+/**
+ * Run IDA* from the tiles in the first state of the context's path, raising the bound until the goal is found. Returns
+ * SEARCH_FOUND, SEARCH_TIMED_OUT if the deadline passed first, or SEARCH_TOO_DEEP if every path left was cut off at
+ * MAX_SEARCH_DEPTH
+ */
+static int ida_star(struct search_context* context){
+	struct state* start = &context->path[0];
+
+	//The start has no predecessor, so incremental heuristics start from scratch
+	start->current_travel = 0;
+	start->predecessor = NULL;
+	update_heuristic(start, N, cache);
+	context->bound = (int)(context->weight * start->heuristic_cost);
+
+	while(1){
+		context->next_bound = __INT_MAX__;
+
+		int result = bounded_search(context, 0, -1);
+		if(result != SEARCH_EXHAUSTED){
+			return result;
+		}
+
+		//Every path was cut off by MAX_SEARCH_DEPTH, so there is nothing left to try
+		if(context->next_bound == __INT_MAX__){
+			return SEARCH_TOO_DEEP;
+		}
+
+		context->bound = context->next_bound;
+	}
+}
+
+
+/**
+ * Answer one request, writing the response text into response, and the engine that it asked for into engine if it
+ * got that far. The search itself is the only thing timed
+ */
+static void answer_request(struct search_context* context, char* request, char* response, char* engine){
+	long deadline;
+	int request_N, consumed;
+	char* cursor = request;
+
+	if(sscanf(cursor, "%15s %ld %d%n", engine, &deadline, &request_N, &consumed) != 3){
+		sprintf(engine, "-");
+		sprintf(response, "ERROR malformed request");
+		return;
+	}
+	cursor += consumed;
+
+	//Everything that the heuristic needs was set up for one N
+	if(request_N != N){
+		sprintf(response, "ERROR this server solves %dx%d puzzles", N, N);
+		return;
+	}
+
+	if(strcmp(engine, "ida") == 0){
+		context->weight = 1.0;
+	} else if(strcmp(engine, "wida") == 0){
+		context->weight = wida_weight;
+	} else {
+		sprintf(response, "ERROR unknown engine %s, use ida or wida", engine);
+		return;
+	}
+
+	//Read the tiles straight into the first state of the path, checking that each shows up exactly once
+	struct state* start = &context->path[0];
+	char* present = (char*)calloc(N * N, 1);
+	for(int i = 0; i < N * N; i++){
+		int tile;
+		if(sscanf(cursor, "%d%n", &tile, &consumed) != 1 || tile < 0 || tile >= N * N || present[tile]){
+			free(present);
+			sprintf(response, "ERROR the configuration must hold every number from 0 to %d exactly once", N * N - 1);
+			return;
+		}
+		cursor += consumed;
+
+		present[tile] = 1;
+		start->tiles[i] = tile;
+		if(tile == 0){
+			start->zero_row = i / N;
+			start->zero_column = i % N;
+		}
+	}
+	free(present);
+	start->zobrist_key = compute_zobrist_key(start->tiles, N);
+
+	if(!reaches_standard_goal(start, N)){
+		sprintf(response, "ERROR this configuration can't be solved");
+		return;
+	}
+
+	//Only the search is timed, starting now
+	struct timespec begin, end;
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	context->expanded = 0;
+	context->timed_out = 0;
+	context->has_deadline = deadline > 0;
+	context->deadline = begin;
+	context->deadline.tv_sec += deadline / 1000;
+	context->deadline.tv_nsec += (deadline % 1000) * 1000000L;
+	if(context->deadline.tv_nsec >= 1000000000L){
+		context->deadline.tv_sec++;
+		context->deadline.tv_nsec -= 1000000000L;
+	}
+
+	int result = ida_star(context);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	context->search_time = microseconds_between(&begin, &end);
+
+	if(result == SEARCH_TIMED_OUT){
+		sprintf(response, "ERROR no solution within the deadline, %ld states expanded in %ld microseconds", context->expanded, context->search_time);
+		return;
+	}
+
+	//Running out of depth has nothing to do with time, so a longer deadline wouldn't help
+	if(result == SEARCH_TOO_DEEP){
+		sprintf(response, "ERROR no solution within %d moves, the deepest that this server searches, %ld states expanded in %ld microseconds",
+				MAX_SEARCH_DEPTH, context->expanded, context->search_time);
+		return;
+	}
+
+	//The moves of the blank, as the letters that solve_macro uses
+	int length = sprintf(response, "OK %d %ld %ld ", context->solution_length + 1, context->expanded, context->search_time);
+	for(int i = 0; i < context->solution_length; i++){
+		response[length++] = "LRDU"[(int)context->moves[i]];
+	}
+	response[length] = '\0';
+}
+
+
+/**
+ * Answer one request, and give it one line in the server's log whatever the outcome, so that failures show up there
+ * just like solutions do
+ */
+static void handle_request(struct search_context* context, char* request, char* response){
+	//A request too malformed to name an engine is logged without one
+	char engine[16] = "-";
+	answer_request(context, request, response, engine);
+
+	pthread_mutex_lock(&log_lock);
+	if(strncmp(response, "OK", 2) == 0){
+		printf("Request %6ld: %-4s path length %4d, %12ld states expanded, %10ld microseconds\n", next_request++, engine,
+			   context->solution_length + 1, context->expanded, context->search_time);
+	} else {
+		printf("Request %6ld: %-4s %s\n", next_request++, engine, response);
+	}
+	fflush(stdout);
+	pthread_mutex_unlock(&log_lock);
+}
+
+
+/**
+ * The worker thread function. Take a connection off of the queue and answer its requests until the client hangs up
+ */
+static void* worker_thread(void* argument){
+	struct search_context* context = (struct search_context*)argument;
+	char* request = (char*)malloc(MAX_FRAME_SIZE);
+	char* response = (char*)malloc(MAX_FRAME_SIZE);
+
+	//With --numa on, stay on one node and use its copy of the heuristic's tables
+	place_worker_thread(context->index);
+
+	while(1){
+		//Wait for a connection
+		pthread_mutex_lock(&queue_lock);
+		while(queue_count == 0){
+			pthread_cond_wait(&queue_not_empty, &queue_lock);
+		}
+		int connection = queue[queue_head];
+		queue_head = (queue_head + 1) % queue_capacity;
+		queue_count--;
+		pthread_mutex_unlock(&queue_lock);
+
+		//A client can send any number of requests on one connection
+		while(read_frame(connection, request, MAX_FRAME_SIZE) >= 0){
+			handle_request(context, request, response);
+			if(write_frame(connection, response, strlen(response)) != 0){
+				break;
+			}
+		}
+
+		close(connection);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Remove the socket when the server is stopped, so that the next server can bind to it
+ */
+static void stop_server(int signal_number){
+	(void)signal_number;
+	unlink(socket_path);
+	_exit(0);
+}
+
+
+/**
+ * The main function loads the heuristic, starts the workers, and then accepts connections for as long as it runs
+ */
+int main(int argc, char** argv){
+	//Manhattan distance plus linear conflict by default
+	struct solver_options options;
+	default_solver_options(&options, "lc");
+
+	//Check for optional flags before anything else
+	int consumed = parse_solver_options(argc, argv, &options);
+	if(consumed < 0){
+		print_solver_options_usage();
+		return 1;
+	}
+
+	//Skip over the flags, so that argv[1] is N no matter what
+	argc -= consumed;
+	argv += consumed;
+
+	if(argc != 3 || sscanf(argv[1], "%d", &N) != 1 || N < 2){
+		printf("Incorrect program arguments.\n");
+		printf("Usage: ./solve_server [options] <N> <socket path>\n");
+		printf("Where <N> is the number of rows/columns of every puzzle that the server will solve.\n");
+		printf("--threads sets how many requests are searched at once, and --weight the weight of the wida engine.\n\n");
+		print_solver_options_usage();
+		return 1;
+	}
+	socket_path = argv[2];
+
+	//The weight only applies to the wida engine, so the heuristic itself must not be weighted
+	wida_weight = options.weight > 1.0 ? options.weight : 2.0;
+	options.weight = 1.0;
+
+	//One worker per core unless told otherwise
+	int threads = options.threads;
+	if(threads == 0){
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cores < 1 ? 1 : (cores > MAX_THREADS ? MAX_THREADS : (int)cores);
+	}
+
+	//The ida engine promises optimal solutions, which a heuristic that overestimates can't keep
+	if(!heuristic_specification_admissible(options.heuristic)){
+		printf("ERROR. Heuristic %s adds overlapping heuristics, which can overestimate, so it is not supported by the server.\n\n", options.heuristic);
+		return 1;
+	}
+
+	//Load or build everything the heuristic needs once, up front. This is what every request would otherwise pay for
+	initialize_zobrist(N);
+	if(initialize_heuristic(&options, N) != 0){
+		return 1;
+	}
+	cache = create_heuristic_cache_for(&options);
+
+	//The goal is 1, 2, ..., 0
+	goal_state = (struct state*)malloc(sizeof(struct state));
+	initialize_state(goal_state, N);
+	for(int i = 0; i < N * N; i++){
+		goal_state->tiles[i] = (i + 1) % (N * N);
+	}
+	goal_state->zero_row = goal_state->zero_column = N - 1;
+	goal_state->zobrist_key = compute_zobrist_key(goal_state->tiles, N);
+
+	//Listen on the socket, replacing whatever a server that didn't stop cleanly left behind
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+	unlink(socket_path);
+	if(listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 128) != 0){
+		printf("ERROR. Could not listen on %s.\n", socket_path);
+		return 1;
+	}
+
+	//A client that hangs up early must not take the server with it
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGINT, stop_server);
+	signal(SIGTERM, stop_server);
+
+	//Start every worker with its search path already allocated
+	queue_capacity = threads * QUEUE_PER_WORKER;
+	queue = (int*)malloc(sizeof(int) * queue_capacity);
+	for(int i = 0; i < threads; i++){
+		struct search_context* context = (struct search_context*)malloc(sizeof(struct search_context));
+		context->index = i;
+		for(int depth = 0; depth <= MAX_SEARCH_DEPTH; depth++){
+			initialize_state(&context->path[depth], N);
+		}
+
+		pthread_t thread;
+		pthread_create(&thread, NULL, worker_thread, context);
+		pthread_detach(thread);
+	}
+
+	printf("Solving %dx%d puzzles on %s with %d worker threads, heuristic %s\n", N, N, socket_path, threads, heuristic_name());
+	fflush(stdout);
+
+	while(1){
+		int connection = accept(listener, NULL, NULL);
+		if(connection < 0){
+			continue;
+		}
+
+		//Hand the connection to a worker, unless there are already too many waiting
+		pthread_mutex_lock(&queue_lock);
+		int busy = queue_count == queue_capacity;
+		if(!busy){
+			queue[(queue_head + queue_count) % queue_capacity] = connection;
+			queue_count++;
+			pthread_cond_signal(&queue_not_empty);
+		}
+		pthread_mutex_unlock(&queue_lock);
+
+		//Tell the client right away, so that it can go elsewhere or try again later. Its requests were never read, so
+		//the log only gets the connection
+		if(busy){
+			write_frame(connection, "BUSY", 4);
+			close(connection);
+
+			pthread_mutex_lock(&log_lock);
+			printf("Turned a connection away: BUSY, %d connections already waiting\n", queue_capacity);
+			fflush(stdout);
+			pthread_mutex_unlock(&log_lock);
+		}
+	}
+}
@@ -0,0 +1,100 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in solver_protocol.h. Every message between solve_server and
+ * solve_client is one frame: a 4 byte length in network byte order, followed by that many bytes of text. A request is
+ * "<engine> <deadline in ms> <N> <n0> . . . <nN>", and the response is one of
+ *
+ *   OK <path length> <states expanded> <search microseconds> <moves of the blank, as L, R, U and D>
+ *   BUSY
+ *   ERROR <why>
+ */
+
+//Link to solver_protocol.h
+#include "solver_protocol.h"
+//For reading and writing sockets
+#include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
+
+/**
+ * Write exactly count bytes, retrying after short writes and interruptions. Returns 0, or -1 if the other side is gone
+ */
+static int write_all(int socket, const char* buffer, int count){
+	while(count > 0){
+		ssize_t written = write(socket, buffer, count);
+
+		if(written < 0 && errno == EINTR){
+			continue;
+		}
+		if(written <= 0){
+			return -1;
+		}
+
+		buffer += written;
+		count -= written;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Read exactly count bytes, retrying after short reads and interruptions. Returns 0, or -1 if the other side is gone
+ */
+static int read_all(int socket, char* buffer, int count){
+	while(count > 0){
+		ssize_t got = read(socket, buffer, count);
+
+		if(got < 0 && errno == EINTR){
+			continue;
+		}
+		if(got <= 0){
+			return -1;
+		}
+
+		buffer += got;
+		count -= got;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Send one frame holding length bytes of message. Returns 0, or -1 if the other side is gone
+ */
+int write_frame(int socket, const char* message, int length){
+	unsigned int header = htonl(length);
+
+	if(write_all(socket, (const char*)&header, sizeof(header)) != 0){
+		return -1;
+	}
+
+	return write_all(socket, message, length);
+}
+
+
+/**
+ * Receive one frame into buffer, which holds capacity bytes, and null terminate it. Returns the length of the message,
+ * or -1 if the other side is gone or the frame doesn't fit
+ */
+int read_frame(int socket, char* buffer, int capacity){
+	unsigned int header;
+
+	if(read_all(socket, (char*)&header, sizeof(header)) != 0){
+		return -1;
+	}
+
+	int length = ntohl(header);
+	if(length < 0 || length >= capacity){
+		return -1;
+	}
+
+	if(read_all(socket, buffer, length) != 0){
+		return -1;
+	}
+
+	buffer[length] = '\0';
+	return length;
+}
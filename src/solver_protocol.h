@@ -0,0 +1,23 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the framing used between solve_server and solve_client, and the function prototypes that
+ * are implemented in solver_protocol.c
+ */
+
+
+#ifndef SOLVER_PROTOCOL_H
+#define SOLVER_PROTOCOL_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+//No request or response is bigger than this, which is room for a 64x64 puzzle or a very long solution
+#define MAX_FRAME_SIZE 65536
+
+
+/* Method Protoypes */
+int write_frame(int, const char*, int);
+int read_frame(int, char*, int);
+
+#endif /* SOLVER_PROTOCOL_H */
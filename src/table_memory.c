@@ -0,0 +1,377 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementations for functions in table_memory.h. The node store, the heuristic cache, the
+ * concurrent set, the perimeter and the pattern database all grow to hundreds of megabytes on hard puzzles, and every
+ * lookup in them lands on a random 4 KB page, so most of them miss the TLB as well as the cache. Backing them with 2 MB
+ * pages takes those misses away. On machines with more than one NUMA node, threads are pinned to nodes, read only
+ * tables are copied onto every node, and shared tables are interleaved across the nodes so that no one node's memory
+ * takes all of the traffic. Everything here is opt in, with --huge-pages and --numa, and the counters say what the
+ * kernel actually gave us, since asking for huge pages is only ever a request
+ */
+
+//For pthread_setaffinity_np and the CPU_* macros
+#define _GNU_SOURCE
+//Link to table_memory.h
+#include "table_memory.h"
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+
+/*================================= Global variables for convenience =========================== */
+//How tables are backed, and whether they are placed on NUMA nodes
+static int huge_page_mode = HUGE_PAGES_NONE;
+static int numa_enabled = 0;
+//The id of every NUMA node, since node ids don't have to be consecutive
+static int node_ids[MAX_NUMA_NODES];
+static int num_nodes = 0;
+//What we asked for and what we got
+static atomic_long tables_mapped;
+static atomic_long huge_page_bytes_requested;
+static atomic_long hugetlb_bytes;
+static atomic_long hugetlb_fallbacks;
+static atomic_long interleaved_bytes;
+static atomic_long node_bound_bytes;
+static atomic_long threads_pinned;
+/*============================================================================================== */
+
+
+/**
+ * Round a size up to a multiple of the given power of 2
+ */
+static size_t round_up(size_t bytes, size_t multiple){
+	return (bytes + multiple - 1) & ~(multiple - 1);
+}
+
+
+/**
+ * Whether a table of this size gets huge pages
+ */
+static int uses_huge_pages(size_t bytes){
+	return huge_page_mode != HUGE_PAGES_NONE && bytes >= HUGE_PAGE_SIZE;
+}
+
+
+/**
+ * Whether a table of this size gets a mapping of its own, for huge pages or to be interleaved across NUMA nodes. Deciding
+ * by the size alone means that free_table knows how a table was made without keeping any record of it
+ */
+static int uses_mapping(size_t bytes){
+	return uses_huge_pages(bytes) || (numa_enabled && num_nodes > 1 && bytes >= HUGE_PAGE_SIZE);
+}
+
+
+/**
+ * How big the mapping for a table of this size is
+ */
+static size_t mapping_size(size_t bytes){
+	return uses_huge_pages(bytes) ? round_up(bytes, HUGE_PAGE_SIZE) : round_up(bytes, sysconf(_SC_PAGESIZE));
+}
+
+
+/**
+ * Map zeroed anonymous memory for a table, with huge pages if it is big enough. Returns NULL if there is no memory
+ */
+static void* map_table(size_t bytes){
+	size_t size = mapping_size(bytes);
+
+	if(!uses_huge_pages(bytes)){
+		void* table = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		return table == MAP_FAILED ? NULL : table;
+	}
+
+	atomic_fetch_add(&tables_mapped, 1);
+	atomic_fetch_add(&huge_page_bytes_requested, size);
+
+	//Reserved huge pages are all or nothing, and there are none unless the administrator set some aside
+	if(huge_page_mode == HUGE_PAGES_HUGETLB){
+		void* table = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if(table != MAP_FAILED){
+			atomic_fetch_add(&hugetlb_bytes, size);
+			return table;
+		}
+		atomic_fetch_add(&hugetlb_fallbacks, 1);
+	}
+
+	//A transparent huge page has to start on a 2 MB boundary, so map an extra huge page and trim it off
+	unsigned char* mapping = (unsigned char*)mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(mapping == MAP_FAILED){
+		return NULL;
+	}
+
+	unsigned char* table = (unsigned char*)round_up((size_t)mapping, HUGE_PAGE_SIZE);
+	if(table > mapping){
+		munmap(mapping, table - mapping);
+	}
+	munmap(table + size, mapping + HUGE_PAGE_SIZE - table);
+
+	madvise(table, size, MADV_HUGEPAGE);
+
+	return table;
+}
+
+
+/**
+ * Set the memory policy of a mapping to the nodes in the mask, through the system call since libnuma may not be there
+ */
+static int bind_mapping(void* table, size_t size, int policy, const unsigned long* mask){
+	//The kernel only looks at maxnode - 1 bits of the mask
+	return syscall(SYS_mbind, table, size, policy, mask, MAX_NUMA_NODES + 1, 0);
+}
+
+
+/**
+ * Find every NUMA node that the machine has. A machine without the sysfs node directory has one node
+ */
+static void discover_nodes(){
+	char path[64];
+	num_nodes = 0;
+
+	for(int node = 0; node < MAX_NUMA_NODES; node++){
+		sprintf(path, "/sys/devices/system/node/node%d", node);
+		if(access(path, F_OK) == 0){
+			node_ids[num_nodes++] = node;
+		}
+	}
+
+	if(num_nodes == 0){
+		node_ids[num_nodes++] = 0;
+	}
+}
+
+
+/**
+ * Set up table allocation as the options say. Must be called before any table is allocated, and not again after
+ */
+void configure_table_memory(const struct solver_options* options){
+	huge_page_mode = options->huge_pages;
+	numa_enabled = options->numa;
+	discover_nodes();
+}
+
+
+/**
+ * Allocate a zeroed table. Tables of at least a huge page get a mapping of their own when huge pages or NUMA placement
+ * are turned on, and every other table comes from calloc. With NUMA placement turned on, big tables are interleaved across the nodes, since
+ * every thread uses them. Returns NULL if there is no memory
+ * NOTE: the table must be freed with free_table, given the same size
+ */
+void* allocate_table(size_t bytes){
+	if(!uses_mapping(bytes)){
+		return calloc(bytes, 1);
+	}
+
+	void* table = map_table(bytes);
+
+	if(table != NULL && numa_enabled && num_nodes > 1){
+		unsigned long mask[MAX_NUMA_NODES / 64] = {0};
+		for(int i = 0; i < num_nodes; i++){
+			mask[node_ids[i] / 64] |= 1UL << (node_ids[i] % 64);
+		}
+		if(bind_mapping(table, mapping_size(bytes), MPOL_INTERLEAVE, mask) == 0){
+			atomic_fetch_add(&interleaved_bytes, mapping_size(bytes));
+		}
+	}
+
+	return table;
+}
+
+
+/**
+ * Change the size of a table made by allocate_table, keeping what it holds. Whatever is new is zeroed, except for tables
+ * that stay small enough for realloc
+ */
+void* resize_table(void* table, size_t old_bytes, size_t new_bytes){
+	if(!uses_mapping(old_bytes) && !uses_mapping(new_bytes)){
+		return realloc(table, new_bytes);
+	}
+
+	//A fresh mapping is zeroed for free, and the tables only ever double, so the copy is paid for once per doubling
+	void* resized = allocate_table(new_bytes);
+	if(resized != NULL){
+		memcpy(resized, table, old_bytes < new_bytes ? old_bytes : new_bytes);
+		free_table(table, old_bytes);
+	}
+
+	return resized;
+}
+
+
+/**
+ * Free a table made by allocate_table or resize_table, which was bytes big. Does nothing if table is NULL
+ */
+void free_table(void* table, size_t bytes){
+	if(table == NULL){
+		return;
+	}
+
+	if(uses_mapping(bytes)){
+		munmap(table, mapping_size(bytes));
+	} else {
+		free(table);
+	}
+}
+
+
+/**
+ * Ask for huge pages for a mapping that was made somewhere else, like a memory mapped file. The kernel only gives file
+ * backed mappings huge pages on tmpfs, so this is a request and nothing more
+ */
+void advise_table_mapping(void* mapping, size_t bytes){
+	if(uses_huge_pages(bytes)){
+		madvise(mapping, bytes, MADV_HUGEPAGE);
+	}
+}
+
+
+/**
+ * How many NUMA nodes there are
+ */
+int numa_node_count(){
+	if(num_nodes == 0){
+		discover_nodes();
+	}
+
+	return num_nodes;
+}
+
+
+/**
+ * Whether the user turned on NUMA placement
+ */
+int numa_placement_enabled(){
+	return numa_enabled;
+}
+
+
+/**
+ * Pin the calling thread to the CPUs of the node'th NUMA node, counting from 0, wrapping around if there aren't that
+ * many. Returns 0 on success, or -1 if the node's CPUs can't be found or the thread can't be moved
+ */
+int pin_thread_to_node(int node){
+	char path[80];
+	sprintf(path, "/sys/devices/system/node/node%d/cpulist", node_ids[node % numa_node_count()]);
+
+	FILE* cpulist = fopen(path, "r");
+	if(cpulist == NULL){
+		return -1;
+	}
+
+	//The list looks like "0-7,16-23"
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	int first, last;
+	char separator;
+	while(fscanf(cpulist, "%d", &first) == 1){
+		last = first;
+		if(fscanf(cpulist, "%c", &separator) == 1 && separator == '-'){
+			if(fscanf(cpulist, "%d", &last) != 1){
+				break;
+			}
+			if(fscanf(cpulist, "%c", &separator) != 1){
+				separator = '\n';
+			}
+		}
+
+		for(int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++){
+			CPU_SET(cpu, &cpus);
+		}
+
+		if(separator != ','){
+			break;
+		}
+	}
+	fclose(cpulist);
+
+	if(CPU_COUNT(&cpus) == 0 || pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0){
+		return -1;
+	}
+
+	atomic_fetch_add(&threads_pinned, 1);
+	return 0;
+}
+
+
+/**
+ * Allocate a zeroed table whose memory all comes from the node'th NUMA node, for a copy of a read only table that the
+ * threads pinned to that node use. Returns NULL if there is no memory
+ * NOTE: the table must be freed with free_table_on_node, given the same size
+ */
+void* allocate_table_on_node(size_t bytes, int node){
+	void* table = map_table(bytes);
+
+	if(table != NULL){
+		unsigned long mask[MAX_NUMA_NODES / 64] = {0};
+		int id = node_ids[node % numa_node_count()];
+		mask[id / 64] |= 1UL << (id % 64);
+
+		if(bind_mapping(table, mapping_size(bytes), MPOL_BIND, mask) == 0){
+			atomic_fetch_add(&node_bound_bytes, mapping_size(bytes));
+		}
+	}
+
+	return table;
+}
+
+
+/**
+ * Free a table made by allocate_table_on_node, which was bytes big. Does nothing if table is NULL
+ */
+void free_table_on_node(void* table, size_t bytes){
+	if(table != NULL){
+		munmap(table, mapping_size(bytes));
+	}
+}
+
+
+/**
+ * Read one field, in kB, out of the kernel's summary of our memory. Returns 0 if it isn't there
+ */
+static long read_memory_field(const char* field){
+	FILE* rollup = fopen("/proc/self/smaps_rollup", "r");
+	if(rollup == NULL){
+		return 0;
+	}
+
+	char line[256];
+	long kilobytes = 0;
+	size_t length = strlen(field);
+	while(fgets(line, sizeof(line), rollup) != NULL){
+		if(strncmp(line, field, length) == 0 && line[length] == ':'){
+			sscanf(line + length + 1, "%ld", &kilobytes);
+			break;
+		}
+	}
+	fclose(rollup);
+
+	return kilobytes;
+}
+
+
+/**
+ * Print out what was asked of the kernel and what it gave us. Prints nothing if huge pages and NUMA placement are
+ * both turned off
+ */
+void print_table_memory_stats(){
+	static const char* mode_names[] = {"none", "thp", "hugetlb"};
+
+	if(huge_page_mode != HUGE_PAGES_NONE){
+		//What backs the process right now, which is what the search is using
+		double transparent = read_memory_field("AnonHugePages") / 1024.0;
+		double reserved = (read_memory_field("Private_Hugetlb") + read_memory_field("Shared_Hugetlb")) / 1024.0;
+
+		printf("Huge pages(%s): %ld tables(%.2f MB) asked for them, %.2f MB came from reserved huge pages, %ld fell back to transparent ones, now using %.2f MB of transparent and %.2f MB of reserved huge pages\n",
+			   mode_names[huge_page_mode], atomic_load(&tables_mapped), atomic_load(&huge_page_bytes_requested) / 1048576.0,
+			   atomic_load(&hugetlb_bytes) / 1048576.0, atomic_load(&hugetlb_fallbacks), transparent, reserved);
+	}
+
+	if(numa_enabled){
+		printf("NUMA: %d nodes, %ld threads pinned, %.2f MB interleaved, %.2f MB bound to nodes\n", numa_node_count(),
+			   atomic_load(&threads_pinned), atomic_load(&interleaved_bytes) / 1048576.0, atomic_load(&node_bound_bytes) / 1048576.0);
+	}
+}
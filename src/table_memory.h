@@ -0,0 +1,41 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the allocator that every large search table gets its memory from, which can back the
+ * tables with huge pages and place them on NUMA nodes, along with the function prototypes that are implemented in
+ * table_memory.c
+ */
+
+
+#ifndef TABLE_MEMORY_H
+#define TABLE_MEMORY_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "options.h"
+
+
+//How tables are backed. NONE is plain malloc, THP asks the kernel for transparent huge pages, and HUGETLB takes
+//reserved huge pages, falling back to THP when there aren't enough of them
+#define HUGE_PAGES_NONE 0
+#define HUGE_PAGES_THP 1
+#define HUGE_PAGES_HUGETLB 2
+//The size of a huge page on x86-64. Tables smaller than this are never worth a mapping of their own
+#define HUGE_PAGE_SIZE (2UL << 20)
+//The most NUMA nodes that the solvers will place threads and tables on
+#define MAX_NUMA_NODES 64
+
+
+/* Method Protoypes */
+void configure_table_memory(const struct solver_options*);
+void* allocate_table(size_t);
+void* resize_table(void*, size_t, size_t);
+void free_table(void*, size_t);
+void advise_table_mapping(void*, size_t);
+int numa_node_count(void);
+int numa_placement_enabled(void);
+int pin_thread_to_node(int);
+void* allocate_table_on_node(size_t, int);
+void free_table_on_node(void*, size_t);
+void print_table_memory_stats(void);
+
+#endif /* TABLE_MEMORY_H */
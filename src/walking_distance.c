@@ -0,0 +1,300 @@
+/**
+ * Author: Jack Robbins
+ * This c file contains the implementation of the walking distance heuristic, as described in walking_distance.h
+ *
+ * Walking distance looks at the puzzle one axis at a time. For the rows, all that matters is how many tiles from each
+ * goal row are currently sitting in each row, and which row the 0 slider is in. Every vertical move takes one tile out of
+ * a row next to the 0 slider and puts it into the row of the 0 slider. Doing a breadth first search over these row
+ * configurations from the goal gives the exact number of vertical moves needed to fix the rows, ignoring columns
+ * entirely. The same is true for the columns with horizontal moves, and because the standard goal state is symmetric,
+ * the same table works for both. The sum of the two is an admissable heuristic that is much more informed than manhattan
+ * distance, because it accounts for tiles in the same row or column getting in each other's way
+ */
+
+//Link to walking_distance.h
+#include "walking_distance.h"
+
+
+/*================================= Global variables for convenience =========================== */
+//Each count in a configuration is stored in 3 bits, so counts of up to 7 fit
+#define COUNT_BITS 3
+#define COUNT_MASK 7ULL
+
+//The table maps configuration codes to walking distances. It is an open addressing hash table
+unsigned long long* wd_codes = NULL;
+unsigned char* wd_distances = NULL;
+unsigned long long wd_table_size = 0;
+unsigned long long wd_table_count = 0;
+
+//The shift of the 0 slider's row within a code
+int wd_blank_shift;
+//The N that the table was built for
+int wd_N = 0;
+/*============================================================================================== */
+
+
+/**
+ * Where in a code the count of tiles from goal row "goal_row" sitting in row "row" is stored. The count for the last goal
+ * row is never stored, because it can always be found from the other counts in the row
+ */
+static int count_shift(int row, int goal_row){
+	return COUNT_BITS * (row * (wd_N - 1) + goal_row);
+}
+
+
+/**
+ * Find the slot where code is stored in the table, or the empty slot where it belongs. Empty slots hold the
+ * otherwise impossible code ~0
+ */
+static unsigned long long table_slot(unsigned long long code){
+	//Mix the bits of the code so that similar codes spread out
+	unsigned long long hash = code * 0x9E3779B97F4A7C15ULL;
+	unsigned long long slot = (hash >> 20) & (wd_table_size - 1);
+
+	//Linear probing
+	while(wd_codes[slot] != ~0ULL && wd_codes[slot] != code){
+		slot = (slot + 1) & (wd_table_size - 1);
+	}
+
+	return slot;
+}
+
+
+/**
+ * Insert a code with its distance into the table, doubling the table as needed. Returns 1 if the code was new
+ */
+static int table_insert(unsigned long long code, unsigned char distance){
+	//Keep the table at most half full
+	if(wd_table_count * 2 >= wd_table_size){
+		unsigned long long* old_codes = wd_codes;
+		unsigned char* old_distances = wd_distances;
+		unsigned long long old_size = wd_table_size;
+
+		wd_table_size *= 2;
+		wd_codes = (unsigned long long*)malloc(sizeof(unsigned long long) * wd_table_size);
+		memset(wd_codes, 0xFF, sizeof(unsigned long long) * wd_table_size);
+		wd_distances = (unsigned char*)malloc(sizeof(unsigned char) * wd_table_size);
+
+		//Rehash everything that was in the old table
+		for(unsigned long long i = 0; i < old_size; i++){
+			if(old_codes[i] != ~0ULL){
+				unsigned long long slot = table_slot(old_codes[i]);
+				wd_codes[slot] = old_codes[i];
+				wd_distances[slot] = old_distances[i];
+			}
+		}
+
+		free(old_codes);
+		free(old_distances);
+	}
+
+	unsigned long long slot = table_slot(code);
+
+	//Already seen, breadth first search guarantees the first distance was the smallest
+	if(wd_codes[slot] == code){
+		return 0;
+	}
+
+	wd_codes[slot] = code;
+	wd_distances[slot] = distance;
+	wd_table_count++;
+	return 1;
+}
+
+
+/**
+ * Unpack a code into a full N by N table of counts, including the counts of the last goal row. Returns the row of
+ * the 0 slider
+ */
+static int unpack_code(unsigned long long code, int* counts){
+	int blank_row = (code >> wd_blank_shift) & COUNT_MASK;
+
+	for(int row = 0; row < wd_N; row++){
+		//Every row holds N tiles, except the row with the 0 slider
+		int remaining = row == blank_row ? wd_N - 1 : wd_N;
+
+		for(int goal_row = 0; goal_row < wd_N - 1; goal_row++){
+			counts[row * wd_N + goal_row] = (code >> count_shift(row, goal_row)) & COUNT_MASK;
+			remaining -= counts[row * wd_N + goal_row];
+		}
+
+		//The last goal row takes whatever is left over
+		counts[row * wd_N + wd_N - 1] = remaining;
+	}
+
+	return blank_row;
+}
+
+
+/**
+ * Build the walking distance table for the given N, using a breadth first search over row configurations starting at the
+ * goal. This only has to be done once at startup. Returns 0 on success, or -1 if N is too large for walking distance
+ */
+int initialize_walking_distance(const int N){
+	//Codes must fit in 64 bits, and counts must fit in 3 bits
+	if(N < 2 || N > WALKING_DISTANCE_MAX_N){
+		return -1;
+	}
+
+	wd_N = N;
+	wd_blank_shift = COUNT_BITS * N * (N - 1);
+
+	//Start with a small table and let it grow
+	wd_table_size = 1024;
+	wd_table_count = 0;
+	wd_codes = (unsigned long long*)malloc(sizeof(unsigned long long) * wd_table_size);
+	memset(wd_codes, 0xFF, sizeof(unsigned long long) * wd_table_size);
+	wd_distances = (unsigned char*)malloc(sizeof(unsigned char) * wd_table_size);
+
+	//In the goal, every row holds the N tiles that belong to it, except the last row which also has the 0 slider
+	unsigned long long goal_code = (unsigned long long)(N - 1) << wd_blank_shift;
+	for(int row = 0; row < N - 1; row++){
+		goal_code += (unsigned long long)N << count_shift(row, row);
+	}
+
+	//The breadth first search queue. Every code is enqueued exactly once, so it grows alongside the table
+	unsigned long long queue_max_size = 1024;
+	unsigned long long* queue = (unsigned long long*)malloc(sizeof(unsigned long long) * queue_max_size);
+	unsigned char* queue_distances = (unsigned char*)malloc(sizeof(unsigned char) * queue_max_size);
+	unsigned long long head = 0, tail = 0;
+
+	table_insert(goal_code, 0);
+	queue[tail] = goal_code;
+	queue_distances[tail++] = 0;
+
+	int counts[N * N];
+
+	while(head < tail){
+		unsigned long long code = queue[head];
+		unsigned char distance = queue_distances[head++];
+		int blank_row = unpack_code(code, counts);
+
+		//The 0 slider can move up or down a row, bringing a tile from that row into its own row
+		for(int direction = -1; direction <= 1; direction += 2){
+			int other_row = blank_row + direction;
+			if(other_row < 0 || other_row >= N){
+				continue;
+			}
+
+			//The tile brought over can be from any goal row that has a tile in the other row
+			for(int goal_row = 0; goal_row < N; goal_row++){
+				if(counts[other_row * N + goal_row] == 0){
+					continue;
+				}
+
+				//Move one tile of this goal row from other_row into blank_row, and move the 0 slider to other_row
+				unsigned long long next_code = code;
+				if(goal_row < N - 1){
+					next_code -= 1ULL << count_shift(other_row, goal_row);
+					next_code += 1ULL << count_shift(blank_row, goal_row);
+				}
+				next_code &= ~(COUNT_MASK << wd_blank_shift);
+				next_code |= (unsigned long long)other_row << wd_blank_shift;
+
+				//Enqueue anything that we haven't seen before
+				if(table_insert(next_code, distance + 1)){
+					if(tail == queue_max_size){
+						queue_max_size *= 2;
+						queue = (unsigned long long*)realloc(queue, sizeof(unsigned long long) * queue_max_size);
+						queue_distances = (unsigned char*)realloc(queue_distances, sizeof(unsigned char) * queue_max_size);
+					}
+					queue[tail] = next_code;
+					queue_distances[tail++] = distance + 1;
+				}
+			}
+		}
+	}
+
+	free(queue);
+	free(queue_distances);
+
+	return 0;
+}
+
+
+/**
+ * Free the walking distance table
+ */
+void destroy_walking_distance(){
+	free(wd_codes);
+	free(wd_distances);
+	wd_codes = NULL;
+	wd_distances = NULL;
+}
+
+
+/**
+ * Calculate the row and column codes of a state from scratch, and store them in the state
+ */
+void walking_distance_codes(struct state* statePtr, const int N){
+	statePtr->wd_row_code = (unsigned long long)statePtr->zero_row << wd_blank_shift;
+	statePtr->wd_column_code = (unsigned long long)statePtr->zero_column << wd_blank_shift;
+
+	for(int i = 0; i < N; i++){
+		for(int j = 0; j < N; j++){
+			short tile = *(statePtr->tiles + i * N + j);
+
+			//The 0 slider is already accounted for
+			if(tile == 0){
+				continue;
+			}
+
+			//Count this tile in its current row under its goal row, and in its current column under its goal column
+			short goal_rowCor = (tile - 1) / N;
+			short goal_colCor = (tile - 1) % N;
+
+			if(goal_rowCor < N - 1){
+				statePtr->wd_row_code += 1ULL << count_shift(i, goal_rowCor);
+			}
+
+			if(goal_colCor < N - 1){
+				statePtr->wd_column_code += 1ULL << count_shift(j, goal_colCor);
+			}
+		}
+	}
+}
+
+
+/**
+ * Look up the walking distance of a state whose codes are up to date
+ */
+int walking_distance(struct state* statePtr){
+	return wd_distances[table_slot(statePtr->wd_row_code)] + wd_distances[table_slot(statePtr->wd_column_code)];
+}
+
+
+/**
+ * Update the row and column codes of a state incrementally from its predecessor's codes, since a single move only
+ * changes one count in one of the two codes
+ * NOTE: assumes that statePtr has a predecessor with up to date codes, must be checked by caller
+ */
+void update_walking_distance_codes(struct state* statePtr, const int N){
+	struct state* predecessor = statePtr->predecessor;
+
+	//Start from the predecessor's codes
+	statePtr->wd_row_code = predecessor->wd_row_code;
+	statePtr->wd_column_code = predecessor->wd_column_code;
+
+	//The tile that moved is now where the 0 slider used to be
+	short tile = *(statePtr->tiles + predecessor->zero_row * N + predecessor->zero_column);
+
+	if(statePtr->zero_row != predecessor->zero_row){
+		//Vertical move: the tile went from the new 0 row to the old 0 row
+		short goal_rowCor = (tile - 1) / N;
+		if(goal_rowCor < N - 1){
+			statePtr->wd_row_code -= 1ULL << count_shift(statePtr->zero_row, goal_rowCor);
+			statePtr->wd_row_code += 1ULL << count_shift(predecessor->zero_row, goal_rowCor);
+		}
+		statePtr->wd_row_code &= ~(COUNT_MASK << wd_blank_shift);
+		statePtr->wd_row_code |= (unsigned long long)statePtr->zero_row << wd_blank_shift;
+	} else {
+		//Horizontal move: the tile went from the new 0 column to the old 0 column
+		short goal_colCor = (tile - 1) % N;
+		if(goal_colCor < N - 1){
+			statePtr->wd_column_code -= 1ULL << count_shift(statePtr->zero_column, goal_colCor);
+			statePtr->wd_column_code += 1ULL << count_shift(predecessor->zero_column, goal_colCor);
+		}
+		statePtr->wd_column_code &= ~(COUNT_MASK << wd_blank_shift);
+		statePtr->wd_column_code |= (unsigned long long)statePtr->zero_column << wd_blank_shift;
+	}
+}
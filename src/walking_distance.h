@@ -0,0 +1,26 @@
+/**
+ * Author: Jack Robbins
+ * This header file contains the function prototypes for the walking distance heuristic, which are implemented
+ * in walking_distance.c
+ */
+
+
+#ifndef WALKING_DISTANCE_H
+#define WALKING_DISTANCE_H
+
+#include "puzzle.h"
+
+
+//Codes for 5x5 still fit in 64 bits, but the 5x5 table has over 65 million entries and takes about a minute
+//to build, so we stop at 4x4
+#define WALKING_DISTANCE_MAX_N 4
+
+
+/* Method Protoypes */
+int initialize_walking_distance(const int);
+void destroy_walking_distance(void);
+void walking_distance_codes(struct state*, const int);
+int walking_distance(struct state*);
+void update_walking_distance_codes(struct state*, const int);
+
+#endif /* WALKING_DISTANCE_H */